@@ -0,0 +1,93 @@
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+sys.path.append("../common")
+
+import os
+import shutil
+import time
+import unittest
+import numpy as np
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+_model_name = "identity_async"
+_protocols = [("localhost:8000", ProtocolType.HTTP),
+              ("localhost:8001", ProtocolType.GRPC)]
+
+class AsyncTest(unittest.TestCase):
+    def _async_infer(self, ctx, request_cnt):
+        # Send all the requests before waiting for any of them so that
+        # the backend has several executions outstanding.
+        requests = []
+        for i in range(request_cnt):
+            input_data = np.arange(start=i, stop=i + 16, dtype=np.int32)
+            requests.append((input_data, ctx.async_run(
+                { 'INPUT0' : (input_data,) },
+                { 'OUTPUT0' : InferContext.ResultFormat.RAW }, 1)))
+        return requests
+
+    def test_async_infer(self):
+        for pair in _protocols:
+            ctx = InferContext(pair[0], pair[1], _model_name, -1, True)
+            for (input_data, request_id) in self._async_infer(ctx, 32):
+                result = ctx.get_async_run_results(request_id, True)
+                self.assertTrue(np.array_equal(result['OUTPUT0'][0], input_data),
+                                "expected OUTPUT0 to equal INPUT0")
+
+    def test_unload_while_inflight(self):
+        # Remove the model while executions are outstanding. Requests
+        # that were not executed before the unload may fail, but those
+        # that complete must be correct and the server must stay live
+        # after the custom library is finalized and unloaded.
+        ctx = InferContext(_protocols[0][0], _protocols[0][1], _model_name, -1, True)
+        requests = self._async_infer(ctx, 64)
+        shutil.rmtree("unload_models/" + _model_name)
+
+        for (input_data, request_id) in requests:
+            try:
+                result = ctx.get_async_run_results(request_id, True)
+                self.assertTrue(np.array_equal(result['OUTPUT0'][0], input_data),
+                                "expected OUTPUT0 to equal INPUT0")
+            except InferenceServerException:
+                pass
+
+        time.sleep(5) # wait for model to unload
+        for pair in _protocols:
+            hctx = ServerHealthContext(pair[0], pair[1], True)
+            self.assertTrue(hctx.is_live())
+            try:
+                sctx = ServerStatusContext(pair[0], pair[1], _model_name, True)
+                ss = sctx.get_server_status()
+                for (k, v) in ss.model_status[_model_name].version_status.items():
+                    self.assertEqual(v.ready_state, server_status.MODEL_UNAVAILABLE)
+            except InferenceServerException as ex:
+                self.assertTrue(
+                    ex.message().startswith("no status available for unknown model"))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,143 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+sys.path.append("../common")
+
+import re
+import threading
+import unittest
+import numpy as np
+from tensorrtserver.api import *
+
+try:
+    from urllib.request import urlopen
+except ImportError:
+    from urllib2 import urlopen
+
+_model_name = "identity_blocks"
+_sequence_model_name = "identity_blocks_sequence"
+_protocols = [("localhost:8000", ProtocolType.HTTP),
+              ("localhost:8001", ProtocolType.GRPC)]
+
+class InputBlocksTest(unittest.TestCase):
+    def _metric_value(self, metric, model_name):
+        # Return the value of 'metric' for 'model_name', or 0 if it has
+        # not been reported yet.
+        metrics = urlopen("http://localhost:8002/metrics").read().decode("utf-8")
+        pattern = r'^' + metric + r'\{[^}]*model="' + model_name + r'"[^}]*\} (\S+)$'
+        value = 0
+        for match in re.finditer(pattern, metrics, re.MULTILINE):
+            value += float(match.group(1))
+        return value
+
+    def test_batched_infer(self):
+        # Send all the requests before waiting for any of them so that
+        # the dynamic batcher executes several requests together. Each
+        # response must hold the input of its own request.
+        request_cnt = 8
+        for pair in _protocols:
+            exec_cnt = self._metric_value("nv_inference_exec_count", _model_name)
+
+            ctx = InferContext(pair[0], pair[1], _model_name, -1, True)
+            requests = []
+            for i in range(request_cnt):
+                input_data = np.arange(start=i, stop=i + 16, dtype=np.int32)
+                requests.append((input_data, ctx.async_run(
+                    { 'INPUT0' : (input_data,) },
+                    { 'OUTPUT0' : InferContext.ResultFormat.RAW }, 1)))
+
+            for (input_data, request_id) in requests:
+                result = ctx.get_async_run_results(request_id, True)
+                self.assertTrue(np.array_equal(result['OUTPUT0'][0], input_data),
+                                "expected OUTPUT0 to equal INPUT0")
+
+            exec_cnt = self._metric_value("nv_inference_exec_count", _model_name) - exec_cnt
+            self.assertTrue(exec_cnt < request_cnt,
+                            "expected requests to be batched, got {} executions".format(
+                                exec_cnt))
+
+    def test_batched_infer_batch_size(self):
+        # A request with batch-size > 1 has several blocks, one for
+        # each batch entry.
+        for pair in _protocols:
+            ctx = InferContext(pair[0], pair[1], _model_name, -1, True)
+            input_list = [np.arange(start=b * 16, stop=(b + 1) * 16, dtype=np.int32)
+                          for b in range(4)]
+            result = ctx.run({ 'INPUT0' : input_list },
+                             { 'OUTPUT0' : InferContext.ResultFormat.RAW }, 4)
+            for b in range(4):
+                self.assertTrue(np.array_equal(result['OUTPUT0'][b], input_list[b]),
+                                "expected OUTPUT0 to equal INPUT0")
+
+    def _check_sequence(self, protocol, correlation_id, values, errors):
+        # OUTPUT0 must return the input of the request and OUTPUT1 the
+        # START control value, which is 1 only for the first request
+        # of the sequence.
+        try:
+            ctx = InferContext(protocol[0], protocol[1], _sequence_model_name,
+                               correlation_id=correlation_id, verbose=True)
+            request_ids = []
+            for i, value in enumerate(values):
+                flags = InferRequestHeader.FLAG_NONE
+                if i == 0:
+                    flags = flags | InferRequestHeader.FLAG_SEQUENCE_START
+                if i == (len(values) - 1):
+                    flags = flags | InferRequestHeader.FLAG_SEQUENCE_END
+                request_ids.append(ctx.async_run(
+                    { 'INPUT0' : (np.full((1,), value, dtype=np.int32),) },
+                    { 'OUTPUT0' : InferContext.ResultFormat.RAW,
+                      'OUTPUT1' : InferContext.ResultFormat.RAW },
+                    batch_size=1, flags=flags))
+
+            for i, request_id in enumerate(request_ids):
+                result = ctx.get_async_run_results(request_id, True)
+                self.assertEqual(result['OUTPUT0'][0][0], values[i])
+                self.assertEqual(result['OUTPUT1'][0][0], 1 if i == 0 else 0)
+        except Exception as ex:
+            errors.append(ex)
+
+    def test_sequence_control_input(self):
+        # Run concurrent sequences so that executions hold payloads of
+        # several sequences, each with its own control value.
+        for protocol in _protocols:
+            errors = []
+            threads = []
+            for s in range(4):
+                correlation_id = 1000 + s
+                values = [s * 100 + i for i in range(8)]
+                threads.append(threading.Thread(
+                    target=self._check_sequence,
+                    args=(protocol, correlation_id, values, errors)))
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            if len(errors) > 0:
+                raise errors[0]
+
+if __name__ == '__main__':
+    unittest.main()
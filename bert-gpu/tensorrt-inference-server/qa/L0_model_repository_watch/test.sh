@@ -0,0 +1,126 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+
+CLIENT_LOG="./client.log"
+WATCH_TEST=watch_test.py
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+source ../common/util.sh
+
+# Logged by the server when it can't watch the model repository and
+# so examines every model on each poll.
+FULL_POLL_MSG="Polling all models for model repository changes"
+
+RET=0
+rm -fr *.log
+
+# Run each test against a server that watches an initially empty
+# model repository on a local filesystem. The changes made by the
+# test are picked up by watching the repository.
+for TEST in test_add_modify_remove test_changes_between_polls; do
+    rm -fr models models.staging && mkdir models
+
+    SERVER_ARGS="--model-store=`pwd`/models --repository-poll-secs=1 --exit-timeout-secs=5"
+    SERVER_LOG="./inference_server_local_$TEST.log"
+    run_server
+    if [ "$SERVER_PID" == "0" ]; then
+        echo -e "\n***\n*** Failed to start $SERVER\n***"
+        cat $SERVER_LOG
+        exit 1
+    fi
+
+    set +e
+    MODEL_STORE=models python $WATCH_TEST RepositoryWatchTest.$TEST >>$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Test Failed\n***"
+        RET=1
+    fi
+    set -e
+
+    kill $SERVER_PID
+    wait $SERVER_PID
+
+    if grep -q "$FULL_POLL_MSG" $SERVER_LOG; then
+        echo -e "\n***\n*** Unexpected full polling of local repository\n***"
+        RET=1
+    fi
+done
+
+# Run each test against a server whose model repository is a FUSE
+# mount of another directory. The server must fall back to polling
+# every model, and the test makes its changes to the directory backing
+# the mount, which inotify on the mount does not report, the same as
+# changes made to a network filesystem by another host. Mounting
+# requires the container to have access to /dev/fuse (--device
+# /dev/fuse --cap-add SYS_ADMIN).
+for TEST in test_add_modify_remove test_changes_between_polls; do
+    rm -fr models models.staging && mkdir models
+    rm -fr fuse_models && mkdir fuse_models
+    set +e
+    bindfs --no-allow-other models fuse_models
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Failed to mount FUSE model repository\n***"
+        exit 1
+    fi
+    set -e
+
+    SERVER_ARGS="--model-store=`pwd`/fuse_models --repository-poll-secs=1 --exit-timeout-secs=5"
+    SERVER_LOG="./inference_server_fuse_$TEST.log"
+    run_server
+    if [ "$SERVER_PID" == "0" ]; then
+        echo -e "\n***\n*** Failed to start $SERVER\n***"
+        cat $SERVER_LOG
+        fusermount -u fuse_models
+        exit 1
+    fi
+
+    set +e
+    MODEL_STORE=models python $WATCH_TEST RepositoryWatchTest.$TEST >>$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Test Failed\n***"
+        RET=1
+    fi
+    set -e
+
+    kill $SERVER_PID
+    wait $SERVER_PID
+    fusermount -u fuse_models
+
+    if ! grep -q "$FULL_POLL_MSG" $SERVER_LOG; then
+        echo -e "\n***\n*** Expected full polling of FUSE repository\n***"
+        RET=1
+    fi
+done
+
+if [ $RET -eq 0 ]; then
+  echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
@@ -0,0 +1,149 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+sys.path.append("../common")
+
+from future.utils import iteritems
+import os
+import shutil
+import time
+import unittest
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+# The changes are made to MODEL_STORE, which is either the model
+# repository of the server or the directory backing it.
+_model_store = os.environ.get("MODEL_STORE", "models")
+_int32_name = "custom_int32_int32_int32"
+_float32_name = "custom_float32_float32_float32"
+_protocols = [("localhost:8000", ProtocolType.HTTP),
+              ("localhost:8001", ProtocolType.GRPC)]
+
+class RepositoryWatchTest(unittest.TestCase):
+    def _model_path(self, model_name):
+        return os.path.join(_model_store, model_name)
+
+    def _add_model(self, model_name):
+        shutil.copytree(os.path.join("../custom_models", model_name),
+                        self._model_path(model_name))
+
+    def _version_states(self, model_name):
+        # Return the ready state of each version of 'model_name', or
+        # None if the server has no status for the model.
+        states = None
+        for pair in _protocols:
+            ctx = ServerStatusContext(pair[0], pair[1], model_name, True)
+            try:
+                ss = ctx.get_server_status()
+            except InferenceServerException as ex:
+                self.assertTrue(
+                    ex.message().startswith("no status available for unknown model"))
+                self.assertTrue(states is None)
+                continue
+
+            self.assertEqual(server_status.SERVER_READY, ss.ready_state)
+            pair_states = {}
+            for (k, v) in iteritems(ss.model_status[model_name].version_status):
+                pair_states[k] = v.ready_state
+            self.assertTrue(states is None or states == pair_states)
+            states = pair_states
+        return states
+
+    def _wait_for_poll(self):
+        time.sleep(5) # the server polls every second
+
+    def test_add_modify_remove(self):
+        self.assertEqual(self._version_states(_int32_name), None)
+
+        # Add a model directory.
+        self._add_model(_int32_name)
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_int32_name),
+                         { 1 : server_status.MODEL_READY })
+
+        # Add a version directory within the model, which must be
+        # picked up even though it was created after the model
+        # directory was first seen.
+        shutil.copytree(os.path.join(self._model_path(_int32_name), "1"),
+                        os.path.join(self._model_path(_int32_name), "2"))
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_int32_name),
+                         { 1 : server_status.MODEL_UNAVAILABLE,
+                           2 : server_status.MODEL_READY })
+
+        # Modify the configuration of the model in place so that all
+        # versions are served.
+        with open(os.path.join(self._model_path(_int32_name), "config.pbtxt"), "a") as f:
+            f.write("\nversion_policy: { all { }}\n")
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_int32_name),
+                         { 1 : server_status.MODEL_READY,
+                           2 : server_status.MODEL_READY })
+
+        # Remove the model directory.
+        shutil.rmtree(self._model_path(_int32_name))
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_int32_name),
+                         { 1 : server_status.MODEL_UNAVAILABLE,
+                           2 : server_status.MODEL_UNAVAILABLE })
+
+    def test_changes_between_polls(self):
+        # Several changes made between two polls are all picked up,
+        # including a model that is added and removed again before
+        # the server sees it.
+        self._add_model(_float32_name)
+        self._add_model(_int32_name)
+        shutil.rmtree(self._model_path(_int32_name))
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_float32_name),
+                         { 1 : server_status.MODEL_READY })
+        int32_states = self._version_states(_int32_name)
+        self.assertTrue(int32_states is None or
+                        int32_states == { 1 : server_status.MODEL_UNAVAILABLE })
+
+        # Move a model out of the repository and move another one in.
+        # The model moved in is staged next to the repository so that
+        # the move is a rename.
+        staging = os.path.abspath(_model_store) + ".staging"
+        shutil.rmtree(staging, ignore_errors=True)
+        os.mkdir(staging)
+        shutil.copytree(os.path.join("../custom_models", _int32_name),
+                        os.path.join(staging, _int32_name))
+        os.rename(self._model_path(_float32_name),
+                  os.path.join(staging, _float32_name))
+        os.rename(os.path.join(staging, _int32_name),
+                  self._model_path(_int32_name))
+        self._wait_for_poll()
+        self.assertEqual(self._version_states(_float32_name),
+                         { 1 : server_status.MODEL_UNAVAILABLE })
+        self.assertEqual(self._version_states(_int32_name),
+                         { 1 : server_status.MODEL_READY })
+
+        shutil.rmtree(staging)
+
+if __name__ == '__main__':
+    unittest.main()
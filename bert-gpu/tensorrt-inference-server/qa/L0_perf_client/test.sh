@@ -26,6 +26,7 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 CLIENT_LOG="./perf_client.log"
+CSV_FILE="./perf_client.csv"
 PERF_CLIENT=../clients/perf_client
 
 DATADIR=/data/inferenceserver/qa_model_repository
@@ -35,7 +36,7 @@ SERVER_ARGS=--model-store=$DATADIR
 SERVER_LOG="./inference_server.log"
 source ../common/util.sh
 
-rm -f $SERVER_LOG $CLIENT_LOG
+rm -f $SERVER_LOG $CLIENT_LOG $CSV_FILE
 
 RET=0
 
@@ -86,6 +87,43 @@ for MODEL in graphdef_nobatch_int32_int32_int32 graphdef_int32_int32_int32; do
     done
 done
 
+# Request rate mode, with each distribution and protocol. The CSV
+# report must have the client send delay column.
+echo 1000 > request_intervals.txt
+echo 3000 >> request_intervals.txt
+for PROTOCOL in grpc http; do
+    if [ "$PROTOCOL" == "grpc" ]; then
+        URL=localhost:8001
+    else
+        URL=localhost:8000
+    fi
+    for DISTRIBUTION in "--request-distribution=constant" \
+                        "--request-distribution=poisson" \
+                        "--request-intervals=request_intervals.txt"; do
+        rm -f $CSV_FILE
+        set +e
+        $PERF_CLIENT -v -i $PROTOCOL -u $URL -m graphdef_int32_int32_int32 \
+            -p2000 -b 1 --max-threads=4 --request-rate-range=100:200:100 \
+            $DISTRIBUTION -f $CSV_FILE >$CLIENT_LOG 2>&1
+        if [ $? -ne 0 ]; then
+            cat $CLIENT_LOG
+            echo -e "\n***\n*** Test Failed\n***"
+            RET=1
+        fi
+        if [ $(cat $CLIENT_LOG | grep ": 0 infer/sec\|: 0 usec" | wc -l) -ne 0 ]; then
+            cat $CLIENT_LOG
+            echo -e "\n***\n*** Test Failed\n***"
+            RET=1
+        fi
+        if [ $(head -n 1 $CSV_FILE | grep "^Request Rate,Inferences/Second,Client Send Delay," | wc -l) -ne 1 ]; then
+            cat $CSV_FILE
+            echo -e "\n***\n*** Test Failed\n***"
+            RET=1
+        fi
+        set -e
+    done
+done
+
 kill $SERVER_PID
 wait $SERVER_PID
 
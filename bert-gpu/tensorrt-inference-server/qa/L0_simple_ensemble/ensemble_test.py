@@ -31,16 +31,97 @@ sys.path.append("../clients")
 import logging
 
 import os
+import re
 import unittest
 import numpy as np
 import infer_util as iu
+from tensorrtserver.api import *
+
+try:
+    from urllib.request import urlopen
+except ImportError:
+    from urllib2 import urlopen
+
+_ensemble_name = "ensemble_add_sub_int32_int32_int32"
+_batched_ensemble_name = "batched_ensemble_add_sub_int32_int32_int32"
 
 class EnsembleTest(unittest.TestCase):
+    def _metric_value(self, metric, model_name=_ensemble_name):
+        # Return the value of 'metric' for 'model_name', or 0 if it has
+        # not been reported yet.
+        metrics = urlopen("http://localhost:8002/metrics").read().decode("utf-8")
+        pattern = r'^' + metric + r'\{[^}]*model="' + model_name + r'"[^}]*\} (\S+)$'
+        value = 0
+        for match in re.finditer(pattern, metrics, re.MULTILINE):
+            value += float(match.group(1))
+        return value
+
     def test_ensemble_add_sub(self):
         for bs in (1, 8):
             iu.infer_exact(self, "ensemble_add_sub", (16,), bs,
                                 np.int32, np.int32, np.int32)
 
+    def test_ensemble_early_release_in_place(self):
+        count = self._metric_value("nv_inference_count")
+        copy_bytes = self._metric_value("nv_inference_output_copy_bytes")
+        peak_bytes = self._metric_value("nv_inference_ensemble_tensor_peak_bytes")
+
+        for bs in (1, 8):
+            iu.infer_exact(self, "ensemble_add_sub", (16,), bs,
+                                np.int32, np.int32, np.int32)
+
+        count = self._metric_value("nv_inference_count") - count
+        copy_bytes = self._metric_value("nv_inference_output_copy_bytes") - copy_bytes
+        peak_bytes = self._metric_value("nv_inference_ensemble_tensor_peak_bytes") - peak_bytes
+        self.assertTrue(count > 0)
+
+        # The last step writes OUTPUT0 and OUTPUT1 directly into the
+        # ensemble response, so no output is copied.
+        self.assertEqual(copy_bytes, 0)
+
+        # Each of the four intermediate tensors is 64 bytes per batch
+        # entry. An intermediate is released as soon as the step that
+        # uses it completes, so at most two are held at any time.
+        self.assertTrue(peak_bytes > 0)
+        self.assertTrue(peak_bytes <= 2 * 64 * count,
+                        "peak intermediate bytes {} exceed {}".format(
+                            peak_bytes, 2 * 64 * count))
+
+    def test_ensemble_step_batching(self):
+        # Send concurrent requests with distinct inputs to the ensemble
+        # that holds ready steps for 100ms. The steps of different
+        # requests are executed together, and each response must still
+        # hold the outputs of its own request.
+        request_cnt = 8
+        exec_cnt = self._metric_value("nv_inference_exec_count", "simple")
+
+        ctx = InferContext("localhost:8000", ProtocolType.HTTP,
+                           _batched_ensemble_name)
+        requests = []
+        for i in range(request_cnt):
+            in0 = np.arange(start=i, stop=i + 16, dtype=np.int32)
+            in1 = np.full(16, 3 * i + 1, dtype=np.int32)
+            request_id = ctx.async_run(
+                { "INPUT0" : (in0,), "INPUT1" : (in1,) },
+                { "OUTPUT0" : InferContext.ResultFormat.RAW,
+                  "OUTPUT1" : InferContext.ResultFormat.RAW },
+                1)
+            requests.append((request_id, in0, in1))
+
+        for request_id, in0, in1 in requests:
+            results = ctx.get_async_run_results(request_id, True)
+            self.assertTrue(np.array_equal(results["OUTPUT0"][0], in0 + in1),
+                            "request {} has wrong OUTPUT0".format(request_id))
+            self.assertTrue(np.array_equal(results["OUTPUT1"][0], in0 - in1),
+                            "request {} has wrong OUTPUT1".format(request_id))
+
+        # Each request runs 5 steps, at least some of them must have
+        # been combined into a single execution of "simple".
+        exec_cnt = self._metric_value("nv_inference_exec_count", "simple") - exec_cnt
+        self.assertTrue(exec_cnt > 0)
+        self.assertTrue(exec_cnt < 5 * request_cnt,
+                        "expected combined steps, got {} executions".format(exec_cnt))
+
 if __name__ == '__main__':
     logging.basicConfig( stream=sys.stderr )
     unittest.main()
@@ -62,10 +62,13 @@ NetDefBackendFactory::CreateBackend(
   std::unordered_map<std::string, std::vector<char>> models;
   for (const auto& filename : netdef_files) {
     const auto netdef_path = JoinPath({path, filename});
-    std::string model_data_str;
 
-    RETURN_IF_ERROR(ReadTextFile(netdef_path, &model_data_str));
-    std::vector<char> model_data(model_data_str.begin(), model_data_str.end());
+    // Map the file so that it is copied only once, into the blob
+    // passed to Caffe2.
+    std::shared_ptr<FileBlob> model_file;
+    RETURN_IF_ERROR(MapFile(netdef_path, &model_file));
+    std::vector<char> model_data(
+        model_file->Data(), model_file->Data() + model_file->Size());
     models.emplace(filename, std::move(model_data));
   }
 
@@ -54,6 +54,48 @@ typedef enum custom_serverparamkind_enum {
   MODEL_REPOSITORY_PATH = 1
 } CustomServerParameter;
 
+/// A contiguous block of the content of an input tensor.
+typedef struct custom_inputblock_struct {
+  /// The block content.
+  const void* content;
+
+  /// The size of 'content', in bytes.
+  uint64_t content_byte_size;
+} CustomInputBlock;
+
+/// Type for the CustomGetInputBlocks callback function.
+///
+/// This callback function is provided in the CustomInitializeData and
+/// can be used instead of CustomGetNextInput to get the value of an
+/// input tensor for all the payloads of an execution with a single
+/// call. The input is identified by its index in the model
+/// configuration instead of by name. The first call for an input
+/// resolves all of its blocks, later calls return the same blocks. An
+/// input must not be read with both this function and
+/// CustomGetNextInput within the same execution.
+///
+/// \param input_context The input context of any of the payloads
+/// provided in call to CustomExecute or CustomExecuteAsync.
+/// \param input_index The index of the input tensor in the model
+/// configuration. For a model that uses the sequence batcher the
+/// control inputs follow the model inputs: index 'input_size + i'
+/// addresses the i'th 'sequence_batching.control_input' of the model
+/// configuration. The content of a control input is the value the
+/// sequence batcher provides for each payload.
+/// \param block_cnt Returns the number of blocks in 'blocks'.
+/// \param blocks Returns the blocks holding the input content for
+/// all the payloads, in payload order.
+/// \param payload_block_starts Returns, for each payload, the index
+/// in 'blocks' of the first block of that payload's content,
+/// followed by 'block_cnt'. The blocks of payload 'p' are therefore
+/// 'blocks[payload_block_starts[p]]' up to, but not including,
+/// 'blocks[payload_block_starts[p + 1]]'.
+/// \return false if error, true if success. The returned arrays and
+/// blocks remain valid until the execution completes.
+typedef bool (*CustomGetInputBlocksFn_t)(
+    void* input_context, uint32_t input_index, uint32_t* block_cnt,
+    const CustomInputBlock** blocks, const uint32_t** payload_block_starts);
+
 // The initialization information provided to a custom backend when it
 // is created.
 typedef struct custom_initdata_struct {
@@ -82,6 +124,10 @@ typedef struct custom_initdata_struct {
   /// and must be copied if a persistent copy of required by the
   /// custom backend.
   const char** server_parameters;
+
+  /// The callback function to get all the blocks of an input tensor
+  /// for an execution (see CustomGetInputBlocksFn_t).
+  CustomGetInputBlocksFn_t input_blocks_fn;
 } CustomInitializeData;
 
 /// A payload represents the input tensors and the required output
@@ -170,11 +216,31 @@ typedef bool (*CustomGetNextInputFn_t)(
 /// (no error), then the output should not be written and the backend
 /// should continue to the next output. If non-nullptr, the size of
 /// the buffer will be large enough to hold 'content_byte_size' bytes.
+/// The buffer is not initialized, the backend must write all
+/// 'content_byte_size' bytes.
 /// \return false if error, true if success.
 typedef bool (*CustomGetOutputFn_t)(
     void* output_context, const char* name, size_t shape_dim_cnt,
     int64_t* shape_dims, uint64_t content_byte_size, void** content);
 
+/// Type for the CustomExecuteComplete callback function.
+///
+/// This callback function is provided in the call to
+/// CustomExecuteAsync and must be called exactly once when the
+/// execution completes. After this callback is called the payloads
+/// and the input and output contexts provided in the call to
+/// CustomExecuteAsync must no longer be accessed. The callback only
+/// queues the completion and returns, it does not call into the
+/// custom backend.
+///
+/// \param complete_context The completion context provided in the
+/// call to CustomExecuteAsync.
+/// \param error_code The error code for the execution. Zero indicates
+/// success, all other values indicate failure. Errors isolated to a
+/// single payload should be reported in that payload's 'error_code'.
+typedef void (*CustomExecuteCompleteFn_t)(
+    void* complete_context, int error_code);
+
 /// Type for the CustomInitialize function.
 typedef int (*CustomInitializeFn_t)(const CustomInitializeData*, void**);
 
@@ -189,6 +255,11 @@ typedef int (*CustomExecuteFn_t)(
     void*, uint32_t, CustomPayload*, CustomGetNextInputFn_t,
     CustomGetOutputFn_t);
 
+/// Type for the CustomExecuteAsync function.
+typedef int (*CustomExecuteAsyncFn_t)(
+    void*, uint32_t, CustomPayload*, CustomGetNextInputFn_t,
+    CustomGetOutputFn_t, CustomExecuteCompleteFn_t, void*);
+
 /// Initialize the custom backend for a given model configuration and
 /// get the associated custom context.
 ///
@@ -237,6 +308,37 @@ int CustomExecute(
     void* custom_context, uint32_t payload_cnt, CustomPayload* payloads,
     CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn);
 
+/// Start asynchronous execution of the custom model. This function is
+/// optional. If a custom backend provides it, it is used instead of
+/// CustomExecute and the thread that called it is free to schedule
+/// the next payloads while the execution proceeds on threads owned by
+/// the custom backend. Executions for a context are started in the
+/// order the payloads are scheduled but may complete in any
+/// order. The custom backend can limit the number of outstanding
+/// executions by blocking in this function. CustomFinalize is not
+/// called while an execution is outstanding.
+///
+/// \param custom_context The custom state associated with the context
+/// that should execute. Can be nullptr if no custom state.
+/// \param payload_cnt The number of payloads to execute.
+/// \param payloads The payloads to execute. The payloads remain valid
+/// until 'complete_fn' is called.
+/// \param input_fn The callback function to get tensor input (see
+/// CustomGetNextInputFn_t).
+/// \param output_fn The callback function to get buffer for tensor
+/// output (see CustomGetOutputFn_t).
+/// \param complete_fn The callback function that must be called when
+/// the execution completes (see CustomExecuteCompleteFn_t). Must not
+/// be called if this function returns an error.
+/// \param complete_context The context to pass to 'complete_fn'.
+/// \return An error code. Zero indicates that the execution was
+/// started, all other values indicate failure. Use CustomErrorString
+/// to get the error string for an error code.
+int CustomExecuteAsync(
+    void* custom_context, uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn,
+    CustomExecuteCompleteFn_t complete_fn, void* complete_context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,9 @@
 #include "src/backends/custom/custom_backend.h"
 
 #include <stdint.h>
+#include <algorithm>
+#include <deque>
+#include <thread>
 #include "cuda/include/cuda_runtime_api.h"
 #include "src/backends/custom/loader.h"
 #include "src/core/constants.h"
@@ -38,18 +41,101 @@
 
 namespace nvidia { namespace inferenceserver {
 
+// Runs the completions of the executions that a context started with
+// CustomExecuteAsync. Completing an execution can release the last
+// reference to the backend, which finalizes and unloads the custom
+// library. That must not happen on a thread owned by the library while
+// it is still inside CustomExecuteComplete, so CustomExecuteComplete
+// only queues the completion here and returns.
+class CustomBackend::Context::CompletionThread {
+ public:
+  CompletionThread() : state_(std::make_shared<State>())
+  {
+    std::shared_ptr<State> state = state_;
+    thread_ = std::thread([state]() { Run(state); });
+  }
+
+  // Complete the queued executions and stop the thread. The last
+  // completion may destroy the context and so this object on the
+  // thread itself, which then exits once that completion returns.
+  ~CompletionThread()
+  {
+    {
+      std::lock_guard<std::mutex> lock(state_->mu_);
+      state_->exit_ = true;
+    }
+    state_->cv_.notify_one();
+
+    if (thread_.get_id() == std::this_thread::get_id()) {
+      thread_.detach();
+    } else {
+      thread_.join();
+    }
+  }
+
+  void Enqueue(std::function<void()>&& completion)
+  {
+    {
+      std::lock_guard<std::mutex> lock(state_->mu_);
+      state_->queue_.emplace_back(std::move(completion));
+    }
+    state_->cv_.notify_one();
+  }
+
+ private:
+  struct State {
+    State() : exit_(false) {}
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool exit_;
+  };
+
+  static void Run(const std::shared_ptr<State>& state)
+  {
+    while (true) {
+      std::function<void()> completion;
+      {
+        std::unique_lock<std::mutex> lock(state->mu_);
+        state->cv_.wait(
+            lock, [&state] { return state->exit_ || !state->queue_.empty(); });
+        if (state->queue_.empty()) {
+          return;
+        }
+        completion = std::move(state->queue_.front());
+        state->queue_.pop_front();
+      }
+
+      completion();
+    }
+  }
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
 CustomBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
       library_handle_(nullptr), library_context_handle_(nullptr),
       InitializeFn_(nullptr), FinalizeFn_(nullptr), ErrorStringFn_(nullptr),
-      ExecuteFn_(nullptr)
+      ExecuteFn_(nullptr), ExecuteAsyncFn_(nullptr), inflight_cnt_(0)
 {
 }
 
 CustomBackend::Context::~Context()
 {
   LOG_VERBOSE(1) << "~CustomBackend::Context " << name_;
+
+  // Wait for any asynchronous executions to complete before
+  // finalizing the library.
+  {
+    std::unique_lock<std::mutex> lock(inflight_mu_);
+    inflight_cv_.wait(lock, [this] { return inflight_cnt_ == 0; });
+  }
+  completion_thread_.reset();
+
   if (FinalizeFn_ != nullptr) {
     int err = FinalizeFn_(library_context_handle_);
     if (err != 0) {
@@ -173,13 +259,27 @@ CustomBackend::CreateExecutionContext(
   contexts_.emplace_back(new Context(instance_name, gpu_device, mbs));
   const std::unique_ptr<Context>& context = contexts_.back();
 
+  for (const auto& input : Config().input()) {
+    context->input_names_.push_back(input.name());
+  }
+  for (const auto& control_input :
+       Config().sequence_batching().control_input()) {
+    context->input_names_.push_back(control_input.name());
+  }
+
   // 'mn_itr->second' is the path to the shared library file to use
   // for that context (e.g. model_name/1/libcustom.so). Load that
   // library as it provides the custom backend implementation.
   RETURN_IF_ERROR(LoadCustom(
       mn_itr->second, &(context->library_handle_), &(context->InitializeFn_),
       &(context->FinalizeFn_), &(context->ErrorStringFn_),
-      &(context->ExecuteFn_)));
+      &(context->ExecuteFn_), &(context->ExecuteAsyncFn_)));
+
+  // Each instance that executes asynchronously completes its
+  // executions on its own thread.
+  if (context->ExecuteAsyncFn_ != nullptr) {
+    context->completion_thread_.reset(new Context::CompletionThread());
+  }
 
   return Status::Success;
 }
@@ -220,6 +320,8 @@ CustomBackend::InitBackend(uint32_t runner_idx)
     init_data.server_parameters = nullptr;
   }
 
+  init_data.input_blocks_fn = CustomGetInputBlocks;
+
   int err =
       context->InitializeFn_(&init_data, &(context->library_context_handle_));
   if (err != 0) {
@@ -246,7 +348,14 @@ CustomBackend::RunBackend(
     return;
   }
 
-  std::vector<ModelInferStats::ScopedTimer> compute_timers;
+  std::unique_ptr<Context::Execution> execution(new Context::Execution(
+      contexts_[runner_idx].get(), payloads, OnCompleteQueuedPayloads));
+
+  // The timers are pointed to by the payload stats so don't let the
+  // vector reallocate.
+  std::vector<ModelInferStats::ScopedTimer>& compute_timers =
+      execution->compute_timers_;
+  compute_timers.reserve(payloads->size());
   for (auto& payload : *payloads) {
     // Stop queue timer when the payload is scheduled to run
     if (payload.queue_timer_ != nullptr) {
@@ -260,15 +369,62 @@ CustomBackend::RunBackend(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx]->Run(this, payloads));
+  contexts_[runner_idx]->Run(this, std::move(execution));
 }
 
-Status
+void
 CustomBackend::Context::Run(
-    CustomBackend* base, std::vector<Scheduler::Payload>* payloads)
+    CustomBackend* base, std::unique_ptr<Execution>&& execution)
 {
-  LOG_VERBOSE(1) << "Running " << name_ << " with " << payloads->size()
-                 << " request payloads";
+  LOG_VERBOSE(1) << "Running " << name_ << " with "
+                 << execution->payloads_->size() << " request payloads";
+
+  Status status = PrepareExecution(execution.get());
+  if (!status.IsOk()) {
+    execution->OnComplete_(status);
+    return;
+  }
+
+  // If there are no valid payloads then no need to run the
+  // inference. The payloads will have their error status set so can
+  // just complete.
+  std::vector<CustomPayload>& custom_payloads = execution->custom_payloads_;
+  if (custom_payloads.empty()) {
+    execution->OnComplete_(Status::Success);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(inflight_mu_);
+    inflight_cnt_++;
+  }
+
+  // Execute the custom backend which will use CustomGetOutput to get
+  // the output buffers into which it will write the results for the
+  // requested outputs. An asynchronous execution owns 'execution'
+  // until it calls CustomExecuteComplete. The completion callback is
+  // not called if the execution fails to start.
+  if (ExecuteAsyncFn_ != nullptr) {
+    Execution* async_execution = execution.release();
+    int err = ExecuteAsyncFn_(
+        library_context_handle_, custom_payloads.size(), &custom_payloads[0],
+        CustomGetNextInput, CustomGetOutput, CustomExecuteComplete,
+        async_execution);
+    if (err != 0) {
+      CompleteExecution(std::unique_ptr<Execution>(async_execution), err);
+    }
+  } else {
+    int err = ExecuteFn_(
+        library_context_handle_, custom_payloads.size(), &custom_payloads[0],
+        CustomGetNextInput, CustomGetOutput);
+    CompleteExecution(std::move(execution), err);
+  }
+}
+
+Status
+CustomBackend::Context::PrepareExecution(Execution* execution)
+{
+  std::vector<Scheduler::Payload>* payloads = execution->payloads_;
 
   // Each payload will have the same number and shape for inputs. Get
   // the shape for each input into a vector suitable to passing via
@@ -276,8 +432,7 @@ CustomBackend::Context::Run(
   // models that don't have any variable-size input tensors we could
   // calculate the input tensor shapes once during backend
   // initialization.
-  std::unordered_map<std::string, std::unique_ptr<std::vector<int64_t>>>
-      input_shapes;
+  auto& input_shapes = execution->input_shapes_;
 
   if (!payloads->empty()) {
     const InferRequestHeader& request_header =
@@ -316,8 +471,8 @@ CustomBackend::Context::Run(
   }
 
   // If there are no valid payloads then no need to run the
-  // inference. The payloads will have their error status set so can
-  // just return.
+  // inference. Leave 'custom_payloads_' empty so that the library is
+  // not called.
   if (total_batch_size == 0) {
     return Status::Success;
   }
@@ -336,29 +491,30 @@ CustomBackend::Context::Run(
   // names of the payloads. We don't want this to resize as that will
   // invalidate the pointers so set the capacity big enough to hold
   // all the pointers for all the payloads.
-  std::vector<const char*> work_input_name_ptrs;
+  auto& work_input_name_ptrs = execution->input_name_ptrs_;
   work_input_name_ptrs.reserve(total_inputs);
-  std::vector<const char*> work_output_name_ptrs;
+  auto& work_output_name_ptrs = execution->output_name_ptrs_;
   work_output_name_ptrs.reserve(total_requested_outputs);
 
   // Similarly for input dim sizes and the dimension values.
-  std::vector<size_t> work_input_dim_cnts;
+  auto& work_input_dim_cnts = execution->input_dim_cnts_;
   work_input_dim_cnts.reserve(total_inputs);
-  std::vector<const int64_t*> work_input_dims_ptrs;
+  auto& work_input_dims_ptrs = execution->input_dims_ptrs_;
   work_input_dims_ptrs.reserve(total_inputs);
 
   // We use the following to hold contexts needed for the input and
   // output callbacks. We don't want this to resize as that will
   // invalidate the pointers so set the capacity big enough to hold
   // the contexts for all the payloads.
-  std::vector<GetInputOutputContext> work_io_contexts;
+  auto& work_io_contexts = execution->io_contexts_;
   work_io_contexts.reserve(payloads->size());
 
   // Collect the payload information into a array of custom::Payload
   // structs that can be passed to the backend. Every payload must
   // have an OK status (checked above) so we don't bother to check
   // that here.
-  std::vector<CustomPayload> custom_payloads;
+  auto& custom_payloads = execution->custom_payloads_;
+  custom_payloads.reserve(payloads->size());
   for (auto& payload : *payloads) {
     const InferRequestHeader& request_header =
         payload.request_provider_->RequestHeader();
@@ -404,37 +560,51 @@ CustomBackend::Context::Run(
       }
     }
 
-    work_io_contexts.emplace_back(this, &payload);
+    work_io_contexts.emplace_back(this, execution, &payload);
     custom_payload.input_context = &work_io_contexts.back();
     custom_payload.output_context = custom_payload.input_context;
     custom_payload.error_code = 0;
   }
 
-  // Execute the custom backend which will use CustomGetOutput to get
-  // the output buffers into which it will write the results for the
-  // requested outputs.
-  int err = ExecuteFn_(
-      library_context_handle_, custom_payloads.size(), &custom_payloads[0],
-      CustomGetNextInput, CustomGetOutput);
+  return Status::Success;
+}
+
+void
+CustomBackend::Context::CompleteExecution(
+    std::unique_ptr<Execution>&& execution, int err)
+{
+  Status status;
   if (err != 0) {
-    return Status(
+    status = Status(
         RequestStatusCode::INTERNAL, "execute error for '" + name_ + "': (" +
                                          std::to_string(err) + ") " +
                                          LibraryErrorString(err));
+  } else {
+    // Transfer payload errors back to the Payload objects.
+    const std::vector<CustomPayload>& custom_payloads =
+        execution->custom_payloads_;
+    std::vector<Scheduler::Payload>* payloads = execution->payloads_;
+    for (size_t i = 0; i < custom_payloads.size(); ++i) {
+      if (custom_payloads[i].error_code != 0) {
+        (*payloads)[i].status_ = Status(
+            RequestStatusCode::INTERNAL,
+            "payload error for '" + name_ + "': (" +
+                std::to_string(custom_payloads[i].error_code) + ") " +
+                LibraryErrorString(custom_payloads[i].error_code));
+      }
+    }
   }
 
-  // Transfer payload errors back to the Payload objects.
-  for (size_t i = 0; i < custom_payloads.size(); ++i) {
-    if (custom_payloads[i].error_code != 0) {
-      (*payloads)[i].status_ = Status(
-          RequestStatusCode::INTERNAL,
-          "payload error for '" + name_ + "': (" +
-              std::to_string(custom_payloads[i].error_code) + ") " +
-              LibraryErrorString(custom_payloads[i].error_code));
-    }
+  // Completing the payloads can release the last reference to the
+  // backend and so destroy this context, so the execution must no
+  // longer be counted as outstanding when that happens.
+  {
+    std::lock_guard<std::mutex> lock(inflight_mu_);
+    inflight_cnt_--;
+    inflight_cv_.notify_all();
   }
 
-  return Status::Success;
+  execution->OnComplete_(status);
 }
 
 bool
@@ -450,6 +620,106 @@ CustomBackend::Context::GetNextInput(
   return status.IsOk();
 }
 
+bool
+CustomBackend::Context::GetInputBlocks(
+    GetInputOutputContext* input_context, uint32_t input_index,
+    uint32_t* block_cnt, const CustomInputBlock** blocks,
+    const uint32_t** payload_block_starts)
+{
+  if (input_index >= input_names_.size()) {
+    return false;
+  }
+
+  Execution* execution = input_context->execution_;
+  std::lock_guard<std::mutex> lock(execution->input_blocks_mu_);
+
+  if (execution->input_blocks_.empty()) {
+    execution->input_blocks_.resize(input_names_.size());
+  }
+
+  std::unique_ptr<InputBlocks>& input_blocks =
+      execution->input_blocks_[input_index];
+  if (input_blocks == nullptr) {
+    input_blocks.reset(new InputBlocks);
+    Status status = GatherInputBlocks(
+        execution, input_names_[input_index], input_blocks.get());
+    input_blocks->ok_ = status.IsOk();
+    if (!status.IsOk()) {
+      LOG_ERROR << "failed to gather input for '" << name_
+                << "': " << status.AsString();
+    }
+  }
+
+  if (!input_blocks->ok_) {
+    return false;
+  }
+
+  *block_cnt = input_blocks->blocks_.size();
+  *blocks = input_blocks->blocks_.empty() ? nullptr
+                                          : &(input_blocks->blocks_[0]);
+  *payload_block_starts = &(input_blocks->payload_block_starts_[0]);
+  return true;
+}
+
+Status
+CustomBackend::Context::GatherInputBlocks(
+    Execution* execution, const std::string& name, InputBlocks* input_blocks)
+{
+  for (auto& payload : *execution->payloads_) {
+    input_blocks->payload_block_starts_.push_back(
+        input_blocks->blocks_.size());
+
+    // The content of a control input, or of any other input whose
+    // content is overridden, is a single block that takes the place
+    // of the content in the request.
+    uint64_t remaining_byte_size = 0;
+    bool overridden = false;
+    const std::shared_ptr<InferRequestProvider::InputOverrideMap>& overrides =
+        payload.request_provider_->GetInputOverride();
+    if (overrides != nullptr) {
+      const auto oit = overrides->find(name);
+      if (oit != overrides->end()) {
+        remaining_byte_size = oit->second->content_.size();
+        overridden = true;
+      }
+    }
+
+    if (!overridden) {
+      const InferRequestHeader& request_header =
+          payload.request_provider_->RequestHeader();
+      for (const auto& input : request_header.input()) {
+        if (input.name() == name) {
+          remaining_byte_size = input.batch_byte_size();
+          break;
+        }
+      }
+    }
+
+    // Request the entire remaining input for each block so that
+    // contiguous input is returned as a single block.
+    while (remaining_byte_size > 0) {
+      const void* content;
+      size_t content_byte_size = remaining_byte_size;
+      RETURN_IF_ERROR(payload.request_provider_->GetNextInputContent(
+          name, &content, &content_byte_size, false));
+      if (content == nullptr) {
+        return Status(
+            RequestStatusCode::INTERNAL,
+            "unexpected end of content for input '" + name + "', expecting " +
+                std::to_string(remaining_byte_size) + " more bytes");
+      }
+
+      input_blocks->blocks_.push_back(
+          CustomInputBlock{content, content_byte_size});
+      remaining_byte_size -= std::min(
+          remaining_byte_size, static_cast<uint64_t>(content_byte_size));
+    }
+  }
+
+  input_blocks->payload_block_starts_.push_back(input_blocks->blocks_.size());
+  return Status::Success;
+}
+
 bool
 CustomBackend::Context::GetOutput(
     GetInputOutputContext* output_context, const char* cname,
@@ -530,4 +800,28 @@ CustomGetOutput(
       ocontext, name, shape_dim_cnt, shape_dims, content_byte_size, content);
 }
 
+bool
+CustomGetInputBlocks(
+    void* input_context, uint32_t input_index, uint32_t* block_cnt,
+    const CustomInputBlock** blocks, const uint32_t** payload_block_starts)
+{
+  CustomBackend::Context::GetInputOutputContext* icontext =
+      static_cast<CustomBackend::Context::GetInputOutputContext*>(
+          input_context);
+  return icontext->context_->GetInputBlocks(
+      icontext, input_index, block_cnt, blocks, payload_block_starts);
+}
+
+void
+CustomExecuteComplete(void* complete_context, int error_code)
+{
+  CustomBackend::Context::Execution* execution =
+      static_cast<CustomBackend::Context::Execution*>(complete_context);
+  execution->context_->completion_thread_->Enqueue([execution, error_code] {
+    execution->context_->CompleteExecution(
+        std::unique_ptr<CustomBackend::Context::Execution>(execution),
+        error_code);
+  });
+}
+
 }}  // namespace nvidia::inferenceserver
@@ -25,6 +25,8 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include "src/backends/custom/custom.h"
 #include "src/core/backend.h"
 #include "src/core/model_config.pb.h"
@@ -66,6 +68,9 @@ class CustomBackend : public InferenceBackend {
   friend bool CustomGetNextInput(void*, const char*, const void**, uint64_t*);
   friend bool CustomGetOutput(
       void*, const char*, size_t, int64_t*, uint64_t, void**);
+  friend bool CustomGetInputBlocks(
+      void*, uint32_t, uint32_t*, const CustomInputBlock**, const uint32_t**);
+  friend void CustomExecuteComplete(void*, int);
 
   // For each model instance there is a context.
   struct Context {
@@ -89,30 +94,105 @@ class CustomBackend : public InferenceBackend {
     // Return the shared library reported error string for 'err'.
     std::string LibraryErrorString(const int err);
 
-    // Run model to execute for one or more requests. This function
-    // assumes that it is only called by the single runner thread that
-    // is assigned to this context. A non-OK return status indicates
-    // an internal error that prevents any of the of requests from
-    // completing. If an error is isolate to a single request payload
-    // it will be reported in that payload.
-    Status Run(CustomBackend* base, std::vector<Scheduler::Payload>* payloads);
+    struct Execution;
 
     struct GetInputOutputContext {
       GetInputOutputContext(
-          CustomBackend::Context* context, Scheduler::Payload* payload)
-          : context_(context), payload_(payload)
+          CustomBackend::Context* context, Execution* execution,
+          Scheduler::Payload* payload)
+          : context_(context), execution_(execution), payload_(payload)
       {
       }
       CustomBackend::Context* context_;
+      Execution* execution_;
       Scheduler::Payload* payload_;
     };
 
+    // The content of one input gathered across all the payloads of an
+    // execution, see CustomGetInputBlocksFn_t.
+    struct InputBlocks {
+      bool ok_;
+      std::vector<CustomInputBlock> blocks_;
+      std::vector<uint32_t> payload_block_starts_;
+    };
+
+    // The state for one execution of the custom library. The library
+    // holds pointers into this state until the execution completes,
+    // which for CustomExecuteAsync is after Run returns.
+    struct Execution {
+      Execution(
+          CustomBackend::Context* context,
+          std::vector<Scheduler::Payload>* payloads,
+          std::function<void(Status)> OnComplete)
+          : context_(context), payloads_(payloads), OnComplete_(OnComplete)
+      {
+      }
+
+      CustomBackend::Context* context_;
+      std::vector<Scheduler::Payload>* payloads_;
+
+      // Keeps 'payloads_' alive. Declared before 'compute_timers_' so
+      // the timers are recorded before the payload stats are released.
+      std::function<void(Status)> OnComplete_;
+      std::vector<ModelInferStats::ScopedTimer> compute_timers_;
+
+      // Shapes, names and callback contexts referenced by
+      // 'custom_payloads_'.
+      std::unordered_map<std::string, std::unique_ptr<std::vector<int64_t>>>
+          input_shapes_;
+      std::vector<const char*> input_name_ptrs_;
+      std::vector<const char*> output_name_ptrs_;
+      std::vector<size_t> input_dim_cnts_;
+      std::vector<const int64_t*> input_dims_ptrs_;
+      std::vector<GetInputOutputContext> io_contexts_;
+      std::vector<CustomPayload> custom_payloads_;
+
+      // The inputs gathered by CustomGetInputBlocks, indexed by the
+      // input index in the model configuration. An input is gathered
+      // on first use.
+      std::mutex input_blocks_mu_;
+      std::vector<std::unique_ptr<InputBlocks>> input_blocks_;
+    };
+
+    // Run model to execute for one or more requests and call the
+    // execution's OnComplete_ when done. This function assumes that
+    // it is only called by the single runner thread that is assigned
+    // to this context. If the library provides CustomExecuteAsync
+    // this function returns as soon as the execution is started so
+    // that the runner can schedule the next requests. A non-OK
+    // completion status indicates an internal error that prevents
+    // any of the of requests from completing. If an error is isolate
+    // to a single request payload it will be reported in that
+    // payload.
+    void Run(CustomBackend* base, std::unique_ptr<Execution>&& execution);
+
+    // Collect the payload information of 'execution' into the
+    // CustomPayload structs passed to the library.
+    Status PrepareExecution(Execution* execution);
+
+    // Complete 'execution' given the library's 'err' for it.
+    void CompleteExecution(std::unique_ptr<Execution>&& execution, int err);
+
     // Callback used by custom backends to get the next block of input
     // for a 'name'd input tensor.
     bool GetNextInput(
         GetInputOutputContext* input_context, const char* name,
         const void** content, uint64_t* content_byte_size);
 
+    // Callback used by custom backends to get all the blocks of the
+    // input tensor at 'input_index' for all the payloads of an
+    // execution.
+    bool GetInputBlocks(
+        GetInputOutputContext* input_context, uint32_t input_index,
+        uint32_t* block_cnt, const CustomInputBlock** blocks,
+        const uint32_t** payload_block_starts);
+
+    // Gather the content of the 'name'd input from every payload of
+    // 'execution' into 'input_blocks'.
+    Status GatherInputBlocks(
+        Execution* execution, const std::string& name,
+        InputBlocks* input_blocks);
+
     // Callback used by custom backends to get the output buffer for a
     // 'name'd output tensor.
     bool GetOutput(
@@ -130,6 +210,10 @@ class CustomBackend : public InferenceBackend {
     // batching is not supported.
     int max_batch_size_;
 
+    // The names of the model inputs, in model configuration order,
+    // followed by the names of the sequence batcher control inputs.
+    std::vector<std::string> input_names_;
+
     // The handle to the shared library associated with this context.
     void* library_handle_;
 
@@ -142,6 +226,18 @@ class CustomBackend : public InferenceBackend {
     CustomFinalizeFn_t FinalizeFn_;
     CustomErrorStringFn_t ErrorStringFn_;
     CustomExecuteFn_t ExecuteFn_;
+    CustomExecuteAsyncFn_t ExecuteAsyncFn_;
+
+    // The number of executions started but not yet completed. The
+    // library is not finalized until this reaches zero.
+    std::mutex inflight_mu_;
+    std::condition_variable inflight_cv_;
+    size_t inflight_cnt_;
+
+    // The thread that completes the asynchronous executions of this
+    // context, only created if the library provides CustomExecuteAsync.
+    class CompletionThread;
+    std::unique_ptr<CompletionThread> completion_thread_;
   };
 
   std::vector<std::string> server_params_;
@@ -156,10 +252,20 @@ bool CustomGetNextInput(
     void* input_context, const char* name, const void** content,
     uint64_t* content_byte_size);
 
+// Callback used by custom backends to get all the blocks of an input
+// tensor for an execution.
+bool CustomGetInputBlocks(
+    void* input_context, uint32_t input_index, uint32_t* block_cnt,
+    const CustomInputBlock** blocks, const uint32_t** payload_block_starts);
+
 // Callback used by custom backends to get the output buffer for a
 // 'name'd output tensor.
 bool CustomGetOutput(
     void* output_context, const char* name, size_t shape_dim_cnt,
     int64_t* shape_dims, uint64_t content_byte_size, void** content);
 
+// Callback used by custom backends to report the completion of an
+// execution started with CustomExecuteAsync.
+void CustomExecuteComplete(void* complete_context, int error_code);
+
 }}  // namespace nvidia::inferenceserver
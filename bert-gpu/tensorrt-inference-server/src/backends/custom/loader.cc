@@ -62,13 +62,15 @@ Status
 LoadCustom(
     const std::string& path, void** dlhandle,
     CustomInitializeFn_t* InitializeFn, CustomFinalizeFn_t* FinalizeFn,
-    CustomErrorStringFn_t* ErrorStringFn, CustomExecuteFn_t* ExecuteFn)
+    CustomErrorStringFn_t* ErrorStringFn, CustomExecuteFn_t* ExecuteFn,
+    CustomExecuteAsyncFn_t* ExecuteAsyncFn)
 {
   *dlhandle = nullptr;
   *InitializeFn = nullptr;
   *FinalizeFn = nullptr;
   *ErrorStringFn = nullptr;
   *ExecuteFn = nullptr;
+  *ExecuteAsyncFn = nullptr;
 
   // Load the custom library
   void* handle = dlopen(path.c_str(), RTLD_LAZY);
@@ -102,11 +104,22 @@ LoadCustom(
     return status;
   }
 
+  // CustomExecuteAsync is optional. CustomExecute is only required
+  // when the library doesn't provide CustomExecuteAsync.
+  void* exec_async_fn;
+  status = GetEntrypoint(handle, "CustomExecuteAsync", &exec_async_fn);
+  if (!status.IsOk()) {
+    exec_async_fn = nullptr;
+  }
+
   void* exec_fn;
   status = GetEntrypoint(handle, "CustomExecute", &exec_fn);
   if (!status.IsOk()) {
-    dlclose(handle);
-    return status;
+    if (exec_async_fn == nullptr) {
+      dlclose(handle);
+      return status;
+    }
+    exec_fn = nullptr;
   }
 
   *dlhandle = handle;
@@ -114,6 +127,7 @@ LoadCustom(
   *FinalizeFn = (CustomFinalizeFn_t)fini_fn;
   *ErrorStringFn = (CustomErrorStringFn_t)errstr_fn;
   *ExecuteFn = (CustomExecuteFn_t)exec_fn;
+  *ExecuteAsyncFn = (CustomExecuteAsyncFn_t)exec_async_fn;
 
   return Status::Success;
 }
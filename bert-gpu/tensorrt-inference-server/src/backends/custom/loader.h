@@ -41,12 +41,17 @@ namespace nvidia { namespace inferenceserver {
 /// \param ErrorStringFn Returns the error-string function from the
 /// custom library.
 /// \param ExecuteFn Returns the execute function from the custom
-/// library.
+/// library, or nullptr if the library only provides the asynchronous
+/// execute function.
+/// \param ExecuteAsyncFn Returns the asynchronous execute function
+/// from the custom library, or nullptr if the library does not
+/// provide one.
 /// \return Error status.
 Status LoadCustom(
     const std::string& path, void** dlhandle,
     CustomInitializeFn_t* InitializeFn, CustomFinalizeFn_t* FinalizeFn,
-    CustomErrorStringFn_t* ErrorStringFn, CustomExecuteFn_t* ExecuteFn);
+    CustomErrorStringFn_t* ErrorStringFn, CustomExecuteFn_t* ExecuteFn,
+    CustomExecuteAsyncFn_t* ExecuteAsyncFn);
 
 /// Unload custom shared library.
 ///
@@ -556,6 +556,23 @@ OnnxBackend::Context::SetInputTensor(
     total_byte_size += expected_byte_sizes.back();
   }
 
+  // A single request whose input is one contiguous chunk can be used
+  // by the tensor in place. The request content outlives the tensor
+  // since the payload is held until Run() completes.
+  if ((data_type != TYPE_STRING) && (payloads->size() == 1)) {
+    const void* content;
+    size_t content_byte_size;
+    if (payloads->front().request_provider_->GetContiguousInputContent(
+            name, &content, &content_byte_size) &&
+        (content_byte_size == total_byte_size)) {
+      RETURN_IF_ORT_ERROR(OrtCreateTensorWithDataAsOrtValue(
+          OrtAllocatorGetInfo(allocator_), const_cast<void*>(content),
+          total_byte_size, input_dims.data(), input_dims.size(),
+          ConvertToOnnxDataType(data_type), &input_tensors_.back()));
+      return Status::Success;
+    }
+  }
+
   // Reserve one more byte at the end of input_buffer to ensure last element
   // of String data can become valid C string.
   const size_t buffer_size =
@@ -631,6 +648,7 @@ OnnxBackend::Context::SetInputBuffer(
       memcpy(
           input_buffer + buffer_copy_offset + copied_byte_size, content,
           content_byte_size);
+      payload.request_provider_->IncrementInputCopyByteSize(content_byte_size);
       copied_byte_size += content_byte_size;
     }
 
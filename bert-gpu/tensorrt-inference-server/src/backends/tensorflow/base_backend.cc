@@ -26,6 +26,8 @@
 
 #include "src/backends/tensorflow/base_backend.h"
 
+#include <map>
+#include <mutex>
 #include <set>
 #include "cuda/include/cuda_runtime_api.h"
 #include "src/backends/tensorflow/tf_utils.h"
@@ -36,16 +38,143 @@
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 #include "tensorflow/c/c_api.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/default_device.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/mem.h"
 
 namespace nvidia { namespace inferenceserver {
 
+// Tensorflow allocator that "allocates" request input content that
+// was set with SetContent() so that a tensor can reference that
+// content without copying it. The content is owned by the request so
+// deallocation does nothing. Each context has its own allocator and
+// only uses it from its runner thread.
+class InputContentAllocator : public tensorflow::Allocator {
+ public:
+  InputContentAllocator() : content_(nullptr), content_byte_size_(0) {}
+
+  std::string Name() override { return "trtserver_input_content"; }
+
+  // Set the content to return from the next allocation.
+  void SetContent(const void* content, size_t content_byte_size)
+  {
+    content_ = content;
+    content_byte_size_ = content_byte_size;
+  }
+
+  // Tensorflow requests kAllocatorAlignment but only requires tensor
+  // data to be aligned as needed by Eigen, which is checked when the
+  // tensor is accessed.
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override
+  {
+    void* content = const_cast<void*>(content_);
+    content_ = nullptr;
+    if ((content == nullptr) || (num_bytes != content_byte_size_) ||
+        ((reinterpret_cast<uintptr_t>(content) % EIGEN_MAX_ALIGN_BYTES) !=
+         0)) {
+      return nullptr;
+    }
+
+    return content;
+  }
+
+  void DeallocateRaw(void* ptr) override {}
+
+ private:
+  const void* content_;
+  size_t content_byte_size_;
+};
+
+// Tensorflow allocator that keeps the buffers of released input
+// tensors so that later executions reuse them instead of allocating
+// new ones. An allocation uses the smallest free buffer that is large
+// enough. If there is none, the free buffers are all too small and
+// are released before allocating, so the arena holds buffers sized
+// for the largest batch seen instead of one per batch size. Tensors
+// can be released by the session's threads so access is serialized
+// with 'mu_'.
+class InputArenaAllocator : public tensorflow::Allocator {
+ public:
+  InputArenaAllocator() : allocation_cnt_(0), reuse_cnt_(0) {}
+
+  ~InputArenaAllocator()
+  {
+    for (const auto& pr : free_buffers_) {
+      tensorflow::port::AlignedFree(pr.second);
+    }
+  }
+
+  std::string Name() override { return "trtserver_input_arena"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+
+    auto itr = free_buffers_.lower_bound(num_bytes);
+    if (itr != free_buffers_.end()) {
+      void* ptr = itr->second;
+      used_buffers_.emplace(ptr, itr->first);
+      free_buffers_.erase(itr);
+      reuse_cnt_++;
+      return ptr;
+    }
+
+    for (const auto& pr : free_buffers_) {
+      tensorflow::port::AlignedFree(pr.second);
+    }
+    free_buffers_.clear();
+
+    void* ptr = tensorflow::port::AlignedMalloc(
+        std::max(num_bytes, (size_t)1), alignment);
+    if (ptr != nullptr) {
+      used_buffers_.emplace(ptr, num_bytes);
+      allocation_cnt_++;
+    }
+
+    return ptr;
+  }
+
+  void DeallocateRaw(void* ptr) override
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+
+    auto itr = used_buffers_.find(ptr);
+    if (itr != used_buffers_.end()) {
+      free_buffers_.emplace(itr->second, ptr);
+      used_buffers_.erase(itr);
+    }
+  }
+
+  // Return the number of buffers allocated and the number of buffers
+  // reused since the last call.
+  void TakeCounts(uint32_t* allocation_cnt, uint32_t* reuse_cnt)
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    *allocation_cnt = allocation_cnt_;
+    *reuse_cnt = reuse_cnt_;
+    allocation_cnt_ = 0;
+    reuse_cnt_ = 0;
+  }
+
+ private:
+  std::mutex mu_;
+
+  // Free buffers ordered by size, and buffers in use mapped to their
+  // size.
+  std::multimap<size_t, void*> free_buffers_;
+  std::unordered_map<void*, size_t> used_buffers_;
+
+  uint32_t allocation_cnt_;
+  uint32_t reuse_cnt_;
+};
+
 BaseBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
-      session_(nullptr)
+      session_(nullptr), input_content_allocator_(new InputContentAllocator()),
+      input_arena_allocator_(new InputArenaAllocator())
 {
 }
 
@@ -53,7 +182,9 @@ BaseBackend::Context::Context(Context&& o)
     : name_(std::move(o.name_)), gpu_device_(o.gpu_device_),
       max_batch_size_(o.max_batch_size_),
       input_name_map_(std::move(o.input_name_map_)),
-      output_name_map_(std::move(o.output_name_map_)), session_(o.session_)
+      output_name_map_(std::move(o.output_name_map_)), session_(o.session_),
+      input_content_allocator_(std::move(o.input_content_allocator_)),
+      input_arena_allocator_(std::move(o.input_arena_allocator_))
 {
   o.gpu_device_ = NO_GPU_DEVICE;
   o.max_batch_size_ = NO_BATCHING;
@@ -291,6 +422,7 @@ SetFixedSizedInputTensor(
           static_cast<char*>(flat.data()) + tensor_copy_offset +
               copied_byte_size,
           content, content_byte_size);
+      payload.request_provider_->IncrementInputCopyByteSize(content_byte_size);
       copied_byte_size += content_byte_size;
     }
 
@@ -531,16 +663,45 @@ BaseBackend::Context::SetInput(
     input_tensor_name = &tn_itr->second;
   }
 
-  input_tensors->emplace_back(
-      std::make_pair(*input_tensor_name, tensorflow::Tensor(dtype, shape)));
-  tensorflow::Tensor& tensor = input_tensors->back().second;
-
   if (dtype != tensorflow::DT_STRING) {
     const size_t batch1_byte_size =
         batch1_element_cnt * tensorflow::DataTypeSize(dtype);
-    SetFixedSizedInputTensor(tensor, name, batch1_byte_size, payloads);
+
+    // A single request whose input is one contiguous, suitably
+    // aligned chunk can be used by the tensor in place. The request
+    // content outlives the tensor since the payload is held until
+    // Run() completes.
+    if (payloads->size() == 1) {
+      Scheduler::Payload& payload = payloads->front();
+      const void* content;
+      size_t content_byte_size;
+      if (payload.request_provider_->GetContiguousInputContent(
+              name, &content, &content_byte_size) &&
+          (content_byte_size ==
+           (payload.request_provider_->RequestHeader().batch_size() *
+            batch1_byte_size))) {
+        input_content_allocator_->SetContent(content, content_byte_size);
+        tensorflow::Tensor tensor(
+            input_content_allocator_.get(), dtype, shape);
+        if (tensor.IsInitialized()) {
+          input_tensors->emplace_back(
+              std::make_pair(*input_tensor_name, std::move(tensor)));
+          return;
+        }
+      }
+    }
+
+    input_tensors->emplace_back(std::make_pair(
+        *input_tensor_name,
+        tensorflow::Tensor(input_arena_allocator_.get(), dtype, shape)));
+    SetFixedSizedInputTensor(
+        input_tensors->back().second, name, batch1_byte_size, payloads);
   } else {
-    SetStringInputTensor(tensor, name, batch1_element_cnt, payloads);
+    input_tensors->emplace_back(std::make_pair(
+        *input_tensor_name,
+        tensorflow::Tensor(input_arena_allocator_.get(), dtype, shape)));
+    SetStringInputTensor(
+        input_tensors->back().second, name, batch1_element_cnt, payloads);
   }
 }
 
@@ -620,6 +781,18 @@ BaseBackend::Context::Run(
     }
   }
 
+  // Report the input tensor allocations for this execution with the
+  // first request, in the same way that only one request of a batch
+  // counts the model execution.
+  uint32_t allocation_cnt, reuse_cnt;
+  input_arena_allocator_->TakeCounts(&allocation_cnt, &reuse_cnt);
+  for (auto& payload : *payloads) {
+    if (payload.stats_ != nullptr) {
+      payload.stats_->SetInputTensorCounts(allocation_cnt, reuse_cnt);
+      break;
+    }
+  }
+
   // Collect the names of outputs requested by any request
   // payload. Skip payloads that have an error.
   std::set<std::string> required_outputs;
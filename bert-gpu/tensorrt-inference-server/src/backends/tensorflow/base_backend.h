@@ -33,6 +33,9 @@
 
 namespace nvidia { namespace inferenceserver {
 
+class InputArenaAllocator;
+class InputContentAllocator;
+
 // Base for both GraphDef and SavedModel backends
 class BaseBackend : public InferenceBackend {
  public:
@@ -81,7 +84,9 @@ class BaseBackend : public InferenceBackend {
     // Create TF tensor for an input.
     using TensorVec = std::vector<std::pair<std::string, tensorflow::Tensor>>;
 
-    // Set an input tensor data from payloads.
+    // Set an input tensor data from payloads. If there is a single
+    // payload whose input content is contiguous the tensor references
+    // that content directly instead of copying it.
     void SetInput(
         const std::string& name, const DataType datatype, const DimsList& dims,
         const size_t total_batch_size,
@@ -116,6 +121,14 @@ class BaseBackend : public InferenceBackend {
 
     // Tensorflow session for this context.
     tensorflow::Session* session_;
+
+    // Allocator used to create input tensors that reference request
+    // input content in place.
+    std::unique_ptr<InputContentAllocator> input_content_allocator_;
+
+    // Allocator used to create all other input tensors. It reuses the
+    // buffers of input tensors from previous executions.
+    std::unique_ptr<InputArenaAllocator> input_arena_allocator_;
   };
 
  private:
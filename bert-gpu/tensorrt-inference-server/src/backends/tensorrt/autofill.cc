@@ -117,13 +117,12 @@ AutoFillPlan::Create(
   const std::string plan_file = *(plan_files.begin());
   const auto plan_path = JoinPath({version_path, plan_file});
 
-  std::string plan_data_str;
-  RETURN_IF_ERROR(ReadTextFile(plan_path, &plan_data_str));
-  std::vector<char> plan_data(plan_data_str.begin(), plan_data_str.end());
+  std::shared_ptr<FileBlob> plan_data;
+  RETURN_IF_ERROR(MapFile(plan_path, &plan_data));
 
   nvinfer1::IRuntime* runtime = nullptr;
   nvinfer1::ICudaEngine* engine = nullptr;
-  if (!LoadPlan(plan_data, &runtime, &engine).IsOk()) {
+  if (!LoadPlan(*plan_data, &runtime, &engine).IsOk()) {
     if (engine != nullptr) {
       engine->destroy();
     }
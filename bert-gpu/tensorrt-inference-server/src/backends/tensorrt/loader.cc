@@ -27,15 +27,21 @@
 #include "src/backends/tensorrt/loader.h"
 
 #include <NvOnnxParserRuntime.h>
+#include <mutex>
 #include "src/backends/tensorrt/logging.h"
 
 namespace nvidia { namespace inferenceserver {
 
 Status
 LoadPlan(
-    const std::vector<char>& model_data, nvinfer1::IRuntime** runtime,
+    const FileBlob& model_data, nvinfer1::IRuntime** runtime,
     nvinfer1::ICudaEngine** engine)
 {
+  // TensorRT engine creation is not thread-safe, so every load, from
+  // the backends and from autofill, is serialized with a global lock.
+  static std::mutex global_load_mu;
+  std::lock_guard<std::mutex> glock(global_load_mu);
+
   *engine = nullptr;
   *runtime = nullptr;
 
@@ -51,7 +57,7 @@ LoadPlan(
   }
 
   *engine = (*runtime)->deserializeCudaEngine(
-      &model_data[0], model_data.size(), onnx_plugin_factory);
+      model_data.Data(), model_data.Size(), onnx_plugin_factory);
   if (*engine == nullptr) {
     return Status(
         RequestStatusCode::INTERNAL, "unable to create TensorRT engine");
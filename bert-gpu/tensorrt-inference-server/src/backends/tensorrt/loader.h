@@ -26,6 +26,7 @@
 #pragma once
 
 #include <NvInfer.h>
+#include "src/core/filesystem.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -33,16 +34,17 @@ namespace nvidia { namespace inferenceserver {
 /// Load a TensorRT plan from a binary blob and return the
 /// corresponding runtime and engine. It is the caller's
 /// responsibility to destroy any returned runtime or engine object
-/// even if an error is returned.
+/// even if an error is returned. Loads are serialized across threads
+/// since TensorRT engine creation is not thread-safe.
 ///
-/// \param model_data The binary blob of the plan data
+/// \param model_data The plan file
 /// \param runtime Returns the IRuntime object, or nullptr if failed
 /// to create
 /// \param engine Returns the ICudaEngine object, or nullptr if failed
 /// to create
 /// \return Error status.
 Status LoadPlan(
-    const std::vector<char>& model_data, nvinfer1::IRuntime** runtime,
+    const FileBlob& model_data, nvinfer1::IRuntime** runtime,
     nvinfer1::ICudaEngine** engine);
 
 }}  // namespace nvidia::inferenceserver
@@ -28,7 +28,6 @@
 
 #include <NvInfer.h>
 #include <stdint.h>
-#include <mutex>
 #include "src/backends/tensorrt/loader.h"
 #include "src/backends/tensorrt/plan_utils.h"
 #include "src/core/constants.h"
@@ -43,8 +42,9 @@ namespace nvidia { namespace inferenceserver {
 PlanBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
-      runtime_(nullptr), engine_(nullptr), context_(nullptr),
-      byte_sizes_(nullptr), buffers_(nullptr), stream_(nullptr)
+      context_(nullptr),
+      byte_sizes_(nullptr), buffers_(nullptr), staging_buffers_(nullptr),
+      stream_(nullptr)
 {
 }
 
@@ -70,6 +70,20 @@ PlanBackend::Context::~Context()
     delete[] buffers_;
     buffers_ = nullptr;
   }
+  if (staging_buffers_ != nullptr) {
+    for (int i = 0; i < engine_->getNbBindings(); ++i) {
+      if (staging_buffers_[i] != nullptr) {
+        cudaError_t err = cudaFreeHost(staging_buffers_[i]);
+        if (err != cudaSuccess) {
+          LOG_ERROR << "Failed to free pinned memory for '" << name_
+                    << "': " << cudaGetErrorString(err);
+        }
+      }
+    }
+
+    delete[] staging_buffers_;
+    staging_buffers_ = nullptr;
+  }
 
   for (const auto& pr : cuda_graph_execs_) {
     cudaError_t err = cudaGraphExecDestroy(pr.second);
@@ -101,14 +115,8 @@ PlanBackend::Context::~Context()
     context_->destroy();
     context_ = nullptr;
   }
-  if (engine_ != nullptr) {
-    engine_->destroy();
-    engine_ = nullptr;
-  }
-  if (runtime_ != nullptr) {
-    runtime_->destroy();
-    runtime_ = nullptr;
-  }
+
+  engine_.reset();
 }
 
 Status
@@ -122,20 +130,14 @@ PlanBackend::Init(const std::string& path, const ModelConfig& config)
 
 Status
 PlanBackend::CreateExecutionContexts(
-    const std::unordered_map<std::string, std::vector<char>>& models)
+    const std::unordered_map<std::string, std::shared_ptr<FileBlob>>& models)
 {
-  // TensorRT engine creation is not thread-safe, so multiple creations
-  // are serialized with a global lock.
-  static std::mutex global_context_mu;
-  std::lock_guard<std::mutex> glock(global_context_mu);
-
   uint32_t total_context_cnt = 0;
 
-  // Create a runtime/engine/context trifecta for each instance.
-  //
-  // TODO [DLIS-14] This can be optimized by sharing a runtime (across
-  // all instances?), and sharing an engine across instances that have
-  // access to the same GPU.
+  // Create a context for each instance. The instances on the same GPU
+  // share an engine so that the model weights are loaded on each GPU
+  // only once.
+  EngineMap engines;
   for (const auto& group : Config().instance_group()) {
     // TensorRT requires that every context have a GPU.
     if ((group.kind() != ModelInstanceGroup::KIND_GPU) ||
@@ -151,8 +153,8 @@ PlanBackend::CreateExecutionContexts(
         const std::string instance_name = group.name() + "_" +
                                           std::to_string(c) + "_gpu" +
                                           std::to_string(gpu_device);
-        RETURN_IF_ERROR(
-            CreateExecutionContext(instance_name, gpu_device, models));
+        RETURN_IF_ERROR(CreateExecutionContext(
+            instance_name, gpu_device, models, &engines));
         total_context_cnt++;
       }
     }
@@ -177,7 +179,8 @@ PlanBackend::CreateExecutionContexts(
 Status
 PlanBackend::CreateExecutionContext(
     const std::string& instance_name, const int gpu_device,
-    const std::unordered_map<std::string, std::vector<char>>& models)
+    const std::unordered_map<std::string, std::shared_ptr<FileBlob>>& models,
+    EngineMap* engines)
 {
   cudaError_t cuerr;
 
@@ -224,8 +227,32 @@ PlanBackend::CreateExecutionContext(
                                          ": " + cudaGetErrorString(cuerr));
   }
 
-  RETURN_IF_ERROR(
-      LoadPlan(mn_itr->second, &context->runtime_, &context->engine_));
+  const auto engine_key = std::make_pair(gpu_device, cc_model_filename);
+  auto eit = engines->find(engine_key);
+  if (eit == engines->end()) {
+    nvinfer1::IRuntime* runtime = nullptr;
+    nvinfer1::ICudaEngine* engine = nullptr;
+    Status status = LoadPlan(*(mn_itr->second), &runtime, &engine);
+    if (!status.IsOk()) {
+      if (engine != nullptr) {
+        engine->destroy();
+      }
+      if (runtime != nullptr) {
+        runtime->destroy();
+      }
+      return status;
+    }
+
+    // The runtime must outlive the engine so release both together.
+    std::shared_ptr<nvinfer1::ICudaEngine> shared_engine(
+        engine, [runtime](nvinfer1::ICudaEngine* released_engine) {
+          released_engine->destroy();
+          runtime->destroy();
+        });
+    eit = engines->emplace(engine_key, shared_engine).first;
+  }
+
+  context->engine_ = eit->second;
 
   if (context->max_batch_size_ > context->engine_->getMaxBatchSize()) {
     return Status(
@@ -262,6 +289,8 @@ PlanBackend::CreateExecutionContext(
   // possible batch size: min(engine maximum, config maximum)
   context->byte_sizes_ = new uint64_t[num_expected_bindings];
   context->buffers_ = new void*[num_expected_bindings]();  // init to nullptr
+  context->staging_buffers_ =
+      new void*[num_expected_bindings]();  // init to nullptr
 
   RETURN_IF_ERROR(context->InitializeConfigInputBindings(Config().input()));
   RETURN_IF_ERROR(context->InitializeSequenceControlInputBindings(Config()));
@@ -633,6 +662,27 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
         byte_sizes_[bindex] / std::max(1, max_batch_size_);
     size_t binding_copy_offset = 0;
 
+    // If the batch is formed from multiple requests gather their
+    // input into a pinned buffer and copy it to the GPU with a single
+    // copy instead of a pageable copy for each chunk of each
+    // request. The input of a single request is copied directly.
+    char* staging_buffer = nullptr;
+    if (payloads->size() > 1) {
+      if (staging_buffers_[bindex] == nullptr) {
+        cudaError_t err = cudaHostAlloc(
+            &staging_buffers_[bindex],
+            std::max((uint64_t)1, byte_sizes_[bindex]), cudaHostAllocPortable);
+        if (err != cudaSuccess) {
+          LOG_VERBOSE(1) << "unable to allocate pinned memory for input '"
+                         << name << "' for " << name_ << ": "
+                         << cudaGetErrorString(err);
+          staging_buffers_[bindex] = nullptr;
+        }
+      }
+
+      staging_buffer = static_cast<char*>(staging_buffers_[bindex]);
+    }
+
     // Visit the payloads in order and copy the input tensors to
     // GPU. Skip payloads that had errors since they are not included
     // in the dynamic batch.
@@ -668,7 +718,13 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
           break;
         }
 
-        if (content_byte_size > 0) {
+        if ((content_byte_size > 0) && (staging_buffer != nullptr)) {
+          memcpy(
+              staging_buffer + binding_copy_offset + copied_byte_size, content,
+              content_byte_size);
+          payload.request_provider_->IncrementInputCopyByteSize(
+              content_byte_size);
+        } else if (content_byte_size > 0) {
           cudaError_t err = cudaMemcpyAsync(
               static_cast<char*>(buffers_[bindex]) + binding_copy_offset +
                   copied_byte_size,
@@ -695,6 +751,22 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
 
       binding_copy_offset += expected_byte_size;
     }
+
+    if ((staging_buffer != nullptr) && (binding_copy_offset > 0)) {
+      cudaError_t err = cudaMemcpyAsync(
+          buffers_[bindex], staging_buffer, binding_copy_offset,
+          cudaMemcpyHostToDevice, stream_);
+      if (err != cudaSuccess) {
+        for (auto& payload : *payloads) {
+          if (payload.status_.IsOk()) {
+            payload.status_ = Status(
+                RequestStatusCode::INTERNAL,
+                "failed to copy input values to GPU for input '" + name +
+                    "': " + std::string(cudaGetErrorString(err)));
+          }
+        }
+      }
+    }
   }
 
   // Async execute the inference using a CUDA graph if available for
@@ -26,8 +26,10 @@
 #pragma once
 
 #include <NvInfer.h>
+#include <map>
 #include "cuda/include/cuda_runtime_api.h"
 #include "src/core/backend.h"
+#include "src/core/filesystem.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
@@ -41,13 +43,24 @@ class PlanBackend : public InferenceBackend {
 
   Status Init(const std::string& path, const ModelConfig& config);
 
+  // TensorRT engines, keyed by GPU device and plan filename.
+  using EngineMap = std::map<
+      std::pair<int, std::string>, std::shared_ptr<nvinfer1::ICudaEngine>>;
+
   // Create a context for execution for each instance for the
   // serialized plans specified in 'models'.
   Status CreateExecutionContexts(
-      const std::unordered_map<std::string, std::vector<char>>& models);
+      const std::unordered_map<std::string, std::shared_ptr<FileBlob>>&
+          models);
+
+  // Create a context for execution on 'gpu_device'. The context uses
+  // the engine in 'engines' for its plan on the device, which is
+  // created and added to 'engines' if there isn't one yet.
   Status CreateExecutionContext(
       const std::string& instance_name, const int gpu_device,
-      const std::unordered_map<std::string, std::vector<char>>& models);
+      const std::unordered_map<std::string, std::shared_ptr<FileBlob>>&
+          models,
+      EngineMap* engines);
 
  private:
   // Run model on the context associated with 'runner_idx' to
@@ -107,9 +120,10 @@ class PlanBackend : public InferenceBackend {
     // configuration.
     const int max_batch_size_;
 
-    // TensorRT components for the model
-    nvinfer1::IRuntime* runtime_;
-    nvinfer1::ICudaEngine* engine_;
+    // TensorRT components for the model. The engine, and so the
+    // weights of the model, is shared by all the contexts on the same
+    // GPU.
+    std::shared_ptr<nvinfer1::ICudaEngine> engine_;
     nvinfer1::IExecutionContext* context_;
 
     // For each binding index of the TensorRT engine, the size of the
@@ -118,6 +132,13 @@ class PlanBackend : public InferenceBackend {
     uint64_t* byte_sizes_;
     void** buffers_;
 
+    // For each binding index of the TensorRT engine, a pinned host
+    // buffer used to gather the input tensor from multiple requests
+    // so that it can be copied to the GPU with a single copy. Input
+    // staging buffers are allocated on first use, output binding
+    // entries are always nullptr.
+    void** staging_buffers_;
+
     // The stream where operations are executed.
     cudaStream_t stream_;
 
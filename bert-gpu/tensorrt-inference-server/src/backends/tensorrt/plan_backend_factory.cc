@@ -58,12 +58,11 @@ PlanBackendFactory::CreateBackend(
   std::set<std::string> plan_files;
   RETURN_IF_ERROR(GetDirectoryFiles(path, &plan_files));
 
-  std::unordered_map<std::string, std::vector<char>> models;
+  std::unordered_map<std::string, std::shared_ptr<FileBlob>> models;
   for (const auto& filename : plan_files) {
     const auto plan_path = JoinPath({path, filename});
-    std::string model_data_str;
-    RETURN_IF_ERROR(ReadTextFile(plan_path, &model_data_str));
-    std::vector<char> model_data(model_data_str.begin(), model_data_str.end());
+    std::shared_ptr<FileBlob> model_data;
+    RETURN_IF_ERROR(MapFile(plan_path, &model_data));
     models.emplace(filename, std::move(model_data));
   }
 
@@ -43,14 +43,16 @@ TEST_F(PlanBackendTest, ModelConfigSanity)
     std::unique_ptr<PlanBackend> backend(new PlanBackend());
     Status status = backend->Init(path, config);
     if (status.IsOk()) {
-      std::unordered_map<std::string, std::vector<char>> plan_blobs;
+      std::unordered_map<std::string, std::shared_ptr<FileBlob>> plan_blobs;
 
       for (const auto& filename :
            std::vector<std::string>{kTensorRTPlanFilename}) {
         const auto plan_path = JoinPath({path, filename});
-        tensorflow::string blob_str;
-        ReadTextFile(plan_path, &blob_str);
-        std::vector<char> blob(blob_str.begin(), blob_str.end());
+        std::shared_ptr<FileBlob> blob;
+        status = MapFile(plan_path, &blob);
+        if (!status.IsOk()) {
+          return status;
+        }
         plan_blobs.emplace(filename, std::move(blob));
       }
 
@@ -36,7 +36,9 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <random>
 #include <string>
 #include <thread>
 #include "src/clients/c++/request_grpc.h"
@@ -46,8 +48,11 @@
 namespace ni = nvidia::inferenceserver;
 namespace nic = nvidia::inferenceserver::client;
 
-using TimestampVector =
-    std::vector<std::tuple<struct timespec, struct timespec, uint32_t>>;
+// The start and end time, the flags and the send delay in nsec of each
+// request. The send delay is the time between the scheduled and the
+// actual send of a request in request rate mode, and 0 otherwise.
+using TimestampVector = std::vector<
+    std::tuple<struct timespec, struct timespec, uint32_t, uint64_t>>;
 
 // [TODO] move this to more general place
 // If status is non-OK, return the Error.
@@ -82,7 +87,8 @@ using TimestampVector =
 //     specified, the selected percentile value will be reported instead of
 //     average value.
 //
-// There are two settings (see -d option) for the data collection:
+// There are three settings (see -d and --request-rate-range options) for the
+// data collection:
 // - Fixed concurrent request mode:
 //     In this setting, the client will maintain a fixed number of concurrent
 //     requests sent to the server (see -t option). See ConcurrencyManager for
@@ -121,13 +127,35 @@ using TimestampVector =
 //     of "throughput, latency, concurrent request count" tuples will be
 //     reported in increasing load level order.
 //
+// - Request rate mode:
+//     In this setting, the client will send requests at a target rate
+//     regardless of whether earlier requests have completed (open loop),
+//     with constant, Poisson distributed or trace driven inter-arrival times.
+//     See RequestRateManager for more detail. The latency of a request is
+//     measured from the time the request was scheduled to be sent, so a
+//     client or server that falls behind shows up as higher latency. The
+//     client will perform the following procedure:
+//       1. Measures as in fixed concurrent request mode while sending r
+//          requests per second (r starts at the start of the range).
+//       2. Gathers data reported from step 1.
+//       3. Increases r by the step of the range and repeats step 1 and 2
+//          until r exceeds the end of the range, the throughput falls short
+//          of the request rate (the server is saturated) or latency exceeds
+//          the latency threshold (see -l option).
+//     A collection of "request rate, throughput, latency" tuples will be
+//     reported in increasing load level order.
+//
 // Options:
 // -b: batch size for each request sent.
 // -t: number of concurrent requests sent. If -d is set, -t indicate the number
 //     of concurrent requests to start with ("starting concurrency" level).
 // -d: enable dynamic concurrent request mode.
-// -l: latency threshold in msec, will have no effect if -d is not set.
+// -l: latency threshold in msec, will have no effect if neither -d nor
+//     --request-rate-range is set.
 // -p: time interval for each measurement window in msec.
+// --request-rate-range: enable request rate mode with the rates to measure.
+// --request-distribution: the distribution of the inter-arrival times.
+// --request-intervals: a file of inter-arrival times to replay.
 //
 // For detail of the options not listed, please refer to the usage.
 //
@@ -147,6 +175,8 @@ SignalHandler(int signum)
 
 typedef struct PerformanceStatusStruct {
   uint32_t concurrency;
+  // The target request rate, 0 unless measured in request rate mode
+  double request_rate;
   size_t batch_size;
   // Request count and elapsed time measured by server
   uint64_t server_request_count;
@@ -166,6 +196,9 @@ typedef struct PerformanceStatusStruct {
   uint64_t client_avg_request_time_ns;
   uint64_t client_avg_send_time_ns;
   uint64_t client_avg_receive_time_ns;
+  // The average time between the scheduled and the actual send of a
+  // request, only non-zero in request rate mode
+  uint64_t client_avg_send_delay_ns;
   // Per sec stat
   int client_infer_per_sec;
   int client_sequence_per_sec;
@@ -320,52 +353,24 @@ ContextFactory::CreateInferContext(std::unique_ptr<nic::InferContext>* ctx)
 }
 
 //==============================================================================
-/// ConcurrencyManager is a helper class to send inference requests to inference
-/// server consistently, based on the specified setting, so that the perf_client
-/// can measure performance under different concurrency.
+/// LoadManager is the base class of the helpers that send inference requests
+/// to the inference server to create load on it. It holds the state shared by
+/// the different ways of generating load.
 ///
-/// An instance of concurrency manager will be created at the beginning of the
-/// perf client and it will be used to simulate different load level in respect
-/// to number of concurrent infer requests and to collect per-request statistic.
+/// The worker threads of a load manager record the start time and end time of
+/// each request into a shared vector, and the statistic of their InferContexts
+/// into shared Stat vectors, so that InferenceProfiler can measure the load.
 ///
-/// Detail:
-/// Concurrency Manager will maintain the number of concurrent requests by
-/// spawning worker threads that keep sending randomly generated requests to the
-/// server. The worker threads will record the start time and end
-/// time of each request into a shared vector.
-///
-class ConcurrencyManager {
+class LoadManager {
  public:
-  ~ConcurrencyManager();
-
-  /// Create a concurrency manager that is responsible to maintain specified
-  /// load on inference server.
-  /// \param batch_size The batch size used for each request.
-  /// \param max_threads The maximum number of working threads to be spawned.
-  /// \param sequence_length The base length of each sequence.
-  /// \param zero_input Whether to fill the input tensors with zero.
-  /// \param factory The ContextFactory object used to create InferContext.
-  /// \param manger Returns a new ConcurrencyManager object.
-  /// \return Error object indicating success or failure.
-  static nic::Error Create(
-      const int32_t batch_size, const size_t max_threads,
-      const size_t sequence_length, const bool zero_input,
-      const std::shared_ptr<ContextFactory>& factory,
-      std::unique_ptr<ConcurrencyManager>* manager);
-
-  /// Adjust the number of concurrent requests to be the same as
-  /// 'concurrent_request_count' (by creating threads or by pausing threads)
-  /// \parm concurent_request_count The number of concurrent requests to be
-  /// maintained.
-  /// \return Error object indicating success or failure.
-  nic::Error ChangeConcurrencyLevel(const size_t concurrent_request_count);
+  virtual ~LoadManager() = default;
 
-  /// Check if the concurrency level can be maintained.
+  /// Check if the load can be maintained.
   /// \return Error object indicating success or failure. Failure will be
-  /// returned if concurrency manager can't produce the requested concurrency.
+  /// returned if the load manager can't produce the requested load.
   nic::Error CheckHealth();
 
-  /// Swap the content of the timestamp vector recorded by the concurrency
+  /// Swap the content of the timestamp vector recorded by the load
   /// manager with a new timestamp vector
   /// \param new_timestamps The timestamp vector to be swapped.
   /// \return Error object indicating success or failure.
@@ -373,35 +378,20 @@ class ConcurrencyManager {
 
   /// Get the sum of all contexts' stat
   /// \param contexts_stat Returned the accumulated stat from all contexts
-  /// in concurrency manager
+  /// in load manager
   nic::Error GetAccumulatedContextStat(nic::InferContext::Stat* contexts_stat);
 
   /// \return the batch size used for the inference requests
   const size_t BatchSize() const { return batch_size_; }
 
- private:
-  ConcurrencyManager(
+ protected:
+  LoadManager(
       const int32_t batch_size, const size_t max_threads,
-      const size_t sequence_length, const bool zero_input,
-      const std::shared_ptr<ContextFactory>& factory);
-
-  /// Function for worker that sends async inference requests.
-  /// \param err Returns the status of the worker
-  /// \param stats Returns the statistic of the InferContexts
-  /// \param concurrency The concurrency level that the worker should produce.
-  void AsyncInfer(
-      std::shared_ptr<nic::Error> err,
-      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
-      std::shared_ptr<size_t> concurrency);
+      const bool zero_input, const std::shared_ptr<ContextFactory>& factory);
 
-  /// Function for worker to send async inference requests to a sequence model.
-  /// \param err Returns the status of the worker
-  /// \param stats Returns the statistic of the InferContexts
-  /// \param concurrency The concurrency level that the worker should produce.
-  void AsyncSequenceInfer(
-      std::shared_ptr<nic::Error> err,
-      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
-      std::shared_ptr<size_t> concurrency);
+  /// Join the worker threads and report the errors they had. The derived
+  /// class must have signaled the workers to exit.
+  void JoinWorkers();
 
   /// Helper function to prepare the InferContext for sending inference request.
   /// \param ctx Returns a new InferContext.
@@ -412,15 +402,8 @@ class ConcurrencyManager {
       std::unique_ptr<nic::InferContext::Options>* options,
       std::vector<uint8_t>& input_buffer);
 
-  /// Generate random sequence length based on 'offset_ratio' and
-  /// 'sequence_length_'. (1 +/- 'offset_ratio') * 'sequence_length_'
-  /// \param offset_ratio The offset ratio of the generated length
-  /// \return random sequence length
-  size_t GetRandomLength(double offset_ratio);
-
   size_t batch_size_;
   size_t max_threads_;
-  size_t sequence_length_;
   bool zero_input_;
 
   bool on_sequence_model_;
@@ -432,7 +415,6 @@ class ConcurrencyManager {
   std::vector<std::shared_ptr<nic::Error>> threads_status_;
   std::vector<std::shared_ptr<std::vector<nic::InferContext::Stat>>>
       threads_contexts_stat_;
-  std::vector<std::shared_ptr<size_t>> threads_concurrency_;
 
   // Use condition variable to pause/continue worker threads
   std::condition_variable wake_signal_;
@@ -446,12 +428,19 @@ class ConcurrencyManager {
   std::mutex status_report_mutex_;
 };
 
-ConcurrencyManager::~ConcurrencyManager()
+LoadManager::LoadManager(
+    const int32_t batch_size, const size_t max_threads, const bool zero_input,
+    const std::shared_ptr<ContextFactory>& factory)
+    : batch_size_(batch_size), max_threads_(max_threads),
+      zero_input_(zero_input), factory_(factory)
 {
-  early_exit = true;
-  // wake up all threads
-  wake_signal_.notify_all();
+  request_timestamps_.reset(new TimestampVector());
+  on_sequence_model_ = factory_->IsSequenceModel();
+}
 
+void
+LoadManager::JoinWorkers()
+{
   size_t cnt = 0;
   for (auto& thread : threads_) {
     thread.join();
@@ -464,96 +453,26 @@ ConcurrencyManager::~ConcurrencyManager()
 }
 
 nic::Error
-ConcurrencyManager::Create(
-    const int32_t batch_size, const size_t max_threads,
-    const size_t sequence_length, const bool zero_input,
-    const std::shared_ptr<ContextFactory>& factory,
-    std::unique_ptr<ConcurrencyManager>* manager)
-{
-  manager->reset(new ConcurrencyManager(
-      batch_size, max_threads, sequence_length, zero_input, factory));
-
-  return nic::Error::Success;
-}
-
-ConcurrencyManager::ConcurrencyManager(
-    const int32_t batch_size, const size_t max_threads,
-    const size_t sequence_length, const bool zero_input,
-    const std::shared_ptr<ContextFactory>& factory)
-    : batch_size_(batch_size), max_threads_(max_threads),
-      sequence_length_(sequence_length), zero_input_(zero_input),
-      factory_(factory)
-{
-  request_timestamps_.reset(new TimestampVector());
-  on_sequence_model_ = factory_->IsSequenceModel();
-}
-
-nic::Error
-ConcurrencyManager::ChangeConcurrencyLevel(
-    const size_t concurrent_request_count)
-{
-  // Always prefer to create new threads if the maximum limit has not been met
-  while ((concurrent_request_count > threads_.size()) &&
-         (threads_.size() < max_threads_)) {
-    // Launch new thread for inferencing
-    threads_status_.emplace_back(
-        new nic::Error(ni::RequestStatusCode::SUCCESS));
-    threads_contexts_stat_.emplace_back(
-        new std::vector<nic::InferContext::Stat>());
-    threads_concurrency_.emplace_back(new size_t(0));
-    // Worker executes different functions to maintian concurrency.
-    // For sequence models, multiple contexts must be created for multiple
-    // concurrent sequences. But for other models, one context can send out
-    // multiple requests at the same time. Prefer to one single context as
-    // every infer context creates a worker thread implicitly.
-    if (on_sequence_model_) {
-      threads_.emplace_back(
-          &ConcurrencyManager::AsyncSequenceInfer, this, threads_status_.back(),
-          threads_contexts_stat_.back(), threads_concurrency_.back());
-    } else {
-      threads_.emplace_back(
-          &ConcurrencyManager::AsyncInfer, this, threads_status_.back(),
-          threads_contexts_stat_.back(), threads_concurrency_.back());
-    }
-  }
-
-  // Compute the new concurrency level for each thread (take floor)
-  // and spread the remaining value
-  size_t avg_concurrency = concurrent_request_count / threads_.size();
-  size_t threads_add_one = concurrent_request_count % threads_.size();
-  for (size_t i = 0; i < threads_concurrency_.size(); i++) {
-    *(threads_concurrency_[i]) =
-        avg_concurrency + (i < threads_add_one ? 1 : 0);
-  }
-
-  // Make sure all threads will check their updated concurrency level
-  wake_signal_.notify_all();
-
-  std::cout << "Request concurrency: " << concurrent_request_count << std::endl;
-  return nic::Error::Success;
-}
-
-nic::Error
-ConcurrencyManager::CheckHealth()
+LoadManager::CheckHealth()
 {
-  // Check thread status to make sure that the actual concurrency level is
+  // Check thread status to make sure that the actual load is
   // consistent to the one being reported
   // If some thread return early, main thread will return and
   // the worker thread's error message will be reported
-  // when ConcurrencyManager's destructor get called.
+  // when the load manager's destructor get called.
   for (auto& thread_status : threads_status_) {
     if (!thread_status->IsOk()) {
       return nic::Error(
           ni::RequestStatusCode::INTERNAL,
-          "Failed to maintain concurrency level requested."
-          " Worker thread(s) failed to generate concurrent requests.");
+          "Failed to maintain the requested load."
+          " Worker thread(s) failed to generate requests.");
     }
   }
   return nic::Error::Success;
 }
 
 nic::Error
-ConcurrencyManager::SwapTimestamps(TimestampVector& new_timestamps)
+LoadManager::SwapTimestamps(TimestampVector& new_timestamps)
 {
   // Get the requests in the shared vector
   std::lock_guard<std::mutex> lock(status_report_mutex_);
@@ -562,7 +481,7 @@ ConcurrencyManager::SwapTimestamps(TimestampVector& new_timestamps)
 }
 
 nic::Error
-ConcurrencyManager::PrepareInfer(
+LoadManager::PrepareInfer(
     std::unique_ptr<nic::InferContext>* ctx,
     std::unique_ptr<nic::InferContext::Options>* options,
     std::vector<uint8_t>& input_buffer)
@@ -645,7 +564,7 @@ ConcurrencyManager::PrepareInfer(
 }
 
 nic::Error
-ConcurrencyManager::GetAccumulatedContextStat(
+LoadManager::GetAccumulatedContextStat(
     nic::InferContext::Stat* contexts_stat)
 {
   std::lock_guard<std::mutex> lk(status_report_mutex_);
@@ -664,6 +583,158 @@ ConcurrencyManager::GetAccumulatedContextStat(
   return nic::Error::Success;
 }
 
+//==============================================================================
+/// ConcurrencyManager is a helper class to send inference requests to inference
+/// server consistently, based on the specified setting, so that the perf_client
+/// can measure performance under different concurrency.
+///
+/// An instance of concurrency manager will be created at the beginning of the
+/// perf client and it will be used to simulate different load level in respect
+/// to number of concurrent infer requests and to collect per-request statistic.
+///
+/// Detail:
+/// Concurrency Manager will maintain the number of concurrent requests by
+/// spawning worker threads that keep sending randomly generated requests to the
+/// server. The worker threads will record the start time and end
+/// time of each request into a shared vector.
+///
+class ConcurrencyManager : public LoadManager {
+ public:
+  ~ConcurrencyManager();
+
+  /// Create a concurrency manager that is responsible to maintain specified
+  /// load on inference server.
+  /// \param batch_size The batch size used for each request.
+  /// \param max_threads The maximum number of working threads to be spawned.
+  /// \param sequence_length The base length of each sequence.
+  /// \param zero_input Whether to fill the input tensors with zero.
+  /// \param factory The ContextFactory object used to create InferContext.
+  /// \param manger Returns a new ConcurrencyManager object.
+  /// \return Error object indicating success or failure.
+  static nic::Error Create(
+      const int32_t batch_size, const size_t max_threads,
+      const size_t sequence_length, const bool zero_input,
+      const std::shared_ptr<ContextFactory>& factory,
+      std::unique_ptr<LoadManager>* manager);
+
+  /// Adjust the number of concurrent requests to be the same as
+  /// 'concurrent_request_count' (by creating threads or by pausing threads)
+  /// \parm concurent_request_count The number of concurrent requests to be
+  /// maintained.
+  /// \return Error object indicating success or failure.
+  nic::Error ChangeConcurrencyLevel(const size_t concurrent_request_count);
+
+ private:
+  ConcurrencyManager(
+      const int32_t batch_size, const size_t max_threads,
+      const size_t sequence_length, const bool zero_input,
+      const std::shared_ptr<ContextFactory>& factory);
+
+  /// Function for worker that sends async inference requests.
+  /// \param err Returns the status of the worker
+  /// \param stats Returns the statistic of the InferContexts
+  /// \param concurrency The concurrency level that the worker should produce.
+  void AsyncInfer(
+      std::shared_ptr<nic::Error> err,
+      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+      std::shared_ptr<size_t> concurrency);
+
+  /// Function for worker to send async inference requests to a sequence model.
+  /// \param err Returns the status of the worker
+  /// \param stats Returns the statistic of the InferContexts
+  /// \param concurrency The concurrency level that the worker should produce.
+  void AsyncSequenceInfer(
+      std::shared_ptr<nic::Error> err,
+      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+      std::shared_ptr<size_t> concurrency);
+
+  /// Generate random sequence length based on 'offset_ratio' and
+  /// 'sequence_length_'. (1 +/- 'offset_ratio') * 'sequence_length_'
+  /// \param offset_ratio The offset ratio of the generated length
+  /// \return random sequence length
+  size_t GetRandomLength(double offset_ratio);
+
+  size_t sequence_length_;
+
+  std::vector<std::shared_ptr<size_t>> threads_concurrency_;
+};
+
+ConcurrencyManager::~ConcurrencyManager()
+{
+  early_exit = true;
+  // wake up all threads
+  wake_signal_.notify_all();
+
+  JoinWorkers();
+}
+
+nic::Error
+ConcurrencyManager::Create(
+    const int32_t batch_size, const size_t max_threads,
+    const size_t sequence_length, const bool zero_input,
+    const std::shared_ptr<ContextFactory>& factory,
+    std::unique_ptr<LoadManager>* manager)
+{
+  manager->reset(new ConcurrencyManager(
+      batch_size, max_threads, sequence_length, zero_input, factory));
+
+  return nic::Error::Success;
+}
+
+ConcurrencyManager::ConcurrencyManager(
+    const int32_t batch_size, const size_t max_threads,
+    const size_t sequence_length, const bool zero_input,
+    const std::shared_ptr<ContextFactory>& factory)
+    : LoadManager(batch_size, max_threads, zero_input, factory),
+      sequence_length_(sequence_length)
+{
+}
+
+nic::Error
+ConcurrencyManager::ChangeConcurrencyLevel(
+    const size_t concurrent_request_count)
+{
+  // Always prefer to create new threads if the maximum limit has not been met
+  while ((concurrent_request_count > threads_.size()) &&
+         (threads_.size() < max_threads_)) {
+    // Launch new thread for inferencing
+    threads_status_.emplace_back(
+        new nic::Error(ni::RequestStatusCode::SUCCESS));
+    threads_contexts_stat_.emplace_back(
+        new std::vector<nic::InferContext::Stat>());
+    threads_concurrency_.emplace_back(new size_t(0));
+    // Worker executes different functions to maintian concurrency.
+    // For sequence models, multiple contexts must be created for multiple
+    // concurrent sequences. But for other models, one context can send out
+    // multiple requests at the same time. Prefer to one single context as
+    // every infer context creates a worker thread implicitly.
+    if (on_sequence_model_) {
+      threads_.emplace_back(
+          &ConcurrencyManager::AsyncSequenceInfer, this, threads_status_.back(),
+          threads_contexts_stat_.back(), threads_concurrency_.back());
+    } else {
+      threads_.emplace_back(
+          &ConcurrencyManager::AsyncInfer, this, threads_status_.back(),
+          threads_contexts_stat_.back(), threads_concurrency_.back());
+    }
+  }
+
+  // Compute the new concurrency level for each thread (take floor)
+  // and spread the remaining value
+  size_t avg_concurrency = concurrent_request_count / threads_.size();
+  size_t threads_add_one = concurrent_request_count % threads_.size();
+  for (size_t i = 0; i < threads_concurrency_.size(); i++) {
+    *(threads_concurrency_[i]) =
+        avg_concurrency + (i < threads_add_one ? 1 : 0);
+  }
+
+  // Make sure all threads will check their updated concurrency level
+  wake_signal_.notify_all();
+
+  std::cout << "Request concurrency: " << concurrent_request_count << std::endl;
+  return nic::Error::Success;
+}
+
 // Function for worker threads, using only one context to maintain
 // concurrency assigned to worker
 void
@@ -755,7 +826,7 @@ ConcurrencyManager::AsyncInfer(
         status_report_mutex_.lock();
         // Critical section
         request_timestamps_->emplace_back(
-            std::make_tuple(start_time, end_time, flags));
+            std::make_tuple(start_time, end_time, flags, 0));
         // Update its InferContext statistic to shared Stat pointer
         ctx->GetStat(&((*stats)[0]));
         status_report_mutex_.unlock();
@@ -883,7 +954,7 @@ ConcurrencyManager::AsyncSequenceInfer(
           status_report_mutex_.lock();
           // Critical section
           request_timestamps_->emplace_back(
-              std::make_tuple(start_time, end_time, flags));
+              std::make_tuple(start_time, end_time, flags, 0));
           // Update its InferContext statistic to shared Stat pointer
           ctxs[idx]->GetStat(&((*stats)[idx]));
           status_report_mutex_.unlock();
@@ -914,6 +985,392 @@ ConcurrencyManager::GetRandomLength(double offset_ratio)
   return sequence_length_ + random_offset;
 }
 
+//==============================================================================
+/// RequestRateManager is a helper class to send inference requests to the
+/// inference server at a target request rate, regardless of how fast the
+/// server responds, so that the perf_client can measure performance under
+/// different arrival rates (open loop) and not only under different
+/// concurrency (closed loop).
+///
+/// Detail:
+/// The requests are spread over 'max_threads' worker threads, each with its
+/// own InferContext. A worker sends each of its requests at the scheduled
+/// time without waiting for the responses of earlier requests, and collects
+/// the responses that are ready while it waits for the next scheduled time.
+/// Since the InferContext is not thread-safe, the worker does both from its
+/// own thread and polls for responses every kResponsePollIntervalNs. The
+/// latency of a request is measured from its scheduled send time instead of
+/// from the time it was actually sent. If the client or the server falls
+/// behind the schedule the delay shows up in the latency rather than as a
+/// lower request rate (i.e. the measurement does not suffer from coordinated
+/// omission). The delay of each send is also reported on its own, so that it
+/// can be told apart from the time spent in the network and the server.
+///
+/// The inter-arrival times are either constant, exponentially distributed
+/// (a Poisson process), or replayed from a trace.
+///
+class RequestRateManager : public LoadManager {
+ public:
+  enum Distribution { CONSTANT = 0, POISSON = 1, TRACE = 2 };
+
+  ~RequestRateManager();
+
+  /// Create a request rate manager that is responsible to send requests at
+  /// the specified rate to the inference server.
+  /// \param batch_size The batch size used for each request.
+  /// \param max_threads The number of worker threads sending requests.
+  /// \param zero_input Whether to fill the input tensors with zero.
+  /// \param distribution The distribution of the inter-arrival times.
+  /// \param trace_intervals_us The inter-arrival times in usec to replay,
+  /// only used if 'distribution' is TRACE.
+  /// \param factory The ContextFactory object used to create InferContext.
+  /// \param manager Returns a new RequestRateManager object.
+  /// \return Error object indicating success or failure.
+  static nic::Error Create(
+      const int32_t batch_size, const size_t max_threads,
+      const bool zero_input, const Distribution distribution,
+      const std::vector<uint64_t>& trace_intervals_us,
+      const std::shared_ptr<ContextFactory>& factory,
+      std::unique_ptr<LoadManager>* manager);
+
+  /// Change the number of requests sent per second to 'request_rate'. The
+  /// schedule restarts from the time of the change. For a trace the
+  /// recorded inter-arrival times are scaled to match 'request_rate'.
+  /// \param request_rate The number of requests to send per second.
+  /// \return Error object indicating success or failure.
+  nic::Error ChangeRequestRate(const double request_rate);
+
+  /// \return The request rate of the trace as recorded, or 0 if the
+  /// inter-arrival times are not replayed from a trace.
+  double TraceRequestRate() const;
+
+ private:
+  RequestRateManager(
+      const int32_t batch_size, const size_t max_threads,
+      const bool zero_input, const Distribution distribution,
+      const std::vector<uint64_t>& trace_intervals_us,
+      const std::shared_ptr<ContextFactory>& factory);
+
+  /// Function for worker that sends async inference requests on schedule.
+  /// \param err Returns the status of the worker
+  /// \param stats Returns the statistic of the InferContexts
+  /// \param worker_id The index of the worker. Worker 'i' sends requests
+  /// i, i + max_threads, i + 2 * max_threads, ... of the schedule.
+  void Infer(
+      std::shared_ptr<nic::Error> err,
+      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+      const size_t worker_id);
+
+  /// \param request_idx The index of a request in the schedule.
+  /// \param request_cnt The number of requests to advance.
+  /// \param request_rate The request rate of the schedule.
+  /// \param rng The random number generator of the calling worker.
+  /// \return The time in nsec between request 'request_idx' and request
+  /// 'request_idx' + 'request_cnt' of the schedule. For a Poisson process
+  /// the return value is the next interval of the calling worker.
+  uint64_t ScheduleInterval(
+      const size_t request_idx, const size_t request_cnt,
+      const double request_rate, std::mt19937_64& rng) const;
+
+  Distribution distribution_;
+  std::vector<uint64_t> trace_intervals_ns_;
+  uint64_t trace_duration_ns_;
+
+  // The current schedule, protected by 'wake_mutex_'. The generation is
+  // increased on every change so that the workers restart their
+  // schedule.
+  double request_rate_;
+  uint64_t schedule_start_ns_;
+  size_t schedule_generation_;
+  // The number of workers that have prepared their InferContext.
+  size_t started_workers_;
+};
+
+// The interval at which a request rate worker checks for responses
+// while it waits to send its next request.
+constexpr uint64_t kResponsePollIntervalNs = 50 * 1000;
+
+uint64_t
+NowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * ni::NANOS_PER_SECOND + ts.tv_nsec;
+}
+
+RequestRateManager::~RequestRateManager()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    early_exit = true;
+  }
+  // wake up all threads
+  wake_signal_.notify_all();
+
+  JoinWorkers();
+}
+
+nic::Error
+RequestRateManager::Create(
+    const int32_t batch_size, const size_t max_threads, const bool zero_input,
+    const Distribution distribution,
+    const std::vector<uint64_t>& trace_intervals_us,
+    const std::shared_ptr<ContextFactory>& factory,
+    std::unique_ptr<LoadManager>* manager)
+{
+  if (factory->IsSequenceModel()) {
+    return nic::Error(
+        ni::RequestStatusCode::UNSUPPORTED,
+        "request rate mode does not support sequence models");
+  }
+
+  if (distribution == Distribution::TRACE) {
+    uint64_t trace_duration_us = 0;
+    for (const auto interval_us : trace_intervals_us) {
+      trace_duration_us += interval_us;
+    }
+    if (trace_duration_us == 0) {
+      return nic::Error(
+          ni::RequestStatusCode::INVALID_ARG,
+          "request intervals must contain at least one non-zero interval");
+    }
+  }
+
+  manager->reset(new RequestRateManager(
+      batch_size, max_threads, zero_input, distribution, trace_intervals_us,
+      factory));
+
+  return nic::Error::Success;
+}
+
+RequestRateManager::RequestRateManager(
+    const int32_t batch_size, const size_t max_threads, const bool zero_input,
+    const Distribution distribution,
+    const std::vector<uint64_t>& trace_intervals_us,
+    const std::shared_ptr<ContextFactory>& factory)
+    : LoadManager(batch_size, max_threads, zero_input, factory),
+      distribution_(distribution), trace_duration_ns_(0), request_rate_(0),
+      schedule_start_ns_(0), schedule_generation_(0), started_workers_(0)
+{
+  for (const auto interval_us : trace_intervals_us) {
+    trace_intervals_ns_.push_back(interval_us * 1000);
+    trace_duration_ns_ += interval_us * 1000;
+  }
+}
+
+double
+RequestRateManager::TraceRequestRate() const
+{
+  if ((distribution_ != Distribution::TRACE) || (trace_duration_ns_ == 0)) {
+    return 0;
+  }
+  return trace_intervals_ns_.size() * (double)ni::NANOS_PER_SECOND /
+         trace_duration_ns_;
+}
+
+nic::Error
+RequestRateManager::ChangeRequestRate(const double request_rate)
+{
+  if (request_rate <= 0) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG, "request rate must be > 0");
+  }
+
+  // Launch the workers on the first change and wait for them to
+  // prepare their contexts so that the schedule is not started behind.
+  if (threads_.empty()) {
+    for (size_t i = 0; i < max_threads_; i++) {
+      threads_status_.emplace_back(
+          new nic::Error(ni::RequestStatusCode::SUCCESS));
+      threads_contexts_stat_.emplace_back(
+          new std::vector<nic::InferContext::Stat>());
+      threads_.emplace_back(
+          &RequestRateManager::Infer, this, threads_status_.back(),
+          threads_contexts_stat_.back(), i);
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_signal_.wait(lock, [this]() {
+      return early_exit || (started_workers_ == threads_.size());
+    });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    request_rate_ = request_rate;
+    schedule_start_ns_ = NowNs();
+    schedule_generation_++;
+  }
+  wake_signal_.notify_all();
+
+  std::cout << "Request rate: " << request_rate << " requests/sec"
+            << std::endl;
+  return nic::Error::Success;
+}
+
+uint64_t
+RequestRateManager::ScheduleInterval(
+    const size_t request_idx, const size_t request_cnt,
+    const double request_rate, std::mt19937_64& rng) const
+{
+  double interval_ns = 0;
+  switch (distribution_) {
+    case Distribution::CONSTANT:
+      interval_ns = request_cnt * ni::NANOS_PER_SECOND / request_rate;
+      break;
+    case Distribution::POISSON: {
+      // Each worker is an independent Poisson process at its share of
+      // the rate, together they form a Poisson process at the full
+      // rate. So a single exponentially distributed interval is drawn
+      // regardless of 'request_cnt'.
+      std::exponential_distribution<double> dist(
+          request_rate / (max_threads_ * (double)ni::NANOS_PER_SECOND));
+      interval_ns = dist(rng);
+      break;
+    }
+    case Distribution::TRACE: {
+      // Replay the trace in a loop, scaled to the requested rate.
+      uint64_t trace_ns = 0;
+      for (size_t i = 0; i < request_cnt; i++) {
+        trace_ns +=
+            trace_intervals_ns_[(request_idx + i) % trace_intervals_ns_.size()];
+      }
+      interval_ns = trace_ns * TraceRequestRate() / request_rate;
+      break;
+    }
+  }
+
+  return (uint64_t)interval_ns;
+}
+
+// Function for worker threads, sending the requests of the worker at
+// their scheduled time and collecting the responses in between
+void
+RequestRateManager::Infer(
+    std::shared_ptr<nic::Error> err,
+    std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+    const size_t worker_id)
+{
+  std::vector<uint8_t> input_buf;
+  std::unique_ptr<nic::InferContext::Options> options(nullptr);
+  std::unique_ptr<nic::InferContext> ctx;
+
+  stats->emplace_back();
+  *err = PrepareInfer(&ctx, &options, input_buf);
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    started_workers_++;
+  }
+  wake_signal_.notify_all();
+  if (!err->IsOk()) {
+    return;
+  }
+
+  // The scheduled send time and the send delay of the requests that
+  // are in flight.
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> requests_start_time;
+  std::shared_ptr<nic::InferContext::Request> request;
+  std::map<std::string, std::unique_ptr<nic::InferContext::Result>> results;
+
+  std::mt19937_64 rng(std::random_device{}());
+  size_t generation = 0;
+  size_t request_idx = 0;
+  uint64_t next_ns = 0;
+  double request_rate = 0;
+
+  // run inferencing until receiving exit signal
+  while (!early_exit) {
+    // Restart the schedule whenever the request rate changes.
+    uint64_t wait_ns = ni::NANOS_PER_SECOND;
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      if (generation != schedule_generation_) {
+        generation = schedule_generation_;
+        request_rate = request_rate_;
+        request_idx = worker_id;
+        next_ns = schedule_start_ns_ +
+                  ScheduleInterval(0, worker_id, request_rate, rng);
+      }
+    }
+
+    // Send the next request of this worker once it is due.
+    if (request_rate > 0) {
+      const uint64_t now_ns = NowNs();
+      if (now_ns >= next_ns) {
+        *err = ctx->AsyncRun(&request);
+        if (!err->IsOk()) {
+          break;
+        }
+        requests_start_time.emplace(
+            request->Id(), std::make_pair(next_ns, now_ns - next_ns));
+
+        next_ns +=
+            ScheduleInterval(request_idx, max_threads_, request_rate, rng);
+        request_idx += max_threads_;
+        continue;
+      }
+      wait_ns = next_ns - now_ns;
+    }
+
+    // Until then collect the responses that are ready. The InferContext
+    // is not thread-safe, so the responses are polled from this thread
+    // instead of waited for on another thread.
+    if (!requests_start_time.empty()) {
+      bool is_ready = false;
+      *err = ctx->GetReadyAsyncRequest(&request, &is_ready, false /* wait */);
+      if (!err->IsOk()) {
+        break;
+      }
+      if (is_ready) {
+        *err = ctx->GetAsyncRunResults(&results, &is_ready, request, true);
+        if (!err->IsOk()) {
+          break;
+        }
+
+        struct timespec end_time;
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        auto itr = requests_start_time.find(request->Id());
+        struct timespec start_time;
+        start_time.tv_sec = itr->second.first / ni::NANOS_PER_SECOND;
+        start_time.tv_nsec = itr->second.first % ni::NANOS_PER_SECOND;
+        const uint64_t send_delay_ns = itr->second.second;
+        requests_start_time.erase(itr);
+
+        // Add the request timestamp to shared vector with proper locking
+        status_report_mutex_.lock();
+        // Critical section
+        request_timestamps_->emplace_back(
+            std::make_tuple(start_time, end_time, 0, send_delay_ns));
+        // Update its InferContext statistic to shared Stat pointer
+        ctx->GetStat(&((*stats)[0]));
+        status_report_mutex_.unlock();
+        continue;
+      }
+
+      wait_ns = std::min(wait_ns, kResponsePollIntervalNs);
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    if (!early_exit && (generation == schedule_generation_)) {
+      wake_signal_.wait_for(lock, std::chrono::nanoseconds(wait_ns));
+    }
+  }
+
+  // Wait for the requests in flight so that the InferContext is not
+  // destroyed while they are outstanding.
+  while (err->IsOk() && !requests_start_time.empty()) {
+    bool is_ready = false;
+    *err = ctx->GetReadyAsyncRequest(&request, &is_ready, true /* wait */);
+    if (err->IsOk()) {
+      *err = ctx->GetAsyncRunResults(&results, &is_ready, request, true);
+    }
+    if (err->IsOk()) {
+      requests_start_time.erase(request->Id());
+    }
+  }
+}
+
 //==============================================================================
 /// A InferenceProfiler is a helper class that measures and summarizes the
 /// inference statistic under different concurrency level.
@@ -957,7 +1414,7 @@ class InferenceProfiler {
       const bool verbose, const bool profile, const double stable_offset,
       const uint64_t measurement_window_ms, const size_t max_measurement_count,
       const int64_t percentile, std::shared_ptr<ContextFactory>& factory,
-      std::unique_ptr<ConcurrencyManager> manager,
+      std::unique_ptr<LoadManager> manager,
       std::unique_ptr<InferenceProfiler>* profiler);
 
   /// Actively measure throughput in every 'measurement_window' msec until the
@@ -974,9 +1431,19 @@ class InferenceProfiler {
   nic::Error Profile(
       const size_t concurrent_request_count, PerfStatus& status_summary);
 
+  /// Same as Profile() but the load is generated at a fixed request rate
+  /// instead of a fixed concurrency. The profiler must have been created
+  /// with a RequestRateManager.
+  /// \param request_rate The number of requests per second for the
+  /// measurement.
+  /// \param status_summary Returns the summary of the measurement.
+  /// \return Error object indicating success or failure.
+  nic::Error ProfileRequestRate(
+      const double request_rate, PerfStatus& status_summary);
+
  private:
-  using TimestampVector =
-      std::vector<std::tuple<struct timespec, struct timespec, uint32_t>>;
+  using TimestampVector = std::vector<
+      std::tuple<struct timespec, struct timespec, uint32_t, uint64_t>>;
 
   InferenceProfiler(
       const bool verbose, const bool profile, const double stable_offset,
@@ -986,12 +1453,19 @@ class InferenceProfiler {
       const int64_t model_version,
       std::unique_ptr<nic::ProfileContext> profile_ctx,
       std::unique_ptr<nic::ServerStatusContext> status_ctx,
-      std::unique_ptr<ConcurrencyManager> manager);
+      std::unique_ptr<LoadManager> manager);
 
   nic::Error StartProfile() { return profile_ctx_->StartProfile(); }
 
   nic::Error StopProfile() { return profile_ctx_->StopProfile(); }
 
+  /// Helper function to measure until the measurements are stable or the
+  /// maximum number of measurements is reached.
+  /// \param status_summary Returns the summary of the last measurement.
+  /// \param is_stable Returns whether the measurements are stable.
+  /// \return Error object indicating success or failure.
+  nic::Error ProfileHelper(PerfStatus& status_summary, bool* is_stable);
+
   /// Helper function to perform measurement.
   /// \param status_summary The summary of this measurement.
   /// \return Error object indicating success or failure.
@@ -1027,12 +1501,14 @@ class InferenceProfiler {
   /// \param valid_sequence_count Returns the number of completed sequences
   /// during the measurement. A sequence is a set of correlated requests sent to
   /// sequence model.
+  /// \param valid_send_delay_ns Returns the total send delay of the requests
+  /// completed during the measurement.
   /// \return the vector of request latencies where the requests are completed
   /// within the measurement window.
   std::vector<uint64_t> ValidLatencyMeasurement(
       const TimestampVector& timestamps,
       const std::pair<uint64_t, uint64_t>& valid_range,
-      size_t& valid_sequence_count);
+      size_t& valid_sequence_count, uint64_t& valid_send_delay_ns);
 
   /// \param latencies The vector of request latencies collected.
   /// \param summary Returns the summary that the latency related fields are
@@ -1078,7 +1554,7 @@ class InferenceProfiler {
 
   std::unique_ptr<nic::ProfileContext> profile_ctx_;
   std::unique_ptr<nic::ServerStatusContext> status_ctx_;
-  std::unique_ptr<ConcurrencyManager> manager_;
+  std::unique_ptr<LoadManager> manager_;
 };
 
 nic::Error
@@ -1086,7 +1562,7 @@ InferenceProfiler::Create(
     const bool verbose, const bool profile, const double stable_offset,
     const uint64_t measurement_window_ms, const size_t max_measurement_count,
     const int64_t percentile, std::shared_ptr<ContextFactory>& factory,
-    std::unique_ptr<ConcurrencyManager> manager,
+    std::unique_ptr<LoadManager> manager,
     std::unique_ptr<InferenceProfiler>* profiler)
 {
   std::unique_ptr<nic::ProfileContext> profile_ctx;
@@ -1110,7 +1586,7 @@ InferenceProfiler::InferenceProfiler(
     const int64_t model_version,
     std::unique_ptr<nic::ProfileContext> profile_ctx,
     std::unique_ptr<nic::ServerStatusContext> status_ctx,
-    std::unique_ptr<ConcurrencyManager> manager)
+    std::unique_ptr<LoadManager> manager)
     : verbose_(verbose), profile_(profile), stable_offset_(stable_offset),
       measurement_window_ms_(measurement_window_ms),
       max_measurement_count_(max_measurement_count),
@@ -1125,10 +1601,64 @@ nic::Error
 InferenceProfiler::Profile(
     const size_t concurrent_request_count, PerfStatus& status_summary)
 {
+  ConcurrencyManager* manager =
+      dynamic_cast<ConcurrencyManager*>(manager_.get());
+  if (manager == nullptr) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "concurrency can only be changed by a concurrency manager");
+  }
+
   status_summary.concurrency = concurrent_request_count;
+  status_summary.request_rate = 0;
+
+  RETURN_IF_ERROR(manager->ChangeConcurrencyLevel(concurrent_request_count));
+
+  bool stable;
+  RETURN_IF_ERROR(ProfileHelper(status_summary, &stable));
+  if (!stable) {
+    std::cerr << "Failed to obtain stable measurement within "
+              << max_measurement_count_
+              << " measurement windows for concurrency "
+              << concurrent_request_count << ". Please try to "
+              << "increase the time window." << std::endl;
+  }
+
+  return nic::Error::Success;
+}
+
+nic::Error
+InferenceProfiler::ProfileRequestRate(
+    const double request_rate, PerfStatus& status_summary)
+{
+  RequestRateManager* manager =
+      dynamic_cast<RequestRateManager*>(manager_.get());
+  if (manager == nullptr) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "request rate can only be changed by a request rate manager");
+  }
+
+  status_summary.concurrency = 0;
+  status_summary.request_rate = request_rate;
+
+  RETURN_IF_ERROR(manager->ChangeRequestRate(request_rate));
+
+  bool stable;
+  RETURN_IF_ERROR(ProfileHelper(status_summary, &stable));
+  if (!stable) {
+    std::cerr << "Failed to obtain stable measurement within "
+              << max_measurement_count_
+              << " measurement windows for request rate " << request_rate
+              << ". Please try to increase the time window." << std::endl;
+  }
 
-  RETURN_IF_ERROR(manager_->ChangeConcurrencyLevel(concurrent_request_count));
+  return nic::Error::Success;
+}
 
+nic::Error
+InferenceProfiler::ProfileHelper(PerfStatus& status_summary, bool* is_stable)
+{
   // Start measurement
   size_t recent_k = 3;
   std::vector<int> infer_per_sec;
@@ -1190,14 +1720,9 @@ InferenceProfiler::Profile(
   } while ((!early_exit) && (infer_per_sec.size() < max_measurement_count_));
   if (early_exit) {
     return nic::Error(ni::RequestStatusCode::INTERNAL, "Received exit signal.");
-  } else if (!stable) {
-    std::cerr << "Failed to obtain stable measurement within "
-              << max_measurement_count_
-              << " measurement windows for concurrency "
-              << concurrent_request_count << ". Please try to "
-              << "increase the time window." << std::endl;
   }
 
+  *is_stable = stable;
   return nic::Error::Success;
 }
 
@@ -1267,13 +1792,15 @@ InferenceProfiler::Summarize(
     const nic::InferContext::Stat& end_stat, PerfStatus& summary)
 {
   size_t valid_sequence_count = 0;
+  uint64_t valid_send_delay_ns = 0;
 
   // Get measurement from requests that fall within the time interval
   std::pair<uint64_t, uint64_t> valid_range = MeasurementTimestamp(timestamps);
-  std::vector<uint64_t> latencies =
-      ValidLatencyMeasurement(timestamps, valid_range, valid_sequence_count);
+  std::vector<uint64_t> latencies = ValidLatencyMeasurement(
+      timestamps, valid_range, valid_sequence_count, valid_send_delay_ns);
 
   RETURN_IF_ERROR(SummarizeLatency(latencies, summary));
+  summary.client_avg_send_delay_ns = valid_send_delay_ns / latencies.size();
   RETURN_IF_ERROR(SummarizeClientStat(
       start_stat, end_stat, valid_range.second - valid_range.first,
       latencies.size(), valid_sequence_count, summary));
@@ -1323,10 +1850,11 @@ std::vector<uint64_t>
 InferenceProfiler::ValidLatencyMeasurement(
     const TimestampVector& timestamps,
     const std::pair<uint64_t, uint64_t>& valid_range,
-    size_t& valid_sequence_count)
+    size_t& valid_sequence_count, uint64_t& valid_send_delay_ns)
 {
   std::vector<uint64_t> valid_latencies;
   valid_sequence_count = 0;
+  valid_send_delay_ns = 0;
   for (auto& timestamp : timestamps) {
     uint64_t request_start_ns =
         std::get<0>(timestamp).tv_sec * ni::NANOS_PER_SECOND +
@@ -1340,6 +1868,7 @@ InferenceProfiler::ValidLatencyMeasurement(
       if ((request_end_ns >= valid_range.first) &&
           (request_end_ns <= valid_range.second)) {
         valid_latencies.push_back(request_end_ns - request_start_ns);
+        valid_send_delay_ns += std::get<3>(timestamp);
         if (std::get<2>(timestamp) & ni::InferRequestHeader::FLAG_SEQUENCE_END)
           valid_sequence_count++;
       }
@@ -1596,6 +2125,11 @@ Report(
     std::cout << "    Avg latency: " << avg_latency_us << " usec"
               << " (standard deviation " << std_us << " usec)" << std::endl;
   }
+  if (summary.request_rate > 0) {
+    std::cout << "    Avg send delay: "
+              << (summary.client_avg_send_delay_ns / 1000) << " usec"
+              << std::endl;
+  }
   std::cout << client_library_detail << std::endl
             << "  Server: " << std::endl
             << "    Request count: " << cnt << std::endl
@@ -1608,6 +2142,75 @@ Report(
   return nic::Error(ni::RequestStatusCode::SUCCESS);
 }
 
+RequestRateManager::Distribution
+ParseDistribution(const std::string& str)
+{
+  std::string distribution(str);
+  std::transform(
+      distribution.begin(), distribution.end(), distribution.begin(),
+      ::tolower);
+  if (distribution == "constant") {
+    return RequestRateManager::Distribution::CONSTANT;
+  } else if (distribution == "poisson") {
+    return RequestRateManager::Distribution::POISSON;
+  }
+
+  std::cerr << "unexpected request distribution \"" << str
+            << "\", expecting constant or poisson" << std::endl;
+  exit(1);
+
+  return RequestRateManager::Distribution::CONSTANT;
+}
+
+// Parse 'start[:end[:step]]' into the request rates to measure.
+bool
+ParseRequestRateRange(
+    const std::string& str, double* start, double* end, double* step)
+{
+  std::vector<double> values;
+  size_t pos = 0;
+  while (pos <= str.size()) {
+    size_t colon = str.find(':', pos);
+    if (colon == std::string::npos) {
+      colon = str.size();
+    }
+    const std::string value = str.substr(pos, colon - pos);
+    char* value_end = nullptr;
+    values.push_back(strtod(value.c_str(), &value_end));
+    if (value.empty() || (*value_end != '\0')) {
+      return false;
+    }
+    pos = colon + 1;
+  }
+
+  if (values.size() > 3) {
+    return false;
+  }
+
+  *start = values[0];
+  *end = (values.size() > 1) ? values[1] : *start;
+  *step = (values.size() > 2) ? values[2] : 1;
+  return (*start > 0) && (*end >= *start) && (*step > 0);
+}
+
+// Read the inter-arrival times in usec, one per line, from 'filename'.
+bool
+ReadRequestIntervals(
+    const std::string& filename, std::vector<uint64_t>* intervals_us)
+{
+  std::ifstream ifs(filename);
+  if (!ifs) {
+    return false;
+  }
+
+  uint64_t interval_us;
+  while (ifs >> interval_us) {
+    intervals_us->push_back(interval_us);
+  }
+
+  return ifs.eof() && !intervals_us->empty();
+}
+
 void
 Usage(char** argv, const std::string& msg = std::string())
 {
@@ -1640,6 +2243,10 @@ Usage(char** argv, const std::string& msg = std::string())
             << std::endl;
   std::cerr << "\t--sequence-length <length>" << std::endl;
   std::cerr << "\t--percentile <percentile>" << std::endl;
+  std::cerr << "\t--request-rate-range <start:end:step>" << std::endl;
+  std::cerr << "\t--request-distribution <constant|poisson>" << std::endl;
+  std::cerr << "\t--request-intervals <path to file of intervals in usec>"
+            << std::endl;
   std::cerr << std::endl;
   std::cerr
       << "The -d flag enables dynamic concurrent request count where the number"
@@ -1702,6 +2309,27 @@ Usage(char** argv, const std::string& msg = std::string())
       << " is stable instead of average latency."
       << " Default is -1 to indicate no percentile will be used or reported."
       << std::endl;
+  std::cerr
+      << "The --request-rate-range flag enables request rate mode, where"
+      << " requests are sent at a fixed rate without waiting for earlier"
+      << " responses and latency is measured from the time each request was"
+      << " scheduled to be sent. The rate starts at 'start' requests/sec and"
+      << " increases by 'step' until it exceeds 'end', the latency exceeds"
+      << " the threshold set by -l (if -l is > 0), or the throughput falls"
+      << " short of the request rate by more than the deviation threshold"
+      << " (see -s), which marks the saturation point of the server. 'end'"
+      << " defaults to 'start' and 'step' to 1. The requests are spread over"
+      << " --max-threads worker threads." << std::endl;
+  std::cerr
+      << "For --request-distribution, it indicates the distribution of the"
+      << " time between requests in request rate mode. Default is constant."
+      << std::endl;
+  std::cerr
+      << "For --request-intervals, it indicates a file with the time between"
+      << " requests in usec, one per line, that is replayed in a loop in"
+      << " request rate mode. If --request-rate-range is not set the trace"
+      << " is replayed at its recorded rate, otherwise the intervals are"
+      << " scaled to each request rate." << std::endl;
 
   exit(1);
 }
@@ -1732,12 +2360,22 @@ main(int argc, char** argv)
   std::string url("localhost:8000");
   std::string filename("");
   ProtocolType protocol = ProtocolType::HTTP;
+  bool request_rate_mode = false;
+  double request_rate_start = 0;
+  double request_rate_end = 0;
+  double request_rate_step = 0;
+  RequestRateManager::Distribution request_distribution =
+      RequestRateManager::Distribution::CONSTANT;
+  std::string request_intervals_file("");
 
   // {name, has_arg, *flag, val}
   static struct option long_options[] = {{"streaming", 0, 0, 0},
                                          {"max-threads", 1, 0, 1},
                                          {"sequence-length", 1, 0, 2},
                                          {"percentile", 1, 0, 3},
+                                         {"request-rate-range", 1, 0, 4},
+                                         {"request-distribution", 1, 0, 5},
+                                         {"request-intervals", 1, 0, 6},
                                          {0, 0, 0, 0}};
 
   // Parse commandline...
@@ -1758,6 +2396,22 @@ main(int argc, char** argv)
       case 3:
         percentile = std::atoi(optarg);
         break;
+      case 4:
+        request_rate_mode = true;
+        if (!ParseRequestRateRange(
+                optarg, &request_rate_start, &request_rate_end,
+                &request_rate_step)) {
+          Usage(argv, "request rate range must be 'start[:end[:step]]' with 0 "
+                      "< start <= end and step > 0");
+        }
+        break;
+      case 5:
+        request_distribution = ParseDistribution(optarg);
+        break;
+      case 6:
+        request_intervals_file = optarg;
+        request_distribution = RequestRateManager::Distribution::TRACE;
+        break;
       case 'v':
         verbose = true;
         break;
@@ -1846,13 +2500,24 @@ main(int argc, char** argv)
   if (percentile != -1 && (percentile > 99 || percentile < 1)) {
     Usage(argv, "percentile must be -1 for not reporting or in range (0, 100)");
   }
+  std::vector<uint64_t> request_intervals_us;
+  if (!request_intervals_file.empty()) {
+    if (!ReadRequestIntervals(request_intervals_file, &request_intervals_us)) {
+      Usage(argv, "unable to read request intervals from '" +
+                      request_intervals_file + "'");
+    }
+  }
+  if ((request_rate_mode || !request_intervals_file.empty()) &&
+      dynamic_concurrency_mode) {
+    Usage(argv, "request rate mode can not be combined with -d");
+  }
 
   // trap SIGINT to allow threads to exit gracefully
   signal(SIGINT, SignalHandler);
 
   nic::Error err;
   std::shared_ptr<ContextFactory> factory;
-  std::unique_ptr<ConcurrencyManager> manager;
+  std::unique_ptr<LoadManager> manager;
   std::unique_ptr<InferenceProfiler> profiler;
   err = ContextFactory::Create(
       url, protocol, streaming, model_name, model_version, &factory);
@@ -1860,8 +2525,26 @@ main(int argc, char** argv)
     std::cerr << err << std::endl;
     return 1;
   }
-  err = ConcurrencyManager::Create(
-      batch_size, max_threads, sequence_length, zero_input, factory, &manager);
+  if (!request_intervals_file.empty()) {
+    err = RequestRateManager::Create(
+        batch_size, max_threads, zero_input, request_distribution,
+        request_intervals_us, factory, &manager);
+    // Without a rate range the trace is replayed at its recorded rate.
+    if (err.IsOk() && !request_rate_mode) {
+      request_rate_mode = true;
+      request_rate_start = request_rate_end =
+          static_cast<RequestRateManager*>(manager.get())->TraceRequestRate();
+      request_rate_step = 1;
+    }
+  } else if (request_rate_mode) {
+    err = RequestRateManager::Create(
+        batch_size, max_threads, zero_input, request_distribution,
+        request_intervals_us, factory, &manager);
+  } else {
+    err = ConcurrencyManager::Create(
+        batch_size, max_threads, sequence_length, zero_input, factory,
+        &manager);
+  }
   if (!err.IsOk()) {
     std::cerr << err << std::endl;
     return 1;
@@ -1880,6 +2563,26 @@ main(int argc, char** argv)
             << "  Batch size: " << batch_size << std::endl
             << "  Measurement window: " << measurement_window_ms << " msec"
             << std::endl;
+  if (request_rate_mode) {
+    std::cout << "  Request rate: " << request_rate_start;
+    if (request_rate_end > request_rate_start) {
+      std::cout << " to " << request_rate_end << " by " << request_rate_step;
+    }
+    std::cout << " requests/sec" << std::endl;
+    if (!request_intervals_file.empty()) {
+      std::cout << "  Request intervals: " << request_intervals_file
+                << std::endl;
+    } else if (
+        request_distribution == RequestRateManager::Distribution::POISSON) {
+      std::cout << "  Request distribution: poisson" << std::endl;
+    } else {
+      std::cout << "  Request distribution: constant" << std::endl;
+    }
+    if (latency_threshold_ms > 0) {
+      std::cout << "  Latency limit: " << latency_threshold_ms << " msec"
+                << std::endl;
+    }
+  }
   if (dynamic_concurrency_mode) {
     std::cout << "  Latency limit: " << latency_threshold_ms << " msec"
               << std::endl;
@@ -1898,7 +2601,46 @@ main(int argc, char** argv)
 
   PerfStatus status_summary;
   std::vector<PerfStatus> summary;
-  if (!dynamic_concurrency_mode) {
+  if (request_rate_mode) {
+    // Increase the rate until the server stops keeping up with it, that
+    // is the throughput falls short of the rate by more than the
+    // stability threshold, or the latency limit is exceeded.
+    for (size_t step = 0;; step++) {
+      const double rate = request_rate_start + step * request_rate_step;
+      if (rate > request_rate_end * (1 + 1e-9)) {
+        break;
+      }
+      err = profiler->ProfileRequestRate(rate, status_summary);
+      if (!err.IsOk()) {
+        break;
+      }
+      err = Report(status_summary, 0, percentile, protocol, verbose);
+      summary.push_back(status_summary);
+      if (!err.IsOk()) {
+        break;
+      }
+
+      const double offered_infer_per_sec = rate * batch_size;
+      uint64_t reporting_latency_ms =
+          status_summary.reporting_latency_ns / (1000 * 1000);
+      if (status_summary.client_infer_per_sec <
+          offered_infer_per_sec * (1 - stable_offset)) {
+        std::cout << "Throughput " << status_summary.client_infer_per_sec
+                  << " infer/sec fell short of the offered "
+                  << offered_infer_per_sec << " infer/sec, the server is "
+                  << "saturated at request rate " << rate << std::endl
+                  << std::endl;
+        break;
+      }
+      if ((latency_threshold_ms > 0) &&
+          (reporting_latency_ms >= latency_threshold_ms)) {
+        std::cout << "Latency limit reached at request rate " << rate
+                  << std::endl
+                  << std::endl;
+        break;
+      }
+    }
+  } else if (!dynamic_concurrency_mode) {
     err = profiler->Profile(concurrent_request_count, status_summary);
     if (err.IsOk()) {
       err = Report(
@@ -1937,15 +2679,24 @@ main(int argc, char** argv)
     }
 
     for (PerfStatus& status : summary) {
-      std::cout << "Concurrency: " << status.concurrency << ", "
-                << status.client_infer_per_sec << " infer/sec, latency "
+      if (request_rate_mode) {
+        std::cout << "Request Rate: " << status.request_rate << ", ";
+      } else {
+        std::cout << "Concurrency: " << status.concurrency << ", ";
+      }
+      std::cout << status.client_infer_per_sec << " infer/sec, latency "
                 << (status.reporting_latency_ns / 1000) << " usec" << std::endl;
     }
 
     if (!filename.empty()) {
       std::ofstream ofs(filename, std::ofstream::out);
 
-      ofs << "Concurrency,Inferences/Second,Client Send,"
+      // In request rate mode the delay of the client in sending the
+      // requests on schedule is reported separately so that it isn't
+      // attributed to the network.
+      ofs << (request_rate_mode ? "Request Rate" : "Concurrency")
+          << ",Inferences/Second,"
+          << (request_rate_mode ? "Client Send Delay," : "") << "Client Send,"
           << "Network+Server Send/Recv,Server Queue,"
           << "Server Compute,Client Recv" << std::endl;
 
@@ -1963,10 +2714,19 @@ main(int argc, char** argv)
             status.server_compute_time_ns / status.server_request_count;
         uint64_t avg_network_misc_ns =
             status.client_avg_latency_ns - avg_queue_ns - avg_compute_ns -
-            status.client_avg_send_time_ns - status.client_avg_receive_time_ns;
+            status.client_avg_send_time_ns - status.client_avg_receive_time_ns -
+            status.client_avg_send_delay_ns;
 
-        ofs << status.concurrency << "," << status.client_infer_per_sec << ","
-            << (status.client_avg_send_time_ns / 1000) << ","
+        if (request_rate_mode) {
+          ofs << status.request_rate;
+        } else {
+          ofs << status.concurrency;
+        }
+        ofs << "," << status.client_infer_per_sec << ",";
+        if (request_rate_mode) {
+          ofs << (status.client_avg_send_delay_ns / 1000) << ",";
+        }
+        ofs << (status.client_avg_send_time_ns / 1000) << ","
             << (avg_network_misc_ns / 1000) << "," << (avg_queue_ns / 1000)
             << "," << (avg_compute_ns / 1000) << ","
             << (status.client_avg_receive_time_ns / 1000) << std::endl;
@@ -26,7 +26,9 @@
 
 #include "src/clients/c++/request_http.h"
 
+#include <ctype.h>
 #include <curl/curl.h>
+#include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/text_format.h>
 #include "src/clients/c++/request_common.h"
 
@@ -69,6 +71,58 @@ CurlGlobal::~CurlGlobal()
 
 static CurlGlobal curl_global;
 
+//==============================================================================
+
+// If the HTTP header in 'buf' is named 'name' then parse its
+// base64-encoded serialized protobuf value into 'msg' and set
+// 'matched' to true. Set 'matched' to false if the header is not
+// named 'name'. Return an error if the header is named 'name' but its
+// value can't be parsed.
+Error
+ParseBinaryHeader(
+    const char* buf, size_t byte_size, const char* name,
+    google::protobuf::Message* msg, bool* matched)
+{
+  size_t idx = strlen(name);
+  if ((idx >= byte_size) || strncasecmp(buf, name, idx) ||
+      (buf[idx] != ':')) {
+    *matched = false;
+    return Error::Success;
+  }
+
+  *matched = true;
+
+  // Skip the whitespace around the value, including the line
+  // terminator of the header.
+  const char* value = buf + idx + 1;
+  size_t value_size = byte_size - idx - 1;
+  while ((value_size > 0) && isspace(static_cast<unsigned char>(*value))) {
+    ++value;
+    --value_size;
+  }
+  while ((value_size > 0) &&
+         isspace(static_cast<unsigned char>(value[value_size - 1]))) {
+    --value_size;
+  }
+
+  std::string serialized;
+  if (!google::protobuf::Base64Unescape(
+          google::protobuf::StringPiece(value, value_size), &serialized)) {
+    msg->Clear();
+    return Error(
+        RequestStatusCode::INTERNAL,
+        "failed to decode base64 value of " + std::string(name) + " header");
+  }
+  if (!msg->ParseFromString(serialized)) {
+    msg->Clear();
+    return Error(
+        RequestStatusCode::INTERNAL,
+        "failed to parse value of " + std::string(name) + " header");
+  }
+
+  return Error::Success;
+}
+
 }  // namespace
 
 //==============================================================================
@@ -706,8 +760,6 @@ HttpRequestImpl::CreateResult(
 Error
 HttpRequestImpl::GetResults(InferContext::ResultMap* results)
 {
-  InferResponseHeader infer_response;
-
   if (http_status_ != CURLE_OK) {
     curl_slist_free_all(header_list_);
     ordered_results_.clear();
@@ -746,15 +798,27 @@ HttpRequestImpl::GetResults(InferContext::ResultMap* results)
     return Error(request_status_);
   }
 
-  // The infer response header should be available...
-  if (infer_response_buffer_.empty()) {
+  // The binary response header describes every output and the
+  // message at the end of the body holds only the classifications,
+  // which is empty if there are none, so merge those into the
+  // response header.
+  InferResponseHeader classifications;
+  if (!classifications.ParseFromString(infer_response_buffer_)) {
     ordered_results_.clear();
     return Error(
         RequestStatusCode::INTERNAL,
-        "infer request did not return result header");
+        "failed to parse infer response classifications");
   }
 
-  infer_response.ParseFromString(infer_response_buffer_);
+  for (auto& cls_output : *classifications.mutable_output()) {
+    for (auto& output : *response_header_.mutable_output()) {
+      if (output.name() == cls_output.name()) {
+        output.mutable_batch_classes()->Swap(
+            cls_output.mutable_batch_classes());
+        break;
+      }
+    }
+  }
 
   results->clear();
   for (auto& r : ordered_results_) {
@@ -762,7 +826,7 @@ HttpRequestImpl::GetResults(InferContext::ResultMap* results)
     results->insert(std::make_pair(name, std::move(r)));
   }
 
-  PostRunProcessing(infer_response, results);
+  PostRunProcessing(response_header_, results);
 
   return Error(request_status_);
 }
@@ -971,6 +1035,40 @@ InferHttpContextImpl::ResponseHeaderHandler(
   char* buf = reinterpret_cast<char*>(contents);
   size_t byte_size = size * nmemb;
   size_t idx;
+  bool matched;
+
+  // Binary status header. If the header can't be parsed then abort
+  // the transfer so that the request fails instead of reporting a
+  // missing status.
+  Error err = ParseBinaryHeader(
+      buf, byte_size, kStatusBinaryHTTPHeader, &request->request_status_,
+      &matched);
+  if (!err.IsOk()) {
+    std::cerr << "ResponseHeaderHandler: " << err << std::endl;
+    return 0;
+  }
+  if (matched) {
+    return byte_size;
+  }
+
+  // Binary response header
+  err = ParseBinaryHeader(
+      buf, byte_size, kInferResponseBinaryHTTPHeader,
+      &request->response_header_, &matched);
+  if (!err.IsOk()) {
+    std::cerr << "ResponseHeaderHandler: " << err << std::endl;
+    return 0;
+  }
+  if (matched) {
+    for (const auto& output : request->response_header_.output()) {
+      err = request->CreateResult(
+          *ctx, output, request->response_header_.batch_size());
+      if (!err.IsOk()) {
+        request->response_header_.Clear();
+      }
+    }
+    return byte_size;
+  }
 
   // Status header
   idx = strlen(kStatusHTTPHeader);
@@ -1050,7 +1148,9 @@ InferHttpContextImpl::PreRunProcessing(std::shared_ptr<Request>& request)
         RequestStatusCode::INTERNAL, "failed to initialize HTTP client");
   }
 
-  std::string full_url = url_ + "?format=binary";
+  // Request the response and status headers as binary protobufs
+  // since those are much cheaper than text for the server to produce.
+  std::string full_url = url_ + "?format=binary&header_format=binary";
   curl_easy_setopt(curl, CURLOPT_URL, full_url.c_str());
   curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
   curl_easy_setopt(curl, CURLOPT_POST, 1L);
@@ -144,8 +144,16 @@ InferenceBackend::Run(
     std::shared_ptr<InferResponseProvider> response_provider,
     std::function<void(Status)> OnCompleteHandleInfer)
 {
+  // Once the request completes record how much of its input had to
+  // be copied in host memory.
   scheduler_->Enqueue(
-      stats, request_provider, response_provider, OnCompleteHandleInfer);
+      stats, request_provider, response_provider,
+      [stats, request_provider, OnCompleteHandleInfer](Status status) {
+        if (stats != nullptr) {
+          stats->SetInputCopyByteSize(request_provider->InputCopyByteSize());
+        }
+        OnCompleteHandleInfer(status);
+      });
 }
 
 }}  // namespace nvidia::inferenceserver
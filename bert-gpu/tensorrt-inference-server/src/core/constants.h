@@ -32,6 +32,8 @@ namespace nvidia { namespace inferenceserver {
 constexpr char kInferRequestHTTPHeader[] = "NV-InferRequest";
 constexpr char kInferResponseHTTPHeader[] = "NV-InferResponse";
 constexpr char kStatusHTTPHeader[] = "NV-Status";
+constexpr char kInferResponseBinaryHTTPHeader[] = "NV-InferResponse-Bin";
+constexpr char kStatusBinaryHTTPHeader[] = "NV-Status-Bin";
 
 constexpr char kInferRESTEndpoint[] = "api/infer";
 constexpr char kStatusRESTEndpoint[] = "api/status";
@@ -65,6 +67,10 @@ constexpr uint64_t NANOS_PER_SECOND = 1000000000;
 constexpr int MAX_GRPC_MESSAGE_SIZE = INT32_MAX;
 constexpr int SCHEDULER_DEFAULT_NICE = 5;
 constexpr uint64_t SEQUENCE_IDLE_DEFAULT_MICROSECONDS = 1000 * 1000;
+constexpr uint32_t SCHEDULER_INCOMING_QUEUE_CAPACITY = 1024;
+constexpr uint32_t SCHEDULER_MAX_PRIORITY_LEVELS = 256;
+constexpr uint32_t SERVER_STATUS_STATS_SHARD_COUNT = 16;
+constexpr uint64_t GRPC_MAX_REUSED_OUTPUT_BYTE_SIZE = 4 * 1024 * 1024;
 
 #define DISALLOW_MOVE(TypeName) TypeName(Context&& o) = delete;
 #define DISALLOW_COPY(TypeName) TypeName(const TypeName&) = delete;
@@ -31,6 +31,7 @@
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
@@ -39,12 +40,31 @@
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Return the time, in nanoseconds, that 'payload' was enqueued.
+uint64_t
+EnqueueTimeNs(const Scheduler::Payload& payload)
+{
+  const struct timespec& queued = payload.queue_timer_->StartTimeStamp();
+  return queued.tv_sec * NANOS_PER_SECOND + queued.tv_nsec;
+}
+
+}  // namespace
+
 DynamicBatchScheduler::DynamicBatchScheduler(
     const ModelConfig& config, const uint32_t runner_cnt,
     StandardInitFunc OnInit, StandardRunFunc OnSchedule)
     : OnInit_(OnInit), OnSchedule_(OnSchedule),
       scheduler_thread_cnt_(runner_cnt), idle_scheduler_thread_cnt_(0),
-      pending_batch_size_(0), pending_batch_queue_cnt_(0)
+      wake_pending_(false),
+      queue_(
+          config.dynamic_batching().priority_levels(),
+          config.dynamic_batching().max_priority_queue_delay_microseconds() *
+              1000),
+      incoming_queue_(SCHEDULER_INCOMING_QUEUE_CAPACITY),
+      pending_batch_size_(0), pending_batch_queue_cnt_(0),
+      deadline_payload_cnt_(0)
 {
   dynamic_batching_enabled_ = config.has_dynamic_batching();
   scheduler_threads_exit_.store(false);
@@ -63,6 +83,11 @@ DynamicBatchScheduler::DynamicBatchScheduler(
   max_preferred_batch_size_ = 0;
   preferred_batch_sizes_.clear();
   pending_batch_delay_ns_ = 0;
+  latency_budget_ns_ = 0;
+  batch_by_shape_ = false;
+  priority_levels_ = 0;
+  default_priority_level_ = 0;
+  max_priority_queue_delay_ns_ = 0;
 
   if (dynamic_batching_enabled_) {
     for (const auto size : config.dynamic_batching().preferred_batch_size()) {
@@ -73,6 +98,30 @@ DynamicBatchScheduler::DynamicBatchScheduler(
 
     pending_batch_delay_ns_ =
         config.dynamic_batching().max_queue_delay_microseconds() * 1000;
+    batch_by_shape_ =
+        need_pending_shape_ && config.dynamic_batching().batch_by_shape();
+    latency_budget_ns_ =
+        config.dynamic_batching().latency_budget_microseconds() * 1000;
+
+    // A single priority level is the same as no priorities.
+    if (config.dynamic_batching().priority_levels() > 1) {
+      priority_levels_ = config.dynamic_batching().priority_levels();
+      default_priority_level_ =
+          (config.dynamic_batching().default_priority_level() == 0)
+              ? priority_levels_
+              : config.dynamic_batching().default_priority_level();
+      max_priority_queue_delay_ns_ =
+          config.dynamic_batching().max_priority_queue_delay_microseconds() *
+          1000;
+    }
+  }
+
+  compute_duration_stride_ =
+      std::max(config.max_batch_size(), (int32_t)1) + 1;
+  compute_duration_ns_.reset(
+      new std::atomic<uint64_t>[runner_cnt * compute_duration_stride_]);
+  for (size_t i = 0; i < (runner_cnt * compute_duration_stride_); ++i) {
+    compute_duration_ns_[i].store(0);
   }
 }
 
@@ -125,23 +174,86 @@ DynamicBatchScheduler::Enqueue(
       new ModelInferStats::ScopedTimer());
   stats->StartQueueTimer(queue_timer.get());
 
-  bool wake_runner = false;
-  {
+  // Add the request to the lock-free queue so that concurrent
+  // enqueuers don't serialize on 'mu_'. If that queue is full fall
+  // back to adding directly to 'queue_', draining the lock-free queue
+  // first so that requests stay in arrival order.
+  Scheduler::Payload payload(
+      queue_timer, stats, request_provider, response_provider, OnComplete);
+  if (!incoming_queue_.TryEnqueue(std::move(payload))) {
     std::lock_guard<std::mutex> lock(mu_);
-    queue_.emplace_back(
-        queue_timer, stats, request_provider, response_provider, OnComplete);
-
-    // If there are any idle runners then wake one up to service this
-    // request. We do the actual wake outside of the lock to avoid
-    // having the woken thread immediately block on the lock
-    wake_runner = (idle_scheduler_thread_cnt_ > 0);
+    DrainIncomingQueue();
+    InsertPayload(std::move(payload));
   }
 
-  if (wake_runner) {
+  // If there are any idle runners then wake one up to service this
+  // request. The fence pairs with the one in SchedulerThread() so
+  // that either the runner sees the new request before going idle or
+  // we see the runner as idle here. Acquiring 'mu_' before notifying
+  // makes sure an idle runner is actually waiting on 'cv_' so that
+  // the notification is not lost. Only the first enqueuer to see the
+  // idle runner does so, the woken runner drains the requests of the
+  // others. We do the actual wake outside of the lock to avoid having
+  // the woken thread immediately block on the lock.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if ((idle_scheduler_thread_cnt_.load() > 0) &&
+      !wake_pending_.exchange(true)) {
+    { std::lock_guard<std::mutex> lock(mu_); }
     cv_.notify_one();
   }
 }
 
+void
+DynamicBatchScheduler::DrainIncomingQueue()
+{
+  // 'mu_' mutex must be held when this function is called.
+  Scheduler::Payload payload;
+  while (incoming_queue_.TryDequeue(&payload)) {
+    InsertPayload(std::move(payload));
+  }
+}
+
+void
+DynamicBatchScheduler::InsertPayload(Scheduler::Payload&& payload)
+{
+  // 'mu_' mutex must be held when this function is called.
+  if (payload.request_provider_->DeadlineNs() != 0) {
+    deadline_payload_cnt_++;
+  }
+
+  // Priority levels start at 1 but the levels of 'queue_' start at
+  // 0. Without priority levels there is a single level.
+  const uint32_t level = (priority_levels_ == 0)
+                             ? 0
+                             : PriorityLevel(*payload.request_provider_) - 1;
+  queue_.Enqueue(level, std::move(payload));
+}
+
+Scheduler::Payload
+DynamicBatchScheduler::PopFront()
+{
+  // 'mu_' mutex must be held when this function is called. queue_
+  // must not be empty.
+  Scheduler::Payload payload(queue_.Dequeue());
+  if (payload.request_provider_->DeadlineNs() != 0) {
+    deadline_payload_cnt_--;
+  }
+
+  return payload;
+}
+
+uint32_t
+DynamicBatchScheduler::PriorityLevel(
+    const InferRequestProvider& request_provider) const
+{
+  const uint32_t priority = request_provider.RequestHeader().priority();
+  if (priority == 0) {
+    return default_priority_level_;
+  }
+
+  return std::min(priority, priority_levels_);
+}
+
 void
 DynamicBatchScheduler::SchedulerThread(const uint32_t runner_id, const int nice)
 {
@@ -178,29 +290,43 @@ DynamicBatchScheduler::SchedulerThread(const uint32_t runner_id, const int nice)
 
   while (!scheduler_threads_exit_.load()) {
     std::shared_ptr<std::vector<Scheduler::Payload>> payloads;
+    size_t batch_size = 0;
     bool wake_thread = false;
     uint64_t wait_microseconds = 0;
+    std::vector<Scheduler::Payload> expired_payloads;
 
     // Hold the lock for as short a time as possible.
     {
       std::unique_lock<std::mutex> lock(mu_);
+      DrainIncomingQueue();
+      RemoveExpiredPayloads(&expired_payloads);
+
+      // Requests that have waited longer than the maximum priority
+      // queue delay can no longer be passed by requests of higher
+      // priority.
+      if (max_priority_queue_delay_ns_ != 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        queue_.MoveDelayedToFront(now.tv_sec * NANOS_PER_SECOND + now.tv_nsec);
+      }
+
       if (delay_cnt > 0) {
         // Debugging/testing... wait until queue contains 'delay_cnt'
         // items...
         wait_microseconds = 10 * 1000;
-        if (queue_.size() >= delay_cnt) {
+        if (queue_.Size() >= delay_cnt) {
           delay_cnt = 0;
         }
-      } else if (queue_.empty()) {
+      } else if (queue_.Empty()) {
         wait_microseconds = default_wait_microseconds;
       } else if (dynamic_batching_enabled_) {
         // Use dynamic batching to get request payload(s) to execute.
-        wait_microseconds = GetDynamicBatch();
+        wait_microseconds = GetDynamicBatch(runner_id);
         if (wait_microseconds == 0) {
+          batch_size = pending_batch_size_;
           payloads = std::make_shared<std::vector<Scheduler::Payload>>();
           for (size_t idx = 0; idx < pending_batch_queue_cnt_; ++idx) {
-            payloads->emplace_back(std::move(queue_.front()));
-            queue_.pop_front();
+            payloads->emplace_back(PopFront());
           }
 
           pending_batch_size_ = 0;
@@ -216,22 +342,33 @@ DynamicBatchScheduler::SchedulerThread(const uint32_t runner_id, const int nice)
           // handling those requests. We do the actual wake outside of
           // the lock to avoid having the woken thread immediately
           // block on the lock.
-          wake_thread = !queue_.empty() && (idle_scheduler_thread_cnt_ > 0);
+          wake_thread = (!queue_.Empty() || !incoming_queue_.Empty()) &&
+                        (idle_scheduler_thread_cnt_ > 0);
         }
       } else {
         // No batching... execute next request payload
+        batch_size =
+            queue_.At(0).request_provider_->RequestHeader().batch_size();
         payloads = std::make_shared<std::vector<Scheduler::Payload>>();
-        payloads->emplace_back(std::move(queue_.front()));
-        queue_.pop_front();
+        payloads->emplace_back(PopFront());
       }
 
       // If no requests are to be handled, wait for notification or
-      // for the specified timeout before checking the queue again.
-      if (wait_microseconds > 0) {
+      // for the specified timeout before checking the queue again. A
+      // request may have been added to the lock-free queue since it
+      // was drained above, so check again after marking this thread
+      // idle (see Enqueue()) and skip the wait if so. Don't wait if
+      // there are expired payloads that must be completed.
+      if ((wait_microseconds > 0) && expired_payloads.empty()) {
+        wake_pending_.store(false);
         idle_scheduler_thread_cnt_++;
-        std::chrono::microseconds wait_timeout(wait_microseconds);
-        cv_.wait_for(lock, wait_timeout);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (incoming_queue_.Empty()) {
+          std::chrono::microseconds wait_timeout(wait_microseconds);
+          cv_.wait_for(lock, wait_timeout);
+        }
         idle_scheduler_thread_cnt_--;
+        wake_pending_.store(false);
       }
     }
 
@@ -239,8 +376,32 @@ DynamicBatchScheduler::SchedulerThread(const uint32_t runner_id, const int nice)
       cv_.notify_one();
     }
 
+    for (auto& payload : expired_payloads) {
+      payload.CompleteTimedOut();
+    }
+
     if ((payloads != nullptr) && !payloads->empty()) {
-      auto OnCompleteQueuedPayloads = [payloads](Status status) {
+      // If there is a latency budget record how long the batch takes
+      // to execute so that the budget can be applied to later
+      // batches.
+      uint64_t start_ns = 0;
+      if (latency_budget_ns_ != 0) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        start_ns = start.tv_sec * NANOS_PER_SECOND + start.tv_nsec;
+      }
+
+      auto OnCompleteQueuedPayloads = [this, runner_id, batch_size, start_ns,
+                                       payloads](Status status) {
+        if ((start_ns != 0) && status.IsOk()) {
+          struct timespec end;
+          clock_gettime(CLOCK_MONOTONIC, &end);
+          const uint64_t end_ns = end.tv_sec * NANOS_PER_SECOND + end.tv_nsec;
+          RecordComputeDuration(
+              runner_id, batch_size,
+              (start_ns > end_ns) ? 0 : end_ns - start_ns);
+        }
+
         bool found_success = false;
         for (auto& payload : *payloads) {
           Status final_status = status.IsOk() ? payload.status_ : status;
@@ -268,6 +429,38 @@ DynamicBatchScheduler::SchedulerThread(const uint32_t runner_id, const int nice)
                  << "...";
 }
 
+void
+DynamicBatchScheduler::RemoveExpiredPayloads(
+    std::vector<Scheduler::Payload>* expired_payloads)
+{
+  // 'mu_' mutex must be held when this function is called. Only scan
+  // the queue if some queued request has a deadline.
+  if (deadline_payload_cnt_ == 0) {
+    return;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_ns = now.tv_sec * NANOS_PER_SECOND + now.tv_nsec;
+
+  const size_t prev_expired_cnt = expired_payloads->size();
+  const size_t first_expired_idx = queue_.RemoveIf(
+      [now_ns](const Scheduler::Payload& payload) {
+        const InferRequestProvider& provider = *payload.request_provider_;
+        return (provider.DeadlineNs() != 0) && provider.IsExpired(now_ns);
+      },
+      expired_payloads);
+  deadline_payload_cnt_ -= expired_payloads->size() - prev_expired_cnt;
+
+  // If an expired payload was part of the pending batch then the
+  // pending batch must be formed again from the front of the queue.
+  if (first_expired_idx < pending_batch_queue_cnt_) {
+    pending_batch_size_ = 0;
+    pending_batch_queue_cnt_ = 0;
+    pending_batch_shapes_.clear();
+  }
+}
+
 void
 DynamicBatchScheduler::InitPendingShape(const InferRequestHeader& request)
 {
@@ -300,8 +493,61 @@ DynamicBatchScheduler::CompareWithPendingShape(
   return true;
 }
 
+void
+DynamicBatchScheduler::RecordComputeDuration(
+    const uint32_t runner_id, const size_t batch_size,
+    const uint64_t duration_ns)
+{
+  if ((batch_size == 0) || (batch_size >= compute_duration_stride_)) {
+    return;
+  }
+
+  // Only 'runner_id' executes batches for its entries so updates are
+  // rarely concurrent (only when a backend completes batches
+  // asynchronously, in which case a racing update just drops one
+  // sample), but the entries are read by other runners while forming
+  // batches.
+  std::atomic<uint64_t>& avg_ns =
+      compute_duration_ns_[runner_id * compute_duration_stride_ + batch_size];
+  const uint64_t prev_ns = avg_ns.load();
+  avg_ns.store(
+      (prev_ns == 0) ? std::max(duration_ns, (uint64_t)1)
+                     : ((prev_ns * 7) + duration_ns) / 8);
+}
+
 uint64_t
-DynamicBatchScheduler::GetDynamicBatch()
+DynamicBatchScheduler::EstimatedComputeDuration(
+    const uint32_t runner_id, const size_t batch_size) const
+{
+  const std::atomic<uint64_t>* avg_ns =
+      &compute_duration_ns_[runner_id * compute_duration_stride_];
+  const size_t bs = std::min(batch_size, compute_duration_stride_ - 1);
+  if (bs == 0) {
+    return 0;
+  }
+
+  // Use the smallest observed batch size that is at least
+  // 'batch_size'. If there isn't one then extrapolate linearly from
+  // the largest observed batch size smaller than 'batch_size'.
+  for (size_t idx = bs; idx < compute_duration_stride_; ++idx) {
+    const uint64_t ns = avg_ns[idx].load();
+    if (ns != 0) {
+      return ns;
+    }
+  }
+
+  for (size_t idx = bs - 1; idx > 0; --idx) {
+    const uint64_t ns = avg_ns[idx].load();
+    if (ns != 0) {
+      return ns * bs / idx;
+    }
+  }
+
+  return 0;
+}
+
+uint64_t
+DynamicBatchScheduler::GetDynamicBatch(const uint32_t runner_id)
 {
   // 'mu_' mutex must be held when this function is called. queue_
   // must not be empty.
@@ -310,24 +556,70 @@ DynamicBatchScheduler::GetDynamicBatch()
   // pending batch allows a preferred batch size then execute it
   // immediately. Stop examining requests if the maximum preferred
   // batch size would be exceeded or if the shape of the next request
-  // does not match the shape of the pending batch.
+  // does not match the shape of the pending batch. If batching by
+  // shape, requests that don't match the shape of the pending batch
+  // are instead skipped, and any later matching request is moved
+  // forward in the queue so that the pending batch is always the
+  // first 'pending_batch_queue_cnt_' requests in the queue. If there
+  // is a latency budget also stop examining requests if the larger
+  // batch is not expected to complete within the budget of the
+  // oldest request in the batch.
+  //
+  // The queue delay of a batch is the delay of its oldest request.
+  // With priority levels that is not necessarily the request at the
+  // front of the queue, so track the earliest enqueue time of the
+  // requests in the batch.
+  uint64_t now_ns = 0;
+  uint64_t oldest_enqueue_ns = 0;
+  if ((latency_budget_ns_ != 0) || (pending_batch_delay_ns_ != 0)) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    now_ns = now.tv_sec * NANOS_PER_SECOND + now.tv_nsec;
+    oldest_enqueue_ns = now_ns;
+    for (size_t idx = 0; idx < pending_batch_queue_cnt_; ++idx) {
+      oldest_enqueue_ns =
+          std::min(oldest_enqueue_ns, EnqueueTimeNs(queue_.At(idx)));
+    }
+  }
+
   bool send_now = false;
   size_t best_preferred_batch_size = 0;
   size_t best_preferred_batch_cnt = 0;
   size_t search_batch_size = pending_batch_size_;
   size_t search_batch_cnt = pending_batch_queue_cnt_;
-  for (auto idx = pending_batch_queue_cnt_; idx < queue_.size(); ++idx) {
+  for (auto idx = pending_batch_queue_cnt_; idx < queue_.Size(); ++idx) {
     const auto batch_size =
-        queue_[idx].request_provider_->RequestHeader().batch_size();
+        queue_.At(idx).request_provider_->RequestHeader().batch_size();
+
+    // The enqueue time of the oldest request in the batch if this
+    // request is added to it.
+    const uint64_t enqueue_ns =
+        (now_ns == 0)
+            ? 0
+            : std::min(oldest_enqueue_ns, EnqueueTimeNs(queue_.At(idx)));
 
     // If there is no pending batch, then this request is starting a
     // new batch.
     if (search_batch_cnt == 0) {
       // Get the shape of the new batch that is being started...
       if (need_pending_shape_) {
-        InitPendingShape(queue_[idx].request_provider_->RequestHeader());
+        InitPendingShape(queue_.At(idx).request_provider_->RequestHeader());
       }
     } else {
+      // There is a pending batch and it has a different shape then
+      // this request, so send the pending batch as it is, or leave
+      // this request in the queue if batching by shape.
+      if (need_pending_shape_ &&
+          !CompareWithPendingShape(
+              queue_.At(idx).request_provider_->RequestHeader())) {
+        if (batch_by_shape_) {
+          continue;
+        }
+
+        send_now = true;
+        break;
+      }
+
       // There is a pending batch and adding this request would make
       // the batch size too large, so send the pending batch as it is.
       if ((search_batch_size + batch_size) > max_preferred_batch_size_) {
@@ -335,18 +627,30 @@ DynamicBatchScheduler::GetDynamicBatch()
         break;
       }
 
-      // There is a pending batch and it has a different shape then
-      // this request, so send the pending batch as it is.
-      if (need_pending_shape_ &&
-          !CompareWithPendingShape(
-              queue_[idx].request_provider_->RequestHeader())) {
-        send_now = true;
-        break;
+      // There is a pending batch and adding this request would make
+      // the batch take too long to compute, so send the pending batch
+      // as it is.
+      if (latency_budget_ns_ != 0) {
+        const uint64_t queue_delay_ns =
+            (enqueue_ns > now_ns) ? 0 : now_ns - enqueue_ns;
+        const uint64_t compute_ns = EstimatedComputeDuration(
+            runner_id, search_batch_size + batch_size);
+        if ((queue_delay_ns + compute_ns) > latency_budget_ns_) {
+          send_now = true;
+          break;
+        }
       }
     }
 
+    // Move the request to the front of the queue so that it
+    // immediately follows the requests already in the batch, and so
+    // that requests of higher priority that arrive later can't pass
+    // it.
+    queue_.MoveToFront(idx, search_batch_cnt);
+
     search_batch_size += batch_size;
     search_batch_cnt++;
+    oldest_enqueue_ns = enqueue_ns;
 
     if (preferred_batch_sizes_.find(search_batch_size) !=
         preferred_batch_sizes_.end()) {
@@ -372,11 +676,34 @@ DynamicBatchScheduler::GetDynamicBatch()
     return 0;
   }
 
-  // If there is no batch queuing delay or if the current batch can't
-  // grow any larger then just immediately execute whatever is
-  // pending.
-  if (send_now || (pending_batch_delay_ns_ == 0) ||
-      (pending_batch_size_ >= max_preferred_batch_size_)) {
+  // If the current batch can't grow any larger then just immediately
+  // execute whatever is pending.
+  if (send_now || (pending_batch_size_ >= max_preferred_batch_size_)) {
+    return 0;
+  }
+
+  // If there is a latency budget and the execution time of a larger
+  // batch can be estimated then delay only as long as a batch of the
+  // maximum preferred size could still complete within the budget of
+  // the oldest pending request.
+  const uint64_t queue_delay_ns =
+      (oldest_enqueue_ns > now_ns) ? 0 : now_ns - oldest_enqueue_ns;
+  uint64_t budget_wait_ns = 0;
+  if (latency_budget_ns_ != 0) {
+    const uint64_t compute_ns =
+        EstimatedComputeDuration(runner_id, max_preferred_batch_size_);
+    if (compute_ns != 0) {
+      if ((queue_delay_ns + compute_ns) >= latency_budget_ns_) {
+        return 0;
+      }
+
+      budget_wait_ns = latency_budget_ns_ - queue_delay_ns - compute_ns;
+    }
+  }
+
+  // If there is no batch queuing delay and no latency budget delay
+  // then just immediately execute whatever is pending.
+  if ((pending_batch_delay_ns_ == 0) && (budget_wait_ns == 0)) {
     return 0;
   }
 
@@ -384,14 +711,15 @@ DynamicBatchScheduler::GetDynamicBatch()
   // batch queuing delay and execute now if queuing delay is
   // exceeded. If queuing delay not exceeded create a timer to wakeup
   // a thread to check again at the maximum allowed delay.
-  struct timespec now;
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  const struct timespec& queued = queue_.front().queue_timer_->StartTimeStamp();
-  uint64_t delay_ns = (now.tv_sec * NANOS_PER_SECOND + now.tv_nsec) -
-                      (queued.tv_sec * NANOS_PER_SECOND + queued.tv_nsec);
+  uint64_t wait_ns = budget_wait_ns;
+  if (pending_batch_delay_ns_ != 0) {
+    if (queue_delay_ns >= pending_batch_delay_ns_) {
+      return 0;
+    }
 
-  if (delay_ns >= pending_batch_delay_ns_) {
-    return 0;
+    const uint64_t delay_wait_ns = pending_batch_delay_ns_ - queue_delay_ns;
+    wait_ns =
+        (wait_ns == 0) ? delay_wait_ns : std::min(wait_ns, delay_wait_ns);
   }
 
   // Return non-zero wait microseconds to cause this thread to wait
@@ -401,7 +729,7 @@ DynamicBatchScheduler::GetDynamicBatch()
   // then this thread will wake and revisit the pending batch (and at
   // that time will then see the delay has been exceeded and will send
   // the batch).
-  return (pending_batch_delay_ns_ - delay_ns) / 1000;
+  return wait_ns / 1000;
 }
 
 }}  // namespace nvidia::inferenceserver
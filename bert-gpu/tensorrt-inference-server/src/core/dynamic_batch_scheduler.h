@@ -27,11 +27,13 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include "src/core/api.pb.h"
+#include "src/core/lockfree_queue.h"
 #include "src/core/model_config.pb.h"
+#include "src/core/priority_queue.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
 
@@ -61,9 +63,19 @@ class DynamicBatchScheduler : public Scheduler {
       const ModelConfig& config, const uint32_t runner_cnt,
       StandardInitFunc OnInit, StandardRunFunc OnSchedule);
   void SchedulerThread(const uint32_t runner_id, const int nice);
+  void DrainIncomingQueue();
+  void InsertPayload(Scheduler::Payload&& payload);
+  Scheduler::Payload PopFront();
+  uint32_t PriorityLevel(const InferRequestProvider& request_provider) const;
+  void RemoveExpiredPayloads(std::vector<Scheduler::Payload>* expired_payloads);
   void InitPendingShape(const InferRequestHeader& request);
   bool CompareWithPendingShape(const InferRequestHeader& request) const;
-  uint64_t GetDynamicBatch();
+  uint64_t GetDynamicBatch(const uint32_t runner_id);
+  void RecordComputeDuration(
+      const uint32_t runner_id, const size_t batch_size,
+      const uint64_t duration_ns);
+  uint64_t EstimatedComputeDuration(
+      const uint32_t runner_id, const size_t batch_size) const;
 
   // Function the scheduler will call to initialize a runner.
   const StandardInitFunc OnInit_;
@@ -75,8 +87,17 @@ class DynamicBatchScheduler : public Scheduler {
   // The number of scheduler threads.
   const uint32_t scheduler_thread_cnt_;
 
-  // The number of scheduler threads currently idle.
-  uint32_t idle_scheduler_thread_cnt_;
+  // The number of scheduler threads currently idle. Only modified
+  // while holding 'mu_' but read without the lock by Enqueue() to
+  // decide if a runner must be woken.
+  std::atomic<uint32_t> idle_scheduler_thread_cnt_;
+
+  // True if an Enqueue() has claimed the wake of an idle scheduler
+  // thread that has not yet woken. Other enqueuers then skip the
+  // wake, so that at most one of them acquires 'mu_' for each time a
+  // scheduler thread goes idle. Cleared by the scheduler threads
+  // whenever they go idle or wake.
+  std::atomic<bool> wake_pending_;
 
   // True if dynamic batching is enabled.
   bool dynamic_batching_enabled_;
@@ -86,8 +107,14 @@ class DynamicBatchScheduler : public Scheduler {
   std::condition_variable cv_;
 
   // Queue holding inference requests for the model represented by
-  // this servable.
-  std::deque<Scheduler::Payload> queue_;
+  // this servable, with one level for each priority level. The
+  // pending batch is always at the front, ahead of all levels.
+  PriorityQueue queue_;
+
+  // Lock-free queue that Enqueue() pushes new requests into without
+  // acquiring 'mu_'. Scheduler threads move the requests from here
+  // into 'queue_', while holding 'mu_', before forming batches.
+  LockFreeQueue<Scheduler::Payload> incoming_queue_;
 
   std::vector<std::unique_ptr<std::thread>> scheduler_threads_;
   std::atomic<bool> scheduler_threads_exit_;
@@ -95,11 +122,31 @@ class DynamicBatchScheduler : public Scheduler {
   size_t max_preferred_batch_size_;
   std::set<int32_t> preferred_batch_sizes_;
   uint64_t pending_batch_delay_ns_;
+  uint64_t latency_budget_ns_;
   size_t pending_batch_size_;
   size_t pending_batch_queue_cnt_;
 
+  // The number of requests in 'queue_' that have a deadline. Expired
+  // requests are only searched for if there are any.
+  size_t deadline_payload_cnt_;
+
   bool need_pending_shape_;
+  bool batch_by_shape_;
   std::unordered_map<std::string, DimsList> pending_batch_shapes_;
+
+  // Priority levels of requests, or 0 if requests are queued in
+  // arrival order.
+  uint32_t priority_levels_;
+  uint32_t default_priority_level_;
+  uint64_t max_priority_queue_delay_ns_;
+
+  // Moving average of the observed execution duration, in
+  // nanoseconds, of each batch size on each runner. Indexed by
+  // 'runner_id * compute_duration_stride_ + batch_size'. Zero
+  // indicates that the batch size has not been observed for that
+  // runner.
+  size_t compute_duration_stride_;
+  std::unique_ptr<std::atomic<uint64_t>[]> compute_duration_ns_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -26,9 +26,13 @@
 
 #include "src/core/ensemble_scheduler.h"
 
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
 #include "src/core/api.pb.h"
 #include "src/core/backend.h"
+#include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/provider_utils.h"
 #include "src/core/server.h"
@@ -51,6 +55,42 @@ struct Step {
   size_t step_idx_;
 };
 
+// SystemMemoryBlock references a single block of the data of another
+// SystemMemory, keeping that data alive.
+class SystemMemoryBlock : public SystemMemory {
+ public:
+  SystemMemoryBlock(
+      const std::shared_ptr<SystemMemory>& parent, const char* block,
+      size_t byte_size)
+      : parent_(parent), block_(block)
+  {
+    total_byte_size_ = byte_size;
+  }
+
+  //\see SystemMemory::BufferAt()
+  const char* BufferAt(size_t idx, size_t* byte_size) const override
+  {
+    if (idx != 0) {
+      *byte_size = 0;
+      return nullptr;
+    }
+    *byte_size = total_byte_size_;
+    return block_;
+  }
+
+ private:
+  std::shared_ptr<SystemMemory> parent_;
+  const char* block_;
+};
+
+uint64_t
+MonotonicNowNs()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * NANOS_PER_SECOND + now.tv_nsec;
+}
+
 // EnsembleContext maintains the state of the ensemble request
 //
 // Using static functions to take advantage of shared_ptr, a copy of the
@@ -75,6 +115,20 @@ class EnsembleContext {
       const std::shared_ptr<EnsembleContext>& context,
       const std::shared_ptr<Step>& completed_step = nullptr);
 
+  // Steps from different ensemble requests, each with the context of
+  // the request.
+  using BatchedStepList = std::vector<
+      std::pair<std::shared_ptr<EnsembleContext>, std::shared_ptr<Step>>>;
+
+  // Return true if steps 'lhs' and 'rhs' can be executed in the same
+  // request to their model.
+  static bool CanBatchTogether(const Step& lhs, const Step& rhs);
+
+  // Call the inference server's function to execute the 'batched'
+  // steps as a single infer request, and proceed each ensemble request
+  // once the request completes.
+  static void ScheduleBatchedSteps(const BatchedStepList& batched);
+
  private:
   using StepList = std::vector<std::shared_ptr<Step>>;
   using VersionMap = std::unordered_map<
@@ -90,6 +144,27 @@ class EnsembleContext {
   static void ScheduleSteps(
       const std::shared_ptr<EnsembleContext>& context, const StepList& steps);
 
+  // Prepare infer stats and call the inference server's function to
+  // process the infer request specified in 'step'
+  static void ScheduleStep(
+      const std::shared_ptr<EnsembleContext>& context,
+      const std::shared_ptr<Step>& step);
+
+  // Helper function that initializes the 'batch_step' whose request
+  // combines the requests of the 'batched' steps.
+  static Status InitBatchedStep(
+      const BatchedStepList& batched, std::shared_ptr<Step>* batch_step);
+
+  // Helper function that gives each of the 'batched' steps the status
+  // and its slice of the outputs of 'batch_step', and then proceeds
+  // each ensemble request.
+  static void CompleteBatchedSteps(
+      const BatchedStepList& batched, const std::shared_ptr<Step>& batch_step);
+
+  // Return true if 'step' may be combined with the same step of other
+  // ensemble requests.
+  bool IsBatchableStep(const Step& step) const;
+
   // Helper function that updates ensemble state given 'completed_step' and
   // returns the list of updated tensors in 'updated_tensors'
   Status UpdateEnsembleState(
@@ -114,6 +189,20 @@ class EnsembleContext {
   // Return error if some of the required outputs are not set (deadlock)
   Status CheckAndSetEnsembleOutput();
 
+  // Helper function that allocates the buffer for a step output in the
+  // ensemble response, so that the step writes the ensemble output
+  // 'output_name' in place. 'step_batching' indicates if
+  // 'content_shape' includes the batch dimension. Sets 'allocated' to
+  // false if the buffer must be allocated by the step instead.
+  Status AllocateEnsembleOutput(
+      const std::string& output_name, size_t tensor_idx, bool step_batching,
+      size_t content_byte_size, const std::vector<int64_t>& content_shape,
+      void** content, bool* allocated);
+
+  // Helper function that releases the ensemble's reference to the data
+  // of the tensor at 'tensor_idx'.
+  void ReleaseTensor(size_t tensor_idx);
+
   InferenceServer* is_;
 
   EnsembleInfo* info_;
@@ -129,6 +218,33 @@ class EnsembleContext {
       std::pair<InferRequestHeader::Input, std::shared_ptr<SystemMemory>>>
       tensor_data_;
 
+  // For each tensor, the number of step inputs using it that have not
+  // completed yet. An intermediate tensor is released when this
+  // reaches zero.
+  std::vector<size_t> tensor_consumer_cnt_;
+
+  // For each tensor, the bytes held by the ensemble for its data. Zero
+  // for ensemble inputs and for outputs written in place into the
+  // ensemble response.
+  std::vector<size_t> tensor_byte_size_;
+
+  // The bytes currently held for tensors produced by the steps, and
+  // the most held at any one time.
+  size_t held_byte_size_;
+  size_t peak_held_byte_size_;
+
+  // Tensors that were allocated directly in the ensemble response by
+  // the step that produced them.
+  std::set<size_t> forwarded_tensors_;
+
+  // The number of tensors in 'forwarded_tensors_' whose step is still
+  // in flight, and so may still be writing into the ensemble response.
+  // The response is not completed until this reaches zero.
+  size_t inflight_forwarded_cnt_;
+
+  // Whether the ensemble response has been completed.
+  bool finished_;
+
   // Handle to all backend that may be used in the ensemble
   std::unordered_map<std::string, VersionMap> handles_;
 
@@ -137,6 +253,7 @@ class EnsembleContext {
   uint32_t flags_;
   uint64_t correlation_id_;
   uint32_t batch_size_;
+  uint32_t priority_;
 
   // Objects related to the ensemble infer request
   Status ensemble_status_;
@@ -149,6 +266,71 @@ class EnsembleContext {
   std::unordered_map<size_t, std::string> no_label_tensors_;
 };
 
+}  // namespace
+
+// EnsembleStepBatcher holds the ready steps of ensemble requests for up
+// to a delay so that the same step of different ensemble requests can
+// be executed as a single request to the step's model.
+class EnsembleStepBatcher {
+ public:
+  explicit EnsembleStepBatcher(uint64_t delay_microseconds);
+  ~EnsembleStepBatcher();
+
+  // Hold 'step' of the ensemble request 'context' until it is
+  // scheduled, combined with the other held steps that have the same
+  // step index where possible.
+  void Enqueue(
+      const std::shared_ptr<EnsembleContext>& context,
+      const std::shared_ptr<Step>& step);
+
+ private:
+  struct HeldStep {
+    std::shared_ptr<EnsembleContext> context_;
+    std::shared_ptr<Step> step_;
+    uint64_t enqueue_ns_;
+  };
+
+  struct StepQueue {
+    StepQueue() : batch_size_(0), max_batch_size_(0) {}
+
+    std::deque<HeldStep> steps_;
+
+    // The total batch size of the held steps, and the maximum batch
+    // size of the step's model.
+    size_t batch_size_;
+    size_t max_batch_size_;
+  };
+
+  // The state shared with the batcher thread. Completing a step on the
+  // batcher thread may release the last reference to the ensemble and
+  // so destroy the batcher, in which case the thread keeps the state
+  // alive until it exits.
+  struct State {
+    explicit State(uint64_t delay_ns) : delay_ns_(delay_ns), exit_(false) {}
+
+    const uint64_t delay_ns_;
+
+    // Mutex and condvar protecting the held steps.
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool exit_;
+
+    // The held steps for each step index.
+    std::unordered_map<size_t, StepQueue> queues_;
+  };
+
+  static void BatcherThread(const std::shared_ptr<State>& state);
+
+  // Schedule the 'held' steps, which all have the same step index,
+  // combining the steps that can be executed together.
+  static void ScheduleHeldSteps(std::deque<HeldStep>&& held);
+
+  std::shared_ptr<State> state_;
+  std::unique_ptr<std::thread> batcher_thread_;
+};
+
+namespace {
+
 EnsembleContext::EnsembleContext(
     InferenceServer* is, EnsembleInfo* info,
     const std::shared_ptr<ModelInferStats>& stats,
@@ -156,7 +338,11 @@ EnsembleContext::EnsembleContext(
     const std::shared_ptr<InferResponseProvider>& response_provider,
     std::function<void(Status)> OnComplete)
     : is_(is), info_(info), inflight_step_counter_(0),
-      tensor_data_(info_->tensor_to_step_.size()), stats_(stats),
+      tensor_data_(info_->tensor_to_step_.size()),
+      tensor_consumer_cnt_(info_->tensor_consumer_cnt_),
+      tensor_byte_size_(info_->tensor_to_step_.size(), 0), held_byte_size_(0),
+      peak_held_byte_size_(0), inflight_forwarded_cnt_(0), finished_(false),
+      stats_(stats),
       request_provider_(request_provider),
       response_provider_(response_provider), OnComplete_(OnComplete)
 {
@@ -188,6 +374,7 @@ EnsembleContext::EnsembleContext(
     batch_size_ = request_header.batch_size();
     correlation_id_ = request_header.correlation_id();
     flags_ = request_header.flags();
+    priority_ = request_header.priority();
 
     for (const auto& input : request_header.input()) {
       auto it = info_->ensemble_input_to_tensor_.find(input.name());
@@ -235,9 +422,16 @@ EnsembleContext::PrepareSteps(
   {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    // Initialization error, ensemble status will be not ok since the beginning
-    if (completed_step == nullptr && !ensemble_status_.IsOk()) {
-      ensemble_status_ = FinishEnsemble();
+    // The completed step no longer writes the outputs it allocated in
+    // the ensemble response.
+    if (completed_step != nullptr) {
+      for (const auto& pair :
+           info_->steps_[completed_step->step_idx_].output_to_tensor_) {
+        if (forwarded_tensors_.find(pair.second) !=
+            forwarded_tensors_.end()) {
+          inflight_forwarded_cnt_--;
+        }
+      }
     }
 
     if (ensemble_status_.IsOk()) {
@@ -247,13 +441,22 @@ EnsembleContext::PrepareSteps(
       if (ensemble_status_.IsOk()) {
         ensemble_status_ = GetNextSteps(updated_tensors, res);
       }
-      // Error or no more progress (completed or deadlock)
-      // in either case, FinishEnsemble() won't be called again
-      if ((!ensemble_status_.IsOk()) || (inflight_step_counter_ == 0)) {
-        ensemble_status_ = FinishEnsemble();
-      } else {
+      if (ensemble_status_.IsOk() && (inflight_step_counter_ != 0)) {
         ready_steps.swap(res);
       }
+    } else if (completed_step != nullptr) {
+      // A step that was in flight when the ensemble failed.
+      inflight_step_counter_--;
+    }
+
+    // Error or no more progress (completed or deadlock). After an error
+    // the response is only completed once no in-flight step can still
+    // write into it, since the response may be reused for another
+    // request as soon as it is completed.
+    if (!finished_ &&
+        ((!ensemble_status_.IsOk()) || (inflight_step_counter_ == 0)) &&
+        (inflight_forwarded_cnt_ == 0)) {
+      ensemble_status_ = FinishEnsemble();
     }
     return ensemble_status_;
   }
@@ -297,6 +500,17 @@ EnsembleContext::UpdateEnsembleState(
                 it->first, &(tensor_data.second)));
             updated_tensors.push_back(it->second);
 
+            // Outputs that were written into the ensemble response are
+            // not held by the ensemble.
+            if (forwarded_tensors_.find(it->second) ==
+                forwarded_tensors_.end()) {
+              tensor_byte_size_[it->second] =
+                  tensor_data.second->TotalByteSize();
+              held_byte_size_ += tensor_byte_size_[it->second];
+              peak_held_byte_size_ =
+                  std::max(peak_held_byte_size_, held_byte_size_);
+            }
+
             auto tensor_it = no_label_tensors_.find(it->second);
             if (tensor_it != no_label_tensors_.end()) {
               // Check the inner model's lookup map first in case it is also an
@@ -330,11 +544,41 @@ EnsembleContext::UpdateEnsembleState(
                   "' as raw data instead of classification result");
         }
       }
+
+      // Release the tensors that are no longer needed by any step. A
+      // produced tensor that no step uses is released right away.
+      for (const auto& input_pair : info_->steps_[step_idx].input_to_tensor_) {
+        if (--tensor_consumer_cnt_[input_pair.second] == 0) {
+          ReleaseTensor(input_pair.second);
+        }
+      }
+      for (const auto& output_pair :
+           info_->steps_[step_idx].output_to_tensor_) {
+        if (tensor_consumer_cnt_[output_pair.second] == 0) {
+          ReleaseTensor(output_pair.second);
+        }
+      }
     }
   }
   return Status::Success;
 }
 
+void
+EnsembleContext::ReleaseTensor(size_t tensor_idx)
+{
+  // Ensemble outputs are needed to form the response.
+  if (info_->tensor_to_ensemble_output_.find(tensor_idx) !=
+      info_->tensor_to_ensemble_output_.end()) {
+    return;
+  }
+
+  // The data is freed once the steps that produced and used the tensor
+  // also release it.
+  tensor_data_[tensor_idx].second.reset();
+  held_byte_size_ -= tensor_byte_size_[tensor_idx];
+  tensor_byte_size_[tensor_idx] = 0;
+}
+
 Status
 EnsembleContext::GetNextSteps(
     const std::vector<size_t>& updated_tensors, StepList& steps)
@@ -379,6 +623,26 @@ EnsembleContext::InitStep(size_t step_idx, std::shared_ptr<Step>* step)
   request_header.set_correlation_id(correlation_id_);
   request_header.set_batch_size(batch_size_);
   request_header.set_flags(flags_);
+  request_header.set_priority(priority_);
+
+  // If the ensemble request has a deadline then don't start a step
+  // once the deadline has passed, otherwise pass the remaining time
+  // to the step so that the composing model can drop it if it
+  // expires while queued.
+  if (request_provider_->DeadlineNs() != 0) {
+    const uint64_t now_ns = MonotonicNowNs();
+    if (request_provider_->IsExpired(now_ns)) {
+      stats_->SetTimedOut(true);
+      return Status(
+          RequestStatusCode::UNAVAILABLE,
+          "inference request timed out before model '" +
+              info_->steps_[step_idx].model_name_ + "' could be executed");
+    }
+
+    request_header.set_timeout_microseconds(std::max(
+        (uint64_t)1, (request_provider_->DeadlineNs() - now_ns) / 1000));
+  }
+
   for (const auto& pair : info_->steps_[step_idx].input_to_tensor_) {
     auto input = request_header.add_input();
     *input = tensor_data_[pair.second].first;
@@ -405,6 +669,75 @@ EnsembleContext::InitStep(size_t step_idx, std::shared_ptr<Step>* step)
       (*step)->backend_->GetInferenceBackend()->GetLabelProvider(),
       &((*step)->response_provider_)));
 
+  // Let the step write the ensemble outputs it produces directly into
+  // the ensemble response instead of copying them when the ensemble
+  // finishes. An output with a reshape is still copied because its
+  // shape in the step differs from its shape in the response.
+  const InferenceBackend& step_backend = *(backend->GetInferenceBackend());
+  const bool step_batching = (step_backend.Config().max_batch_size() != 0);
+  for (const auto& pair : info_->steps_[step_idx].output_to_tensor_) {
+    auto it = info_->tensor_to_ensemble_output_.find(pair.second);
+    if ((it == info_->tensor_to_ensemble_output_.end()) ||
+        !response_provider_->RequiresOutput(it->second)) {
+      continue;
+    }
+
+    const ModelOutput* output_config;
+    if (!step_backend.GetOutput(pair.first, &output_config).IsOk() ||
+        output_config->has_reshape()) {
+      continue;
+    }
+
+    const std::string& output_name = it->second;
+    const size_t tensor_idx = pair.second;
+    (*step)->response_provider_->SetOutputAllocator(
+        pair.first,
+        [this, output_name, tensor_idx, step_batching](
+            size_t content_byte_size, const std::vector<int64_t>& content_shape,
+            void** content, bool* allocated) {
+          return AllocateEnsembleOutput(
+              output_name, tensor_idx, step_batching, content_byte_size,
+              content_shape, content, allocated);
+        });
+  }
+
+  return Status::Success;
+}
+
+Status
+EnsembleContext::AllocateEnsembleOutput(
+    const std::string& output_name, size_t tensor_idx, bool step_batching,
+    size_t content_byte_size, const std::vector<int64_t>& content_shape,
+    void** content, bool* allocated)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Once the ensemble has failed the step uses its own buffer, so that
+  // no more steps write into the response that is about to complete.
+  *allocated = false;
+  if (finished_ || !ensemble_status_.IsOk()) {
+    return Status::Success;
+  }
+
+  // The ensemble output shape has the ensemble batch dimension, if
+  // any, followed by the step output shape without its batch
+  // dimension.
+  std::vector<int64_t> shape;
+  if (info_->allow_batching_) {
+    shape.push_back(batch_size_);
+  }
+  auto dim_itr = content_shape.begin();
+  if (step_batching && (dim_itr != content_shape.end())) {
+    ++dim_itr;
+  }
+  shape.insert(shape.end(), dim_itr, content_shape.end());
+
+  RETURN_IF_ERROR(response_provider_->AllocateOutputBuffer(
+      output_name, content, content_byte_size, shape));
+
+  forwarded_tensors_.insert(tensor_idx);
+  inflight_forwarded_cnt_++;
+  *allocated = true;
   return Status::Success;
 }
 
@@ -421,6 +754,8 @@ EnsembleContext::FinishEnsemble()
         ensemble_status_.Code(), "in ensemble '" + info_->ensemble_name_ +
                                      "', " + ensemble_status_.Message());
   }
+  stats_->SetEnsembleTensorPeakByteSize(peak_held_byte_size_);
+  finished_ = true;
   OnComplete_(ensemble_status_);
 
   // Reset stats_ to make sure the timers are stopped even though
@@ -433,6 +768,7 @@ EnsembleContext::FinishEnsemble()
 Status
 EnsembleContext::CheckAndSetEnsembleOutput()
 {
+  size_t output_copy_byte_size = 0;
   for (const auto& output_pair : info_->ensemble_output_to_tensor_) {
     if (!response_provider_->RequiresOutput(output_pair.first)) {
       continue;
@@ -455,6 +791,13 @@ EnsembleContext::CheckAndSetEnsembleOutput()
               std::to_string(tensor_data.second->TotalByteSize()));
     }
 
+    // Outputs written in place by the step are already in the ensemble
+    // response.
+    if (forwarded_tensors_.find(output_pair.second) !=
+        forwarded_tensors_.end()) {
+      continue;
+    }
+
     // copy data to ensemble response provider
     size_t expected_byte_size = tensor_data.first.batch_byte_size();
     std::vector<int64_t> shape;
@@ -480,39 +823,447 @@ EnsembleContext::CheckAndSetEnsembleOutput()
       content_idx++;
       content = tensor_data.second->BufferAt(content_idx, &content_size);
     }
+
+    output_copy_byte_size += content_offset;
   }
+
+  stats_->SetOutputCopyByteSize(output_copy_byte_size);
   return Status::Success;
 }
 
+bool
+EnsembleContext::IsBatchableStep(const Step& step) const
+{
+  // Steps of a sequence can't be combined as they must be executed in
+  // order by the same model instance.
+  const ModelConfig& config = step.backend_->GetInferenceBackend()->Config();
+  if ((correlation_id_ != 0) || (config.max_batch_size() == 0) ||
+      config.has_sequence_batching()) {
+    return false;
+  }
+
+  // STRING outputs have a variable byte size for each batch entry so
+  // they can't be split between the ensemble requests.
+  for (const auto& output : config.output()) {
+    if (output.data_type() == DataType::TYPE_STRING) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+EnsembleContext::CanBatchTogether(const Step& lhs, const Step& rhs)
+{
+  if (lhs.backend_->GetInferenceBackend() !=
+      rhs.backend_->GetInferenceBackend()) {
+    return false;
+  }
+
+  const InferRequestHeader& lhs_header = lhs.request_provider_->RequestHeader();
+  const InferRequestHeader& rhs_header = rhs.request_provider_->RequestHeader();
+  if ((lhs_header.flags() != rhs_header.flags()) ||
+      (lhs_header.priority() != rhs_header.priority()) ||
+      (lhs_header.input_size() != rhs_header.input_size())) {
+    return false;
+  }
+
+  for (const auto& lhs_input : lhs_header.input()) {
+    bool matched = false;
+    for (const auto& rhs_input : rhs_header.input()) {
+      if (rhs_input.name() == lhs_input.name()) {
+        matched = (lhs_input.dims_size() == rhs_input.dims_size()) &&
+                  std::equal(
+                      lhs_input.dims().begin(), lhs_input.dims().end(),
+                      rhs_input.dims().begin());
+        break;
+      }
+    }
+    if (!matched) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void
 EnsembleContext::ScheduleSteps(
     const std::shared_ptr<EnsembleContext>& context, const StepList& steps)
 {
+  EnsembleStepBatcher* step_batcher = context->info_->step_batcher_.get();
   for (const auto& step : steps) {
-    InferenceBackend* backend = step->backend_->GetInferenceBackend();
-
-    auto infer_stats = std::make_shared<ModelInferStats>(
-        context->is_->StatusManager(), backend->Name());
-    auto timer = std::make_shared<ModelInferStats::ScopedTimer>();
-    infer_stats->StartRequestTimer(timer.get());
-    infer_stats->SetRequestedVersion(backend->Version());
-    infer_stats->SetMetricReporter(backend->MetricReporter());
-    infer_stats->SetBatchSize(
-        step->request_provider_->RequestHeader().batch_size());
-
-    context->is_->HandleInfer(
-        &(step->request_status_), step->backend_, step->request_provider_,
-        step->response_provider_, infer_stats,
-        [context, step, infer_stats, timer]() mutable {
-          timer.reset();
-          infer_stats.reset();
-          Proceed(context, step);
-        });
+    if ((step_batcher != nullptr) && context->IsBatchableStep(*step)) {
+      step_batcher->Enqueue(context, step);
+    } else {
+      ScheduleStep(context, step);
+    }
+  }
+}
+
+void
+EnsembleContext::ScheduleStep(
+    const std::shared_ptr<EnsembleContext>& context,
+    const std::shared_ptr<Step>& step)
+{
+  InferenceBackend* backend = step->backend_->GetInferenceBackend();
+
+  auto infer_stats = std::make_shared<ModelInferStats>(
+      context->is_->StatusManager(), backend->Name());
+  auto timer = std::make_shared<ModelInferStats::ScopedTimer>();
+  infer_stats->StartRequestTimer(timer.get());
+  infer_stats->SetRequestedVersion(backend->Version());
+  infer_stats->SetMetricReporter(backend->MetricReporter());
+  infer_stats->SetBatchSize(
+      step->request_provider_->RequestHeader().batch_size());
+
+  context->is_->HandleInfer(
+      &(step->request_status_), step->backend_, step->request_provider_,
+      step->response_provider_, infer_stats,
+      [context, step, infer_stats, timer]() mutable {
+        timer.reset();
+        infer_stats.reset();
+        Proceed(context, step);
+      });
+}
+
+void
+EnsembleContext::ScheduleBatchedSteps(const BatchedStepList& batched)
+{
+  if (batched.size() == 1) {
+    ScheduleStep(batched.front().first, batched.front().second);
+    return;
+  }
+
+  // If the requests can't be combined then execute each step on its
+  // own instead.
+  const std::shared_ptr<EnsembleContext>& context = batched.front().first;
+  std::shared_ptr<Step> batch_step;
+  Status status = InitBatchedStep(batched, &batch_step);
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << "failed to combine steps for ensemble '"
+                   << context->info_->ensemble_name_
+                   << "': " << status.AsString();
+    for (const auto& pair : batched) {
+      ScheduleStep(pair.first, pair.second);
+    }
+    return;
+  }
+
+  InferenceBackend* backend = batch_step->backend_->GetInferenceBackend();
+
+  auto infer_stats = std::make_shared<ModelInferStats>(
+      context->is_->StatusManager(), backend->Name());
+  auto timer = std::make_shared<ModelInferStats::ScopedTimer>();
+  infer_stats->StartRequestTimer(timer.get());
+  infer_stats->SetRequestedVersion(backend->Version());
+  infer_stats->SetMetricReporter(backend->MetricReporter());
+  infer_stats->SetBatchSize(
+      batch_step->request_provider_->RequestHeader().batch_size());
+
+  context->is_->HandleInfer(
+      &(batch_step->request_status_), batch_step->backend_,
+      batch_step->request_provider_, batch_step->response_provider_,
+      infer_stats, [batched, batch_step, infer_stats, timer]() mutable {
+        timer.reset();
+        infer_stats.reset();
+        CompleteBatchedSteps(batched, batch_step);
+      });
+}
+
+Status
+EnsembleContext::InitBatchedStep(
+    const BatchedStepList& batched, std::shared_ptr<Step>* batch_step)
+{
+  const EnsembleContext& context = *(batched.front().first);
+  const Step& first_step = *(batched.front().second);
+  const InferRequestHeader& first_header =
+      first_step.request_provider_->RequestHeader();
+  const EnsembleInfo::StepInfo& step_info =
+      context.info_->steps_[first_step.step_idx_];
+
+  // Only steps with the same flags and priority are combined, see
+  // CanBatchTogether().
+  InferRequestHeader request_header;
+  request_header.set_flags(first_header.flags());
+  request_header.set_priority(first_header.priority());
+
+  // The combined request has a deadline only if every step has one,
+  // and then it is the latest of them so that no step is dropped
+  // earlier than it would be on its own.
+  uint32_t batch_size = 0;
+  uint64_t deadline_ns = 0;
+  bool has_deadline = true;
+  for (const auto& pair : batched) {
+    const auto& request_provider = pair.second->request_provider_;
+    batch_size += request_provider->RequestHeader().batch_size();
+    has_deadline &= (request_provider->DeadlineNs() != 0);
+    deadline_ns = std::max(deadline_ns, request_provider->DeadlineNs());
+  }
+  request_header.set_batch_size(batch_size);
+  if (has_deadline) {
+    const uint64_t now_ns = MonotonicNowNs();
+    request_header.set_timeout_microseconds(std::max(
+        (uint64_t)1,
+        (deadline_ns > now_ns) ? (deadline_ns - now_ns) / 1000 : 0));
+  }
+
+  // Each input of the combined request references the input data of
+  // every step in order, so the inputs are not copied.
+  std::unordered_map<std::string, std::shared_ptr<SystemMemory>> input_map;
+  for (const auto& input : first_header.input()) {
+    auto input_buffer = std::make_shared<SystemMemoryReference>();
+    for (const auto& pair : batched) {
+      std::shared_ptr<SystemMemory> step_buffer;
+      RETURN_IF_ERROR(pair.second->request_provider_->GetSystemMemory(
+          input.name(), &step_buffer));
+      size_t idx = 0;
+      size_t byte_size;
+      const char* block;
+      while ((block = step_buffer->BufferAt(idx++, &byte_size)) != nullptr) {
+        input_buffer->AddBuffer(block, byte_size);
+      }
+    }
+
+    auto batch_input = request_header.add_input();
+    *batch_input = input;
+    batch_input->set_batch_byte_size(input_buffer->TotalByteSize());
+    input_map[input.name()] = input_buffer;
+  }
+  for (const auto& output : first_header.output()) {
+    *(request_header.add_output()) = output;
+  }
+  RETURN_IF_ERROR(NormalizeRequestHeader(
+      *first_step.backend_->GetInferenceBackend(), request_header));
+
+  batch_step->reset(new Step(first_step.step_idx_));
+  (*batch_step)->backend_ = first_step.backend_;
+  RETURN_IF_ERROR(InferRequestProvider::Create(
+      step_info.model_name_, step_info.model_version_, request_header,
+      input_map, &((*batch_step)->request_provider_)));
+  RETURN_IF_ERROR(InternalInferResponseProvider::Create(
+      *((*batch_step)->backend_->GetInferenceBackend()),
+      (*batch_step)->request_provider_->RequestHeader(),
+      (*batch_step)->backend_->GetInferenceBackend()->GetLabelProvider(),
+      &((*batch_step)->response_provider_)));
+
+  return Status::Success;
+}
+
+void
+EnsembleContext::CompleteBatchedSteps(
+    const BatchedStepList& batched, const std::shared_ptr<Step>& batch_step)
+{
+  const InferenceBackend& backend =
+      *(batch_step->backend_->GetInferenceBackend());
+
+  Status status;
+  if (batch_step->request_status_.code() != RequestStatusCode::SUCCESS) {
+    status = Status(
+        batch_step->request_status_.code(), batch_step->request_status_.msg());
+  } else {
+    status = batch_step->response_provider_->FinalizeResponse(backend);
+  }
+
+  // Give each step the slice of every output that belongs to its batch
+  // entries. The step's output references the combined output so that
+  // the data is not copied.
+  const InferResponseHeader& response_header =
+      batch_step->response_provider_->ResponseHeader();
+  const size_t total_batch_size = response_header.batch_size();
+  size_t batch_offset = 0;
+  for (const auto& pair : batched) {
+    const std::shared_ptr<Step>& step = pair.second;
+    const size_t step_batch_size =
+        step->request_provider_->RequestHeader().batch_size();
+
+    Status step_status = status;
+    for (const auto& output : response_header.output()) {
+      if (!step_status.IsOk()) {
+        break;
+      }
+
+      const ModelOutput* output_config;
+      step_status = backend.GetOutput(output.name(), &output_config);
+      if (!step_status.IsOk()) {
+        break;
+      }
+
+      std::shared_ptr<SystemMemory> output_buffer;
+      step_status = batch_step->response_provider_->GetSystemMemory(
+          output.name(), &output_buffer);
+      if (!step_status.IsOk()) {
+        break;
+      }
+
+      // The model returns the shape before any reshape, which is what
+      // the step's response provider expects.
+      std::vector<int64_t> content_shape{(int64_t)step_batch_size};
+      const DimsList& dims = (output_config->has_reshape())
+                                 ? output_config->reshape().shape()
+                                 : output.raw().dims();
+      content_shape.insert(content_shape.end(), dims.begin(), dims.end());
+
+      const size_t batch1_byte_size =
+          output.raw().batch_byte_size() / total_batch_size;
+      const size_t content_byte_size = step_batch_size * batch1_byte_size;
+      size_t byte_size;
+      const char* base = output_buffer->BufferAt(0, &byte_size);
+      step->response_provider_->SetOutputBuffer(
+          output.name(),
+          std::make_shared<SystemMemoryBlock>(
+              output_buffer, base + (batch_offset * batch1_byte_size),
+              content_byte_size));
+
+      void* content;
+      step_status = step->response_provider_->AllocateOutputBuffer(
+          output.name(), &content, content_byte_size, content_shape);
+    }
+
+    if (step_status.IsOk()) {
+      step->request_status_ = batch_step->request_status_;
+    } else {
+      step->request_status_.set_code(step_status.Code());
+      step->request_status_.set_msg(step_status.Message());
+    }
+
+    batch_offset += step_batch_size;
+  }
+
+  for (const auto& pair : batched) {
+    Proceed(pair.first, pair.second);
   }
 }
 
 }  // namespace
 
+EnsembleStepBatcher::EnsembleStepBatcher(uint64_t delay_microseconds)
+    : state_(std::make_shared<State>(delay_microseconds * 1000))
+{
+  std::shared_ptr<State> state = state_;
+  batcher_thread_.reset(new std::thread([state]() { BatcherThread(state); }));
+}
+
+EnsembleStepBatcher::~EnsembleStepBatcher()
+{
+  // Signal the batcher thread to schedule the held steps and exit, and
+  // then wait for it, unless the batcher is destroyed by the batcher
+  // thread itself. That thread can't join itself, it exits on its own
+  // once the step it is scheduling returns.
+  {
+    std::unique_lock<std::mutex> lock(state_->mu_);
+    state_->exit_ = true;
+    state_->cv_.notify_all();
+  }
+
+  if (batcher_thread_->get_id() == std::this_thread::get_id()) {
+    batcher_thread_->detach();
+  } else {
+    batcher_thread_->join();
+  }
+}
+
+void
+EnsembleStepBatcher::Enqueue(
+    const std::shared_ptr<EnsembleContext>& context,
+    const std::shared_ptr<Step>& step)
+{
+  const size_t batch_size =
+      step->request_provider_->RequestHeader().batch_size();
+  const size_t max_batch_size =
+      step->backend_->GetInferenceBackend()->Config().max_batch_size();
+
+  std::unique_lock<std::mutex> lock(state_->mu_);
+  StepQueue& queue = state_->queues_[step->step_idx_];
+  queue.steps_.emplace_back(HeldStep{context, step, MonotonicNowNs()});
+  queue.batch_size_ += batch_size;
+  queue.max_batch_size_ = max_batch_size;
+  state_->cv_.notify_one();
+}
+
+void
+EnsembleStepBatcher::BatcherThread(const std::shared_ptr<State>& state)
+{
+  std::unique_lock<std::mutex> lock(state->mu_);
+  while (true) {
+    // Take the steps that have been held for the delay, or that fill a
+    // batch for their model. Everything is taken when exiting.
+    const uint64_t now_ns = MonotonicNowNs();
+    uint64_t wait_ns = 0;
+    std::vector<std::deque<HeldStep>> ready;
+    for (auto& pr : state->queues_) {
+      StepQueue& queue = pr.second;
+      if (queue.steps_.empty()) {
+        continue;
+      }
+
+      const uint64_t deadline_ns =
+          queue.steps_.front().enqueue_ns_ + state->delay_ns_;
+      if (state->exit_ || (queue.batch_size_ >= queue.max_batch_size_) ||
+          (deadline_ns <= now_ns)) {
+        ready.emplace_back(std::move(queue.steps_));
+        queue.steps_.clear();
+        queue.batch_size_ = 0;
+      } else if ((wait_ns == 0) || ((deadline_ns - now_ns) < wait_ns)) {
+        wait_ns = deadline_ns - now_ns;
+      }
+    }
+
+    // Schedule outside the lock as completing a step may hold new
+    // steps.
+    if (!ready.empty()) {
+      lock.unlock();
+      for (auto& held : ready) {
+        ScheduleHeldSteps(std::move(held));
+      }
+      lock.lock();
+      continue;
+    }
+
+    if (state->exit_) {
+      break;
+    }
+
+    if (wait_ns == 0) {
+      state->cv_.wait(lock);
+    } else {
+      state->cv_.wait_for(lock, std::chrono::nanoseconds(wait_ns));
+    }
+  }
+}
+
+void
+EnsembleStepBatcher::ScheduleHeldSteps(std::deque<HeldStep>&& held)
+{
+  // Greedily combine each step with the following steps that fit in
+  // the same batch and have matching inputs.
+  while (!held.empty()) {
+    const std::shared_ptr<Step> first_step = held.front().step_;
+    const size_t max_batch_size =
+        first_step->backend_->GetInferenceBackend()->Config().max_batch_size();
+
+    EnsembleContext::BatchedStepList batched;
+    std::deque<HeldStep> remaining;
+    size_t batch_size = 0;
+    for (auto& held_step : held) {
+      const size_t step_batch_size =
+          held_step.step_->request_provider_->RequestHeader().batch_size();
+      if (batched.empty() ||
+          (((batch_size + step_batch_size) <= max_batch_size) &&
+           EnsembleContext::CanBatchTogether(*first_step, *held_step.step_))) {
+        batch_size += step_batch_size;
+        batched.emplace_back(held_step.context_, held_step.step_);
+      } else {
+        remaining.emplace_back(std::move(held_step));
+      }
+    }
+
+    EnsembleContext::ScheduleBatchedSteps(batched);
+    held.swap(remaining);
+  }
+}
+
 Status
 EnsembleScheduler::Create(
     const ModelConfig& config, std::unique_ptr<Scheduler>* scheduler)
@@ -521,6 +1272,8 @@ EnsembleScheduler::Create(
   return Status::Success;
 }
 
+EnsembleScheduler::~EnsembleScheduler() {}
+
 void
 EnsembleScheduler::Enqueue(
     const std::shared_ptr<ModelInferStats>& stats,
@@ -553,6 +1306,7 @@ EnsembleScheduler::EnsembleScheduler(const ModelConfig& config)
   for (const auto& output : config.output()) {
     size_t idx = info_->tensor_to_step_.size();
     info_->ensemble_output_to_tensor_[output.name()] = idx;
+    info_->tensor_to_ensemble_output_[idx] = output.name();
     name_to_idx[output.name()] = idx;
     info_->tensor_to_step_.emplace_back();
   }
@@ -587,6 +1341,18 @@ EnsembleScheduler::EnsembleScheduler(const ModelConfig& config)
           std::make_pair(pair.first, idx));
     }
   }
+
+  info_->tensor_consumer_cnt_.resize(info_->tensor_to_step_.size(), 0);
+  for (const auto& step_info : info_->steps_) {
+    for (const auto& pair : step_info.input_to_tensor_) {
+      info_->tensor_consumer_cnt_[pair.second]++;
+    }
+  }
+
+  if (config.ensemble_scheduling().step_batching_delay_microseconds() > 0) {
+    info_->step_batcher_.reset(new EnsembleStepBatcher(
+        config.ensemble_scheduling().step_batching_delay_microseconds()));
+  }
 }
 
 }}  // namespace nvidia::inferenceserver
@@ -34,6 +34,7 @@
 
 namespace nvidia { namespace inferenceserver {
 
+class EnsembleStepBatcher;
 class InferenceServer;
 
 struct EnsembleInfo {
@@ -56,11 +57,24 @@ struct EnsembleInfo {
   std::unordered_map<std::string, size_t> ensemble_input_to_tensor_;
   std::unordered_map<std::string, size_t> ensemble_output_to_tensor_;
 
+  // Map from the tensor index of each ensemble output to the output
+  // name.
+  std::unordered_map<size_t, std::string> tensor_to_ensemble_output_;
+
   std::vector<StepInfo> steps_;
 
   // Only include a step if the ensemble tensor is used as input in that step
   // Representing ensemble tensor with index (name doesn't matter at this point)
   std::vector<std::set<size_t>> tensor_to_step_;
+
+  // The number of step inputs that use each ensemble tensor. Once
+  // that many step inputs have completed, the tensor is no longer
+  // needed unless it is an ensemble output.
+  std::vector<size_t> tensor_consumer_cnt_;
+
+  // Combines the same ready step of different ensemble requests, or
+  // nullptr if step batching is not enabled.
+  std::unique_ptr<EnsembleStepBatcher> step_batcher_;
 };
 
 // Scheduler that implements ensemble scheduling.
@@ -71,6 +85,8 @@ class EnsembleScheduler : public Scheduler {
   static Status Create(
       const ModelConfig& config, std::unique_ptr<Scheduler>* scheduler);
 
+  ~EnsembleScheduler();
+
   // \see Scheduler::Enqueue()
   void Enqueue(
       const std::shared_ptr<ModelInferStats>& stats,
@@ -27,11 +27,15 @@
 #include "src/core/filesystem.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <google/protobuf/text_format.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <cerrno>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
 #include "src/core/constants.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -52,6 +56,8 @@ class FileSystem {
       const std::string& path, std::set<std::string>* files) = 0;
   virtual Status ReadTextFile(
       const std::string& path, std::string* contents) = 0;
+  virtual Status MapFile(
+      const std::string& path, std::shared_ptr<FileBlob>* blob) = 0;
   virtual Status WriteTextFile(
       const std::string& path, const std::string& contents) = 0;
 };
@@ -68,7 +74,35 @@ class LocalFileSystem : public FileSystem {
   Status GetDirectoryFiles(
       const std::string& path, std::set<std::string>* files);
   Status ReadTextFile(const std::string& path, std::string* contents);
+  Status MapFile(const std::string& path, std::shared_ptr<FileBlob>* blob);
   Status WriteTextFile(const std::string& path, const std::string& contents);
+
+ private:
+  // The files that are currently mapped, keyed by the identity and
+  // modification time of the file.
+  std::mutex mapped_mu_;
+  std::unordered_map<std::string, std::weak_ptr<FileBlob>> mapped_files_;
+};
+
+class MappedFileBlob : public FileBlob {
+ public:
+  MappedFileBlob(void* addr, size_t size) : addr_(addr), size_(size) {}
+  ~MappedFileBlob()
+  {
+    if (addr_ != nullptr) {
+      munmap(addr_, size_);
+    }
+  }
+
+  const char* Data() const override
+  {
+    return static_cast<const char*>(addr_);
+  }
+  size_t Size() const override { return size_; }
+
+ private:
+  void* addr_;
+  const size_t size_;
 };
 
 
@@ -186,6 +220,72 @@ LocalFileSystem::ReadTextFile(const std::string& path, std::string* contents)
   return Status::Success;
 }
 
+Status
+LocalFileSystem::MapFile(
+    const std::string& path, std::shared_ptr<FileBlob>* blob)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to open file for mapping " + path + ": " + strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return Status(RequestStatusCode::INTERNAL, "failed to stat file " + path);
+  }
+
+  const std::string key =
+      std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+      std::to_string(st.st_size) + ":" +
+      std::to_string(st.st_mtim.tv_sec * NANOS_PER_SECOND + st.st_mtim.tv_nsec);
+
+  std::lock_guard<std::mutex> lock(mapped_mu_);
+
+  auto it = mapped_files_.find(key);
+  if (it != mapped_files_.end()) {
+    *blob = it->second.lock();
+    if (*blob != nullptr) {
+      close(fd);
+      return Status::Success;
+    }
+  }
+
+  // An empty file can't be mapped.
+  void* addr = nullptr;
+  const size_t size = st.st_size;
+  if (size > 0) {
+    addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      const std::string err = strerror(errno);
+      close(fd);
+      return Status(
+          RequestStatusCode::INTERNAL,
+          "failed to map file " + path + ": " + err);
+    }
+
+    // The whole file is about to be read, so start reading it in now.
+    madvise(addr, size, MADV_WILLNEED);
+  }
+  close(fd);
+
+  blob->reset(new MappedFileBlob(addr, size));
+
+  // Forget the files that are no longer mapped.
+  for (auto mit = mapped_files_.begin(); mit != mapped_files_.end();) {
+    if (mit->second.expired()) {
+      mit = mapped_files_.erase(mit);
+    } else {
+      ++mit;
+    }
+  }
+  mapped_files_[key] = *blob;
+
+  return Status::Success;
+}
+
 Status
 LocalFileSystem::WriteTextFile(
     const std::string& path, const std::string& contents)
@@ -356,6 +456,14 @@ ReadTextFile(const std::string& path, std::string* contents)
   return fs->ReadTextFile(path, contents);
 }
 
+Status
+MapFile(const std::string& path, std::shared_ptr<FileBlob>* blob)
+{
+  FileSystem* fs;
+  RETURN_IF_ERROR(GetFileSystem(path, &fs));
+  return fs->MapFile(path, blob);
+}
+
 Status
 ReadTextProto(const std::string& path, google::protobuf::Message* msg)
 {
@@ -25,12 +25,27 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <memory>
 #include <string>
 #include "google/protobuf/message.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
 
+/// The read-only contents of a file, memory-mapped by MapFile(). The
+/// contents remain valid for as long as the object is alive. The file
+/// must not be modified in place while it is mapped.
+class FileBlob {
+ public:
+  virtual ~FileBlob() = default;
+
+  /// \return the contents of the file.
+  virtual const char* Data() const = 0;
+
+  /// \return the size of the file, in bytes.
+  virtual size_t Size() const = 0;
+};
+
 /// Is a path an absolute path?
 /// \param path The path.
 /// \return true if absolute path, false if relative path.
@@ -95,6 +110,15 @@ Status GetDirectoryFiles(const std::string& path, std::set<std::string>* files);
 /// \return Error status
 Status ReadTextFile(const std::string& path, std::string* contents);
 
+/// Map a file into memory. Mapping a file that is already mapped and
+/// has not changed since returns the existing mapping, so that a file
+/// used by multiple model versions or instances is held in memory
+/// only once.
+/// \param path The path of the file.
+/// \param blob Returns the contents of the file.
+/// \return Error status
+Status MapFile(const std::string& path, std::shared_ptr<FileBlob>* blob);
+
 /// Write a string to a file.
 /// \param path The path of the file.
 /// \param contents The contents to write to the file.
@@ -0,0 +1,120 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/latency_histogram.h"
+
+#include <algorithm>
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Each power-of-2 range is split into 2^SUB_BUCKET_BITS buckets.
+constexpr uint32_t SUB_BUCKET_BITS = 3;
+constexpr uint64_t SUB_BUCKET_CNT = 1 << SUB_BUCKET_BITS;
+
+// Largest recorded duration, in microseconds. Longer durations are
+// recorded as this value.
+constexpr uint64_t MAX_DURATION_US = (1ULL << 32) - 1;
+
+}  // namespace
+
+constexpr size_t LatencyHistogram::BUCKET_COUNT;
+
+LatencyHistogram::LatencyHistogram() : counts_() {}
+
+void
+LatencyHistogram::Record(uint64_t duration_ns)
+{
+  counts_[BucketIndex(duration_ns)]++;
+}
+
+void
+LatencyHistogram::AddCounts(std::vector<uint64_t>* counts) const
+{
+  counts->resize(BUCKET_COUNT, 0);
+  for (size_t idx = 0; idx < BUCKET_COUNT; ++idx) {
+    (*counts)[idx] += counts_[idx];
+  }
+}
+
+size_t
+LatencyHistogram::BucketIndex(uint64_t duration_ns)
+{
+  const uint64_t us = std::min(duration_ns / 1000, MAX_DURATION_US);
+
+  // Durations less than SUB_BUCKET_CNT microseconds each have their
+  // own bucket. Longer durations are placed by their most significant
+  // bit and the SUB_BUCKET_BITS bits that follow it.
+  if (us < SUB_BUCKET_CNT) {
+    return us;
+  }
+
+  const uint32_t msb = 63 - __builtin_clzll(us);
+  const uint64_t sub = (us >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKET_CNT - 1);
+  return ((msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_CNT) + sub;
+}
+
+uint64_t
+LatencyHistogram::BucketUpperBoundNs(size_t idx)
+{
+  if (idx < SUB_BUCKET_CNT) {
+    return (idx + 1) * 1000;
+  }
+
+  const uint64_t shift = (idx / SUB_BUCKET_CNT) - 1;
+  const uint64_t sub = idx % SUB_BUCKET_CNT;
+  return ((SUB_BUCKET_CNT + sub + 1) << shift) * 1000;
+}
+
+uint64_t
+LatencyHistogram::Percentile(
+    const std::vector<uint64_t>& counts, double percentile)
+{
+  uint64_t total = 0;
+  for (const auto count : counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  // The rank of the percentile duration, counting from 1.
+  const uint64_t rank = std::max(
+      (uint64_t)1, (uint64_t)((percentile / 100.0) * total + 0.5));
+
+  uint64_t cumulative = 0;
+  for (size_t idx = 0; idx < counts.size(); ++idx) {
+    cumulative += counts[idx];
+    if (cumulative >= rank) {
+      return BucketUpperBoundNs(idx);
+    }
+  }
+
+  return BucketUpperBoundNs(counts.size() - 1);
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,77 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+// Fixed-size histogram of durations. A histogram is not thread-safe,
+// the caller must serialize Record() and AddCounts(). Durations are
+// recorded with microsecond resolution
+// into log-linear buckets: each power-of-2 range of microseconds is
+// split into 8 equal sub-buckets, so a bucket's upper bound is at
+// most 12.5% larger than any duration it holds. Durations of 2^32
+// microseconds (about 71 minutes) or longer are recorded in the last
+// bucket.
+class LatencyHistogram {
+ public:
+  // The number of buckets in every histogram.
+  static constexpr size_t BUCKET_COUNT = 240;
+
+  LatencyHistogram();
+
+  // Record a duration.
+  void Record(uint64_t duration_ns);
+
+  // Add the count of each bucket to the corresponding entry of
+  // 'counts', resizing 'counts' to BUCKET_COUNT entries if
+  // necessary.
+  void AddCounts(std::vector<uint64_t>* counts) const;
+
+  // Return the bucket that holds 'duration_ns'.
+  static size_t BucketIndex(uint64_t duration_ns);
+
+  // Return the exclusive upper bound, in nanoseconds, of the
+  // durations held by bucket 'idx'.
+  static uint64_t BucketUpperBoundNs(size_t idx);
+
+  // Return the upper bound, in nanoseconds, of the bucket holding
+  // the 'percentile' (0 - 100) duration given bucket 'counts'. Return
+  // 0 if 'counts' is empty.
+  static uint64_t Percentile(
+      const std::vector<uint64_t>& counts, double percentile);
+
+ private:
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  void operator=(const LatencyHistogram&) = delete;
+
+  uint64_t counts_[BUCKET_COUNT];
+};
+
+}}  // namespace nvidia::inferenceserver
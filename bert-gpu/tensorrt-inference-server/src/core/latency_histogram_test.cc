@@ -0,0 +1,135 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/latency_histogram.h"
+
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace nvidia { namespace inferenceserver {
+namespace {
+
+TEST(LatencyHistogramTest, BucketIndex)
+{
+  // Each microsecond below 8us has its own bucket.
+  EXPECT_EQ(LatencyHistogram::BucketIndex(0), (size_t)0);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(999), (size_t)0);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(1000), (size_t)1);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(7999), (size_t)7);
+
+  // Then 8 buckets per power-of-2 range of microseconds.
+  EXPECT_EQ(LatencyHistogram::BucketIndex(8000), (size_t)8);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(15999), (size_t)15);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(16000), (size_t)16);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(17999), (size_t)16);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(18000), (size_t)17);
+
+  // Durations of 2^32 microseconds or longer are in the last bucket.
+  const size_t last = LatencyHistogram::BUCKET_COUNT - 1;
+  EXPECT_EQ(LatencyHistogram::BucketIndex(((1ULL << 32) - 1) * 1000), last);
+  EXPECT_EQ(LatencyHistogram::BucketIndex((1ULL << 32) * 1000), last);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX), last);
+}
+
+TEST(LatencyHistogramTest, BucketUpperBound)
+{
+  // Every bucket holds the durations from the upper bound of the
+  // previous bucket up to, but not including, its own upper bound,
+  // and the upper bound is at most 12.5% larger than any duration in
+  // the bucket.
+  uint64_t lower_ns = 0;
+  for (size_t idx = 0; idx < LatencyHistogram::BUCKET_COUNT; ++idx) {
+    const uint64_t upper_ns = LatencyHistogram::BucketUpperBoundNs(idx);
+    ASSERT_GT(upper_ns, lower_ns) << "bucket " << idx;
+    EXPECT_EQ(LatencyHistogram::BucketIndex(lower_ns), idx);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(upper_ns - 1), idx);
+    if (idx >= 8) {
+      EXPECT_LE(upper_ns - lower_ns, lower_ns / 8) << "bucket " << idx;
+    }
+    lower_ns = upper_ns;
+  }
+}
+
+TEST(LatencyHistogramTest, AddCounts)
+{
+  LatencyHistogram histogram;
+  std::vector<uint64_t> counts;
+  histogram.AddCounts(&counts);
+  ASSERT_EQ(counts.size(), LatencyHistogram::BUCKET_COUNT);
+  for (const auto count : counts) {
+    EXPECT_EQ(count, (uint64_t)0);
+  }
+
+  histogram.Record(500);
+  histogram.Record(2500);
+  histogram.Record(2700);
+  histogram.Record(100000000);
+
+  // The counts are added to those already in 'counts'.
+  counts[2] = 10;
+  histogram.AddCounts(&counts);
+  histogram.AddCounts(&counts);
+
+  uint64_t total = 0;
+  for (const auto count : counts) {
+    total += count;
+  }
+  EXPECT_EQ(total, (uint64_t)18);
+  EXPECT_EQ(counts[LatencyHistogram::BucketIndex(500)], (uint64_t)2);
+  EXPECT_EQ(counts[LatencyHistogram::BucketIndex(2500)], (uint64_t)14);
+  EXPECT_EQ(counts[LatencyHistogram::BucketIndex(100000000)], (uint64_t)2);
+}
+
+TEST(LatencyHistogramTest, Percentile)
+{
+  std::vector<uint64_t> counts;
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 50), (uint64_t)0);
+  counts.resize(LatencyHistogram::BUCKET_COUNT, 0);
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 50), (uint64_t)0);
+
+  // 90 durations of 1us and 10 of 100us.
+  LatencyHistogram histogram;
+  for (size_t i = 0; i < 90; ++i) {
+    histogram.Record(1000);
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    histogram.Record(100000);
+  }
+  histogram.AddCounts(&counts);
+
+  const uint64_t fast_ns = LatencyHistogram::BucketUpperBoundNs(
+      LatencyHistogram::BucketIndex(1000));
+  const uint64_t slow_ns = LatencyHistogram::BucketUpperBoundNs(
+      LatencyHistogram::BucketIndex(100000));
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 0), fast_ns);
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 50), fast_ns);
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 90), fast_ns);
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 95), slow_ns);
+  EXPECT_EQ(LatencyHistogram::Percentile(counts, 100), slow_ns);
+}
+
+}  // namespace
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,200 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nvidia { namespace inferenceserver {
+
+// Bounded multi-producer, multi-consumer queue that does not use any
+// locks. Based on the array-of-sequence-numbers design by Dmitry
+// Vyukov: each cell carries a sequence number that tells producers
+// and consumers whether the cell is ready to be written or read, so
+// the only shared state that is contended is the pair of enqueue and
+// dequeue positions, each advanced with a CAS.
+//
+// The capacity is rounded up to a power-of-2. TryEnqueue fails
+// instead of blocking when the queue is full and TryDequeue fails
+// instead of blocking when the queue is empty, so callers must
+// provide their own fallback and wakeup mechanisms.
+template <typename T>
+class LockFreeQueue {
+ public:
+  explicit LockFreeQueue(size_t capacity);
+  ~LockFreeQueue();
+
+  // Move 'value' into the queue. Return false if the queue is full,
+  // in which case 'value' is left unmodified.
+  bool TryEnqueue(T&& value);
+
+  // Move the oldest value out of the queue into 'value'. Return false
+  // if the queue is empty.
+  bool TryDequeue(T* value);
+
+  // Return true if the queue appeared empty at some point during the
+  // call. The result is only a hint since other threads may be
+  // concurrently enqueuing or dequeuing.
+  bool Empty() const;
+
+  // The maximum number of values that the queue can hold.
+  size_t Capacity() const { return mask_ + 1; }
+
+ private:
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  void operator=(const LockFreeQueue&) = delete;
+
+  // Assume 64-byte cache lines. Padding keeps the producer and
+  // consumer positions on separate lines to avoid false sharing
+  // between producers and consumers.
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct Cell {
+    std::atomic<size_t> sequence_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  const size_t mask_;
+
+  char pad0_[kCacheLineSize];
+  std::atomic<size_t> enqueue_pos_;
+  char pad1_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> dequeue_pos_;
+  char pad2_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+namespace detail {
+
+inline size_t
+RoundUpToPowerOf2(size_t v)
+{
+  size_t p = 2;
+  while (p < v) {
+    p <<= 1;
+  }
+  return p;
+}
+
+}  // namespace detail
+
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue(size_t capacity)
+    : cells_(new Cell[detail::RoundUpToPowerOf2(capacity)]),
+      mask_(detail::RoundUpToPowerOf2(capacity) - 1)
+{
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+
+  enqueue_pos_.store(0, std::memory_order_relaxed);
+  dequeue_pos_.store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+LockFreeQueue<T>::~LockFreeQueue()
+{
+  // Destroy any values still in the queue.
+  T value;
+  while (TryDequeue(&value)) {
+  }
+}
+
+template <typename T>
+bool
+LockFreeQueue<T>::TryEnqueue(T&& value)
+{
+  Cell* cell;
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const size_t seq = cell->sequence_.load(std::memory_order_acquire);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The cell still holds a value from the previous lap, so the
+      // queue is full.
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  new (&cell->storage_) T(std::move(value));
+  cell->sequence_.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+LockFreeQueue<T>::TryDequeue(T* value)
+{
+  Cell* cell;
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const size_t seq = cell->sequence_.load(std::memory_order_acquire);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The cell has not been written for this lap, so the queue is
+      // empty.
+      return false;
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  T* stored = reinterpret_cast<T*>(&cell->storage_);
+  *value = std::move(*stored);
+  stored->~T();
+  cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+LockFreeQueue<T>::Empty() const
+{
+  const size_t pos = dequeue_pos_.load(std::memory_order_acquire);
+  const Cell& cell = cells_[pos & mask_];
+  return (cell.sequence_.load(std::memory_order_acquire) != (pos + 1));
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,160 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/lockfree_queue.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace nvidia { namespace inferenceserver {
+namespace {
+
+TEST(LockFreeQueueTest, CapacityRoundedUp)
+{
+  LockFreeQueue<int> q1(1);
+  EXPECT_EQ(q1.Capacity(), (size_t)2);
+  LockFreeQueue<int> q5(5);
+  EXPECT_EQ(q5.Capacity(), (size_t)8);
+  LockFreeQueue<int> q8(8);
+  EXPECT_EQ(q8.Capacity(), (size_t)8);
+}
+
+TEST(LockFreeQueueTest, EmptyDequeue)
+{
+  LockFreeQueue<int> queue(4);
+  EXPECT_TRUE(queue.Empty());
+
+  int value = -1;
+  EXPECT_FALSE(queue.TryDequeue(&value));
+  EXPECT_EQ(value, -1);
+
+  // Empty again after the only value is removed.
+  EXPECT_TRUE(queue.TryEnqueue(7));
+  EXPECT_FALSE(queue.Empty());
+  EXPECT_TRUE(queue.TryDequeue(&value));
+  EXPECT_EQ(value, 7);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.TryDequeue(&value));
+}
+
+TEST(LockFreeQueueTest, FullEnqueue)
+{
+  LockFreeQueue<std::unique_ptr<int>> queue(4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryEnqueue(std::unique_ptr<int>(new int(i))));
+  }
+
+  // A failed enqueue must leave the value with the caller.
+  std::unique_ptr<int> extra(new int(4));
+  EXPECT_FALSE(queue.TryEnqueue(std::move(extra)));
+  ASSERT_TRUE(extra != nullptr);
+  EXPECT_EQ(*extra, 4);
+
+  // Removing one value makes room for exactly one more.
+  std::unique_ptr<int> value;
+  EXPECT_TRUE(queue.TryDequeue(&value));
+  EXPECT_EQ(*value, 0);
+  EXPECT_TRUE(queue.TryEnqueue(std::move(extra)));
+  EXPECT_FALSE(queue.TryEnqueue(std::unique_ptr<int>(new int(5))));
+}
+
+TEST(LockFreeQueueTest, FifoOrder)
+{
+  // Enqueue and dequeue more values than the capacity so the
+  // positions wrap around the cells several times.
+  LockFreeQueue<std::string> queue(8);
+  int next_enqueue = 0;
+  int next_dequeue = 0;
+  while (next_dequeue < 100) {
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_TRUE(queue.TryEnqueue(std::to_string(next_enqueue++)));
+    }
+    for (int i = 0; i < 5; ++i) {
+      std::string value;
+      ASSERT_TRUE(queue.TryDequeue(&value));
+      EXPECT_EQ(value, std::to_string(next_dequeue++));
+    }
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(LockFreeQueueTest, DestroyNonEmpty)
+{
+  // Values left in the queue are destroyed with the queue.
+  std::shared_ptr<int> value = std::make_shared<int>(0);
+  {
+    LockFreeQueue<std::shared_ptr<int>> queue(4);
+    EXPECT_TRUE(queue.TryEnqueue(std::shared_ptr<int>(value)));
+    EXPECT_TRUE(queue.TryEnqueue(std::shared_ptr<int>(value)));
+    EXPECT_EQ(value.use_count(), 3);
+  }
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(LockFreeQueueTest, ProducersPreserveOrder)
+{
+  // Each producer's values must be dequeued in the order that
+  // producer enqueued them.
+  const size_t producer_cnt = 4;
+  const size_t per_producer = 10000;
+  LockFreeQueue<std::pair<size_t, size_t>> queue(64);
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_cnt; ++p) {
+    producers.emplace_back([&queue, p, per_producer]() {
+      for (size_t i = 0; i < per_producer; ++i) {
+        while (!queue.TryEnqueue(std::make_pair(p, i))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<size_t> next(producer_cnt, 0);
+  size_t consumed = 0;
+  while (consumed < (producer_cnt * per_producer)) {
+    std::pair<size_t, size_t> value;
+    if (!queue.TryDequeue(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_LT(value.first, producer_cnt);
+    EXPECT_EQ(value.second, next[value.first]);
+    next[value.first] = value.second + 1;
+    consumed++;
+  }
+
+  for (auto& thd : producers) {
+    thd.join();
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace
+}}  // namespace nvidia::inferenceserver
@@ -31,6 +31,15 @@
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Bucket boundaries, in microseconds, of the latency histograms.
+const std::vector<double> kLatencyBucketsUs{
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000,
+    500000, 1000000, 2500000, 5000000};
+
+}  // namespace
+
 MetricModelReporter::MetricModelReporter(
     const std::string& model_name, int64_t model_version,
     const MetricTagsMap& model_tags)
@@ -82,6 +91,26 @@ MetricModelReporter::GetCounterMetric(
   return counter;
 }
 
+prometheus::Histogram&
+MetricModelReporter::GetHistogramMetric(
+    std::map<int, prometheus::Histogram*>& metrics,
+    prometheus::Family<prometheus::Histogram>& family,
+    const std::vector<double>& buckets, const int gpu_device) const
+{
+  const auto itr = metrics.find(gpu_device);
+  if (itr != metrics.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Histogram& hist = family.Add(labels, buckets);
+  metrics.insert(
+      std::map<int, prometheus::Histogram*>::value_type(gpu_device, &hist));
+  return hist;
+}
+
 prometheus::Counter&
 MetricModelReporter::MetricInferenceSuccess(int gpu_device) const
 {
@@ -96,6 +125,13 @@ MetricModelReporter::MetricInferenceFailure(int gpu_device) const
       metric_inf_failure_, Metrics::FamilyInferenceFailure(), gpu_device);
 }
 
+prometheus::Counter&
+MetricModelReporter::MetricInferenceTimeout(int gpu_device) const
+{
+  return GetCounterMetric(
+      metric_inf_timeout_, Metrics::FamilyInferenceTimeout(), gpu_device);
+}
+
 prometheus::Counter&
 MetricModelReporter::MetricInferenceCount(int gpu_device) const
 {
@@ -111,6 +147,31 @@ MetricModelReporter::MetricInferenceExecutionCount(int gpu_device) const
       gpu_device);
 }
 
+prometheus::Counter&
+MetricModelReporter::MetricInferenceInputCopyBytes(int gpu_device) const
+{
+  return GetCounterMetric(
+      metric_inf_input_copy_bytes_, Metrics::FamilyInferenceInputCopyBytes(),
+      gpu_device);
+}
+
+prometheus::Counter&
+MetricModelReporter::MetricInferenceOutputCopyBytes(int gpu_device) const
+{
+  return GetCounterMetric(
+      metric_inf_output_copy_bytes_, Metrics::FamilyInferenceOutputCopyBytes(),
+      gpu_device);
+}
+
+prometheus::Counter&
+MetricModelReporter::MetricInferenceEnsembleTensorPeakBytes(
+    int gpu_device) const
+{
+  return GetCounterMetric(
+      metric_inf_ensemble_tensor_peak_bytes_,
+      Metrics::FamilyInferenceEnsembleTensorPeakBytes(), gpu_device);
+}
+
 prometheus::Counter&
 MetricModelReporter::MetricInferenceRequestDuration(int gpu_device) const
 {
@@ -136,21 +197,35 @@ MetricModelReporter::MetricInferenceQueueDuration(int gpu_device) const
 }
 
 prometheus::Histogram&
-MetricModelReporter::MetricInferenceLoadRatio(int gpu_device) const
+MetricModelReporter::MetricInferenceRequestLatency(int gpu_device) const
 {
-  const auto itr = metric_inf_load_ratio_.find(gpu_device);
-  if (itr != metric_inf_load_ratio_.end()) {
-    return *(itr->second);
-  }
+  return GetHistogramMetric(
+      metric_inf_request_latency_us_, Metrics::FamilyInferenceRequestLatency(),
+      kLatencyBucketsUs, gpu_device);
+}
 
-  std::map<std::string, std::string> labels;
-  GetMetricLabels(&labels, gpu_device);
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceComputeLatency(int gpu_device) const
+{
+  return GetHistogramMetric(
+      metric_inf_compute_latency_us_, Metrics::FamilyInferenceComputeLatency(),
+      kLatencyBucketsUs, gpu_device);
+}
 
-  prometheus::Histogram& hist = Metrics::FamilyInferenceLoadRatio().Add(
-      labels, std::vector<double>{1.05, 1.10, 1.25, 1.5, 2.0, 10.0, 50.0});
-  metric_inf_load_ratio_.insert(
-      std::map<int, prometheus::Histogram*>::value_type(gpu_device, &hist));
-  return hist;
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceQueueLatency(int gpu_device) const
+{
+  return GetHistogramMetric(
+      metric_inf_queue_latency_us_, Metrics::FamilyInferenceQueueLatency(),
+      kLatencyBucketsUs, gpu_device);
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceLoadRatio(int gpu_device) const
+{
+  return GetHistogramMetric(
+      metric_inf_load_ratio_, Metrics::FamilyInferenceLoadRatio(),
+      std::vector<double>{1.05, 1.10, 1.25, 1.5, 2.0, 10.0, 50.0}, gpu_device);
 }
 
 }}  // namespace nvidia::inferenceserver
@@ -50,11 +50,19 @@ class MetricModelReporter {
   // (if -1 then return non-specialized version of the metric).
   prometheus::Counter& MetricInferenceSuccess(int gpu_device) const;
   prometheus::Counter& MetricInferenceFailure(int gpu_device) const;
+  prometheus::Counter& MetricInferenceTimeout(int gpu_device) const;
   prometheus::Counter& MetricInferenceCount(int gpu_device) const;
   prometheus::Counter& MetricInferenceExecutionCount(int gpu_device) const;
+  prometheus::Counter& MetricInferenceInputCopyBytes(int gpu_device) const;
+  prometheus::Counter& MetricInferenceOutputCopyBytes(int gpu_device) const;
+  prometheus::Counter& MetricInferenceEnsembleTensorPeakBytes(
+      int gpu_device) const;
   prometheus::Counter& MetricInferenceRequestDuration(int gpu_device) const;
   prometheus::Counter& MetricInferenceComputeDuration(int gpu_device) const;
   prometheus::Counter& MetricInferenceQueueDuration(int gpu_device) const;
+  prometheus::Histogram& MetricInferenceRequestLatency(int gpu_device) const;
+  prometheus::Histogram& MetricInferenceComputeLatency(int gpu_device) const;
+  prometheus::Histogram& MetricInferenceQueueLatency(int gpu_device) const;
   prometheus::Histogram& MetricInferenceLoadRatio(int gpu_device) const;
 
  private:
@@ -64,6 +72,10 @@ class MetricModelReporter {
       std::map<int, prometheus::Counter*>& metrics,
       prometheus::Family<prometheus::Counter>& family,
       const int gpu_device) const;
+  prometheus::Histogram& GetHistogramMetric(
+      std::map<int, prometheus::Histogram*>& metrics,
+      prometheus::Family<prometheus::Histogram>& family,
+      const std::vector<double>& buckets, const int gpu_device) const;
 
   const std::string model_name_;
   const int64_t model_version_;
@@ -71,11 +83,19 @@ class MetricModelReporter {
 
   mutable std::map<int, prometheus::Counter*> metric_inf_success_;
   mutable std::map<int, prometheus::Counter*> metric_inf_failure_;
+  mutable std::map<int, prometheus::Counter*> metric_inf_timeout_;
   mutable std::map<int, prometheus::Counter*> metric_inf_count_;
   mutable std::map<int, prometheus::Counter*> metric_inf_exec_count_;
+  mutable std::map<int, prometheus::Counter*> metric_inf_input_copy_bytes_;
+  mutable std::map<int, prometheus::Counter*> metric_inf_output_copy_bytes_;
+  mutable std::map<int, prometheus::Counter*>
+      metric_inf_ensemble_tensor_peak_bytes_;
   mutable std::map<int, prometheus::Counter*> metric_inf_request_duration_us_;
   mutable std::map<int, prometheus::Counter*> metric_inf_compute_duration_us_;
   mutable std::map<int, prometheus::Counter*> metric_inf_queue_duration_us_;
+  mutable std::map<int, prometheus::Histogram*> metric_inf_request_latency_us_;
+  mutable std::map<int, prometheus::Histogram*> metric_inf_compute_latency_us_;
+  mutable std::map<int, prometheus::Histogram*> metric_inf_queue_latency_us_;
   mutable std::map<int, prometheus::Histogram*> metric_inf_load_ratio_;
 };
 
@@ -48,6 +48,13 @@ Metrics::Metrics()
               .Name("nv_inference_request_failure")
               .Help("Number of failed inference requests, all batch sizes")
               .Register(*registry_)),
+      inf_timeout_family_(
+          prometheus::BuildCounter()
+              .Name("nv_inference_request_timeout")
+              .Help(
+                  "Number of inference requests that timed out before "
+                  "execution, all batch sizes")
+              .Register(*registry_)),
       inf_count_family_(prometheus::BuildCounter()
                             .Name("nv_inference_count")
                             .Help("Number of inferences performed")
@@ -56,6 +63,27 @@ Metrics::Metrics()
                                  .Name("nv_inference_exec_count")
                                  .Help("Number of model executions performed")
                                  .Register(*registry_)),
+      inf_input_copy_bytes_family_(
+          prometheus::BuildCounter()
+              .Name("nv_inference_input_copy_bytes")
+              .Help(
+                  "Number of input bytes copied in host memory to gather "
+                  "inference inputs")
+              .Register(*registry_)),
+      inf_output_copy_bytes_family_(
+          prometheus::BuildCounter()
+              .Name("nv_inference_output_copy_bytes")
+              .Help(
+                  "Number of output bytes copied in host memory to return "
+                  "inference outputs")
+              .Register(*registry_)),
+      inf_ensemble_tensor_peak_bytes_family_(
+          prometheus::BuildCounter()
+              .Name("nv_inference_ensemble_tensor_peak_bytes")
+              .Help(
+                  "Cummulative peak bytes of intermediate tensors held by "
+                  "each ensemble inference request")
+              .Register(*registry_)),
       inf_request_duration_us_family_(
           prometheus::BuildCounter()
               .Name("nv_inference_request_duration_us")
@@ -71,6 +99,21 @@ Metrics::Metrics()
               .Name("nv_inference_queue_duration_us")
               .Help("Cummulative inference queuing duration in microseconds")
               .Register(*registry_)),
+      inf_request_latency_us_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_request_latency_us")
+              .Help("Histogram of inference request duration in microseconds")
+              .Register(*registry_)),
+      inf_compute_latency_us_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_compute_latency_us")
+              .Help("Histogram of inference compute duration in microseconds")
+              .Register(*registry_)),
+      inf_queue_latency_us_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_queue_latency_us")
+              .Help("Histogram of inference queuing duration in microseconds")
+              .Register(*registry_)),
       inf_load_ratio_family_(prometheus::BuildHistogram()
                                  .Name("nv_inference_load_ratio")
                                  .Register(*registry_)),
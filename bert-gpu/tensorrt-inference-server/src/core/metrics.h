@@ -56,6 +56,13 @@ class Metrics {
     return GetSingleton()->inf_failure_family_;
   }
 
+  // Metric family counting inference requests that timed out before
+  // they could be executed
+  static prometheus::Family<prometheus::Counter>& FamilyInferenceTimeout()
+  {
+    return GetSingleton()->inf_timeout_family_;
+  }
+
   // Metric family counting inferences performed, where a batch-size
   // 'n' inference request is counted as 'n' inferences
   static prometheus::Family<prometheus::Counter>& FamilyInferenceCount()
@@ -71,6 +78,30 @@ class Metrics {
     return GetSingleton()->inf_count_exec_family_;
   }
 
+  // Metric family of cumulative input bytes that were copied in host
+  // memory to gather inference inputs
+  static prometheus::Family<prometheus::Counter>&
+  FamilyInferenceInputCopyBytes()
+  {
+    return GetSingleton()->inf_input_copy_bytes_family_;
+  }
+
+  // Metric family of cumulative output bytes that were copied in host
+  // memory to return inference outputs
+  static prometheus::Family<prometheus::Counter>&
+  FamilyInferenceOutputCopyBytes()
+  {
+    return GetSingleton()->inf_output_copy_bytes_family_;
+  }
+
+  // Metric family of cumulative peak bytes of intermediate tensors
+  // held by each ensemble inference request
+  static prometheus::Family<prometheus::Counter>&
+  FamilyInferenceEnsembleTensorPeakBytes()
+  {
+    return GetSingleton()->inf_ensemble_tensor_peak_bytes_family_;
+  }
+
   // Metric family of cumulative inference request duration, in
   // microseconds
   static prometheus::Family<prometheus::Counter>&
@@ -94,6 +125,30 @@ class Metrics {
     return GetSingleton()->inf_queue_duration_us_family_;
   }
 
+  // Metric family of inference request duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceRequestLatency()
+  {
+    return GetSingleton()->inf_request_latency_us_family_;
+  }
+
+  // Metric family of inference compute duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceComputeLatency()
+  {
+    return GetSingleton()->inf_compute_latency_us_family_;
+  }
+
+  // Metric family of inference queuing duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceQueueLatency()
+  {
+    return GetSingleton()->inf_queue_latency_us_family_;
+  }
+
   // Metric family of load-ratio histogram
   static prometheus::Family<prometheus::Histogram>& FamilyInferenceLoadRatio()
   {
@@ -110,11 +165,19 @@ class Metrics {
 
   prometheus::Family<prometheus::Counter>& inf_success_family_;
   prometheus::Family<prometheus::Counter>& inf_failure_family_;
+  prometheus::Family<prometheus::Counter>& inf_timeout_family_;
   prometheus::Family<prometheus::Counter>& inf_count_family_;
   prometheus::Family<prometheus::Counter>& inf_count_exec_family_;
+  prometheus::Family<prometheus::Counter>& inf_input_copy_bytes_family_;
+  prometheus::Family<prometheus::Counter>& inf_output_copy_bytes_family_;
+  prometheus::Family<prometheus::Counter>&
+      inf_ensemble_tensor_peak_bytes_family_;
   prometheus::Family<prometheus::Counter>& inf_request_duration_us_family_;
   prometheus::Family<prometheus::Counter>& inf_compute_duration_us_family_;
   prometheus::Family<prometheus::Counter>& inf_queue_duration_us_family_;
+  prometheus::Family<prometheus::Histogram>& inf_request_latency_us_family_;
+  prometheus::Family<prometheus::Histogram>& inf_compute_latency_us_family_;
+  prometheus::Family<prometheus::Histogram>& inf_queue_latency_us_family_;
   prometheus::Family<prometheus::Histogram>& inf_load_ratio_family_;
   prometheus::Family<prometheus::Gauge>& gpu_utilization_family_;
   prometheus::Family<prometheus::Gauge>& gpu_memory_total_family_;
@@ -377,8 +377,26 @@ ValidateModelConfig(
 
   // If dynamic batching is specified make sure the preferred batch
   // sizes are positive and don't exceed maximum batch size. Make sure
-  // the max delay is non-negative.
+  // the max delay is non-negative. Make sure the number of priority
+  // levels is within the supported range and that the default
+  // priority level is one of the priority levels.
   if (config.has_dynamic_batching()) {
+    const auto& batcher = config.dynamic_batching();
+    if (batcher.priority_levels() > SCHEDULER_MAX_PRIORITY_LEVELS) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "dynamic batching priority levels must be <= " +
+              std::to_string(SCHEDULER_MAX_PRIORITY_LEVELS) + " for " +
+              config.name());
+    }
+    if (batcher.default_priority_level() > batcher.priority_levels()) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "dynamic batching default priority level must be <= priority "
+          "levels for " +
+              config.name());
+    }
+
     for (const auto size : config.dynamic_batching().preferred_batch_size()) {
       if (size <= 0) {
         return Status(
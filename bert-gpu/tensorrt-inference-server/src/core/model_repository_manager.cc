@@ -28,6 +28,8 @@
 #include "src/core/model_repository_manager.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <stdexcept>
 #include <thread>
@@ -52,6 +54,7 @@
 #include "src/core/filesystem.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/ready_backends.h"
 #include "src/core/server_status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -273,6 +276,7 @@ class ModelRepositoryManager::BackendLifeCycle {
  public:
   static Status Create(
       const PlatformConfigMap& platform_map, const std::string& repository_path,
+      const uint32_t load_thread_count,
       std::unique_ptr<BackendLifeCycle>* life_cycle);
 
   ~BackendLifeCycle();
@@ -298,13 +302,19 @@ class ModelRepositoryManager::BackendLifeCycle {
   // Get the VersionStateMap representation of the specified model.
   const VersionStateMap GetVersionStates(const std::string& model_name);
 
+  // Get the load duration of each loaded version of the specified
+  // model.
+  const VersionLoadDurationMap GetVersionLoadDurations(
+      const std::string& model_name);
+
  private:
   struct BackendInfo {
     BackendInfo(
         const ModelReadyState state, const ActionType next_action,
         const ModelConfig& model_config)
         : platform_(GetPlatform(model_config.platform())), state_(state),
-          next_action_(next_action), model_config_(model_config)
+          next_action_(next_action), model_config_(model_config),
+          load_duration_ns_(0)
     {
     }
 
@@ -318,10 +328,33 @@ class ModelRepositoryManager::BackendLifeCycle {
     ActionType next_action_;
     ModelConfig model_config_;
 
+    // The time taken by the last successful load, or 0 if the backend
+    // has not been loaded.
+    uint64_t load_duration_ns_;
+
     std::shared_ptr<BackendHandle> handle_;
   };
 
-  BackendLifeCycle(const std::string& repository_path);
+  // A backend load waiting for a load thread. The load is deferred
+  // while any of the models in 'dependencies_' is being loaded.
+  struct LoadTask {
+    std::string model_name_;
+    int64_t version_;
+    BackendInfo* backend_info_;
+    std::set<std::string> dependencies_;
+  };
+
+  BackendLifeCycle(
+      const std::string& repository_path, const uint32_t load_thread_count);
+
+  // Queue the load of the backend for a load thread. Caller must
+  // obtain the mutex of 'backend_info' before calling this function
+  void EnqueueLoad(
+      const std::string& model_name, const int64_t version,
+      BackendInfo* backend_info);
+
+  // Load backends from 'load_queue_' until exiting.
+  void LoadThread();
 
   // Caller must obtain the mutex of 'backend_info' before calling this function
   Status Load(
@@ -343,17 +376,41 @@ class ModelRepositoryManager::BackendLifeCycle {
       const std::string& model_name, const int64_t version,
       BackendInfo* backend_info);
 
+  // Get the backend handle by examining the state of each version.
+  // Used to produce the appropriate error when the version is not
+  // found in 'ready_backends_'.
+  Status GetBackendHandleLocked(
+      const std::string& model_name, const int64_t version,
+      std::shared_ptr<BackendHandle>* handle);
+
   using VersionMap = std::map<int64_t, std::unique_ptr<BackendInfo>>;
   using BackendMap = std::map<std::string, VersionMap>;
   BackendMap map_;
   std::mutex map_mtx_;
 
+  // The handles of the versions in MODEL_READY state, used to resolve
+  // the backend of each request without acquiring 'map_mtx_'. Updated
+  // whenever 'handle_' of a BackendInfo is set or reset.
+  ReadyBackends ready_backends_;
+
   // Variables as workaround to issue mentioned in ~BackendHandleImpl()
   bool exiting_;
   std::thread release_thread_;
   std::mutex release_queue_mtx_;
   std::deque<std::unique_ptr<InferenceBackend>> release_queue_;
 
+  // The threads that create the backends, and the loads waiting for
+  // them. 'loading_cnt_' is the number of queued or running loads for
+  // each model, used to load the models that an ensemble depends on
+  // before the ensemble.
+  std::vector<std::thread> load_threads_;
+  std::mutex load_mtx_;
+  std::condition_variable load_cv_;
+  bool load_exiting_;
+  std::deque<LoadTask> load_queue_;
+  std::unordered_map<std::string, size_t> loading_cnt_;
+  size_t running_load_cnt_;
+
   const std::string& repository_path_;
   std::unique_ptr<NetDefBackendFactory> netdef_factory_;
   std::unique_ptr<CustomBackendFactory> custom_factory_;
@@ -366,9 +423,14 @@ class ModelRepositoryManager::BackendLifeCycle {
 };
 
 ModelRepositoryManager::BackendLifeCycle::BackendLifeCycle(
-    const std::string& repository_path)
-    : exiting_(false), repository_path_(repository_path)
+    const std::string& repository_path, const uint32_t load_thread_count)
+    : exiting_(false), load_exiting_(false), running_load_cnt_(0),
+      repository_path_(repository_path)
 {
+  for (uint32_t i = 0; i < std::max(1u, load_thread_count); ++i) {
+    load_threads_.emplace_back([this]() { LoadThread(); });
+  }
+
   release_thread_ = std::thread([this]() {
     {
       std::vector<std::unique_ptr<InferenceBackend>> releasing_backend;
@@ -392,6 +454,24 @@ ModelRepositoryManager::BackendLifeCycle::BackendLifeCycle(
 
 ModelRepositoryManager::BackendLifeCycle::~BackendLifeCycle()
 {
+  // Loads that have not started are abandoned, and their versions
+  // become unavailable instead of staying in the loading state.
+  {
+    std::lock_guard<std::mutex> lock(load_mtx_);
+    load_exiting_ = true;
+    load_cv_.notify_all();
+  }
+  for (auto& thd : load_threads_) {
+    thd.join();
+  }
+  for (auto& task : load_queue_) {
+    std::lock_guard<std::mutex> lock(task.backend_info_->mtx_);
+    task.backend_info_->state_ = ModelReadyState::MODEL_UNAVAILABLE;
+    task.backend_info_->next_action_ = ActionType::NO_ACTION;
+  }
+  load_queue_.clear();
+  loading_cnt_.clear();
+
   {
     std::lock_guard<std::mutex> lock(release_queue_mtx_);
     exiting_ = true;
@@ -404,10 +484,11 @@ ModelRepositoryManager::BackendLifeCycle::~BackendLifeCycle()
 Status
 ModelRepositoryManager::BackendLifeCycle::Create(
     const PlatformConfigMap& platform_map, const std::string& repository_path,
+    const uint32_t load_thread_count,
     std::unique_ptr<BackendLifeCycle>* life_cycle)
 {
   std::unique_ptr<BackendLifeCycle> local_life_cycle(
-      new BackendLifeCycle(repository_path));
+      new BackendLifeCycle(repository_path, load_thread_count));
 
   {
     GraphDefPlatformConfig config;
@@ -508,6 +589,26 @@ ModelRepositoryManager::BackendLifeCycle::GetVersionStates(
   return version_map;
 }
 
+const ModelRepositoryManager::VersionLoadDurationMap
+ModelRepositoryManager::BackendLifeCycle::GetVersionLoadDurations(
+    const std::string& model_name)
+{
+  std::lock_guard<std::mutex> map_lock(map_mtx_);
+  VersionLoadDurationMap duration_map;
+  auto mit = map_.find(model_name);
+  if (mit != map_.end()) {
+    for (auto& version_backend : mit->second) {
+      std::lock_guard<std::mutex> lock(version_backend.second->mtx_);
+      if (version_backend.second->load_duration_ns_ != 0) {
+        duration_map[version_backend.first] =
+            version_backend.second->load_duration_ns_;
+      }
+    }
+  }
+
+  return duration_map;
+}
+
 Status
 ModelRepositoryManager::BackendLifeCycle::GetBackendHandle(
     const std::string& model_name, const int64_t version,
@@ -515,6 +616,18 @@ ModelRepositoryManager::BackendLifeCycle::GetBackendHandle(
 {
   LOG_VERBOSE(1) << "GetBackendHandle() '" << model_name << "' version "
                  << version;
+  if (ready_backends_.Get(model_name, version, handle)) {
+    return Status::Success;
+  }
+
+  return GetBackendHandleLocked(model_name, version, handle);
+}
+
+Status
+ModelRepositoryManager::BackendLifeCycle::GetBackendHandleLocked(
+    const std::string& model_name, const int64_t version,
+    std::shared_ptr<BackendHandle>* handle)
+{
   std::lock_guard<std::mutex> map_lock(map_mtx_);
   auto mit = map_.find(model_name);
   if (mit == map_.end()) {
@@ -626,18 +739,83 @@ ModelRepositoryManager::BackendLifeCycle::Load(
     default:
       LOG_INFO << "loading: " << model_name << ":" << version;
       backend_info->state_ = ModelReadyState::MODEL_LOADING;
-      {
-        std::thread worker(
-            &ModelRepositoryManager::BackendLifeCycle::CreateBackendHandle,
-            this, model_name, version, backend_info);
-        worker.detach();
-      }
+      EnqueueLoad(model_name, version, backend_info);
       break;
   }
 
   return status;
 }
 
+void
+ModelRepositoryManager::BackendLifeCycle::EnqueueLoad(
+    const std::string& model_name, const int64_t version,
+    BackendInfo* backend_info)
+{
+  LoadTask task;
+  task.model_name_ = model_name;
+  task.version_ = version;
+  task.backend_info_ = backend_info;
+  for (const auto& step :
+       backend_info->model_config_.ensemble_scheduling().step()) {
+    if (step.model_name() != model_name) {
+      task.dependencies_.insert(step.model_name());
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(load_mtx_);
+  load_queue_.emplace_back(std::move(task));
+  loading_cnt_[model_name]++;
+  load_cv_.notify_one();
+}
+
+void
+ModelRepositoryManager::BackendLifeCycle::LoadThread()
+{
+  std::unique_lock<std::mutex> lock(load_mtx_);
+  while (!load_exiting_) {
+    // Take the first load whose dependencies are all loaded. If no
+    // load is running then nothing can change the state of the
+    // dependencies, so take the first load regardless.
+    auto it = load_queue_.begin();
+    for (; it != load_queue_.end(); ++it) {
+      bool ready = true;
+      for (const auto& dependency : it->dependencies_) {
+        auto cit = loading_cnt_.find(dependency);
+        if ((cit != loading_cnt_.end()) && (cit->second != 0)) {
+          ready = false;
+          break;
+        }
+      }
+      if (ready) {
+        break;
+      }
+    }
+    if ((it == load_queue_.end()) && (running_load_cnt_ == 0) &&
+        !load_queue_.empty()) {
+      it = load_queue_.begin();
+    }
+
+    if (it == load_queue_.end()) {
+      load_cv_.wait(lock);
+      continue;
+    }
+
+    LoadTask task = std::move(*it);
+    load_queue_.erase(it);
+    running_load_cnt_++;
+
+    lock.unlock();
+    CreateBackendHandle(task.model_name_, task.version_, task.backend_info_);
+    lock.lock();
+
+    running_load_cnt_--;
+    if (--loading_cnt_[task.model_name_] == 0) {
+      loading_cnt_.erase(task.model_name_);
+    }
+    load_cv_.notify_all();
+  }
+}
+
 Status
 ModelRepositoryManager::BackendLifeCycle::Unload(
     const std::string& model_name, const int64_t version,
@@ -652,6 +830,7 @@ ModelRepositoryManager::BackendLifeCycle::Unload(
     case ModelReadyState::MODEL_READY:
       LOG_INFO << "unloading: " << model_name << ":" << version;
       backend_info->state_ = ModelReadyState::MODEL_UNLOADING;
+      ready_backends_.SetNotReady(model_name, version);
       backend_info->handle_.reset();
       break;
     case ModelReadyState::MODEL_LOADING:
@@ -688,6 +867,7 @@ ModelRepositoryManager::BackendLifeCycle::CreateBackendHandle(
   }
 
   // Create backend
+  const auto load_start = std::chrono::steady_clock::now();
   Status status;
   std::unique_ptr<InferenceBackend> is;
   switch (backend_info->platform_) {
@@ -723,6 +903,11 @@ ModelRepositoryManager::BackendLifeCycle::CreateBackendHandle(
       break;
   }
 
+  const uint64_t load_duration_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - load_start)
+          .count();
+
   // Update backend state
   std::lock_guard<std::mutex> lock(backend_info->mtx_);
   // Sanity check
@@ -745,6 +930,7 @@ ModelRepositoryManager::BackendLifeCycle::CreateBackendHandle(
             {
               std::lock_guard<std::mutex> lock(backend_info->mtx_);
               backend_info->state_ = ModelReadyState::MODEL_UNAVAILABLE;
+              backend_info->load_duration_ns_ = 0;
               // Check if next action is requested
               this->TriggerNextAction(model_name, version, backend_info);
             }
@@ -755,12 +941,15 @@ ModelRepositoryManager::BackendLifeCycle::CreateBackendHandle(
               this->release_queue_.emplace_back(std::move(is));
             }
           }));
+      ready_backends_.SetReady(model_name, version, backend_info->handle_);
+      backend_info->load_duration_ns_ = load_duration_ns;
       LOG_INFO << "successfully loaded '" << model_name << "' version "
-               << version;
+               << version << " in " << (load_duration_ns / 1000000) << " ms";
     } else {
       LOG_ERROR << "failed to load '" << model_name << "' version " << version
                 << ": " << status.AsString();
       backend_info->state_ = ModelReadyState::MODEL_UNAVAILABLE;
+      backend_info->load_duration_ns_ = 0;
     }
   }
 
@@ -797,10 +986,14 @@ ModelRepositoryManager::ModelRepositoryManager(
     const std::shared_ptr<ServerStatusManager>& status_manager,
     const std::string& repository_path,
     const PlatformConfigMap& platform_config_map, const bool autofill,
-    const bool polling_enabled, std::unique_ptr<BackendLifeCycle> life_cycle)
+    const bool polling_enabled, const uint32_t model_load_thread_count,
+    std::unique_ptr<BackendLifeCycle> life_cycle)
     : repository_path_(repository_path),
       platform_config_map_(platform_config_map), autofill_(autofill),
-      polling_enabled_(polling_enabled), status_manager_(status_manager),
+      polling_enabled_(polling_enabled),
+      model_load_thread_count_(std::max(1u, model_load_thread_count)),
+      pending_full_scan_(false),
+      status_manager_(status_manager),
       backend_life_cycle_(std::move(life_cycle))
 {
 }
@@ -814,6 +1007,7 @@ ModelRepositoryManager::Create(
     const std::string& repository_path, const bool strict_model_config,
     const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
     const uint32_t repository_poll_secs, const bool polling_enabled,
+    const uint32_t model_load_thread_count,
     std::unique_ptr<ModelRepositoryManager>* model_repository_manager)
 {
   // The rest only matters if repository path is valid directory
@@ -833,13 +1027,27 @@ ModelRepositoryManager::Create(
 
   std::unique_ptr<BackendLifeCycle> life_cycle;
   RETURN_IF_ERROR(BackendLifeCycle::Create(
-      platform_config_map, repository_path, &life_cycle));
+      platform_config_map, repository_path, model_load_thread_count,
+      &life_cycle));
 
   // Not setting the smart pointer directly to simplify clean up
   std::unique_ptr<ModelRepositoryManager> local_manager(
       new ModelRepositoryManager(
           status_manager, repository_path, platform_config_map,
-          !strict_model_config, polling_enabled, std::move(life_cycle)));
+          !strict_model_config, polling_enabled, model_load_thread_count,
+          std::move(life_cycle)));
+
+  // Watch the repository so that a periodic poll only examines the
+  // models that changed. The watch starts before the initial poll so
+  // that no change made after it is missed.
+  if (polling_enabled && (repository_poll_secs > 0)) {
+    Status status =
+        RepositoryWatcher::Create(repository_path, &local_manager->watcher_);
+    if (!status.IsOk()) {
+      LOG_INFO << "Polling all models for model repository changes: "
+               << status.Message();
+    }
+  }
 
   // Similar to PollAndUpdate(), but simplier
   std::set<std::string> added, deleted, modified, unmodified;
@@ -853,7 +1061,11 @@ ModelRepositoryManager::Create(
         "Unexpected initial state for model repository");
   }
 
-  for (const auto& name : added) {
+  // Queue the composing models of an ensemble before the ensemble so
+  // that the ensemble is loaded after them.
+  std::vector<std::string> load_order;
+  local_manager->DependencyOrder(added, &load_order);
+  for (const auto& name : load_order) {
     ModelConfig model_config;
     RETURN_IF_ERROR(local_manager->GetModelConfig(name, &model_config));
     RETURN_IF_ERROR(
@@ -885,8 +1097,11 @@ ModelRepositoryManager::PollAndUpdate()
   }
 
   // Added models should be loaded and be initialized for status
-  // reporting.
-  for (const auto& name : added) {
+  // reporting. The composing models of an ensemble are queued before
+  // the ensemble so that the ensemble is loaded after them.
+  std::vector<std::string> load_order;
+  DependencyOrder(added, &load_order);
+  for (const auto& name : load_order) {
     ModelConfig model_config;
     RETURN_IF_ERROR(GetModelConfig(name, &model_config));
     RETURN_IF_ERROR(status_manager_->InitForModel(name, model_config));
@@ -899,7 +1114,8 @@ ModelRepositoryManager::PollAndUpdate()
   // If there are any modified model, (re)load them to pick up
   // the changes. We want to keep the current status information
   // so don't re-init it.
-  for (const auto& name : modified) {
+  DependencyOrder(modified, &load_order);
+  for (const auto& name : load_order) {
     ModelConfig model_config;
     RETURN_IF_ERROR(GetModelConfig(name, &model_config));
     RETURN_IF_ERROR(status_manager_->UpdateConfigForModel(name, model_config));
@@ -965,6 +1181,12 @@ ModelRepositoryManager::GetVersionStates(const std::string& model_name)
   return backend_life_cycle_->GetVersionStates(model_name);
 }
 
+const ModelRepositoryManager::VersionLoadDurationMap
+ModelRepositoryManager::GetVersionLoadDurations(const std::string& model_name)
+{
+  return backend_life_cycle_->GetVersionLoadDurations(model_name);
+}
+
 Status
 ModelRepositoryManager::GetBackendHandle(
     const std::string& model_name, const int64_t model_version,
@@ -999,10 +1221,51 @@ ModelRepositoryManager::Poll(
   // during processing.
   ModelInfoMap new_infos;
 
+  // Only the models reported by the watcher can have changed. If
+  // there is no watcher every model is examined. The changes are kept
+  // until a poll succeeds so that they are examined again after an
+  // error.
+  const std::set<std::string>& changed = pending_changes_;
+  bool full_scan = true;
+  if (watcher_ != nullptr) {
+    std::set<std::string> new_changes;
+    bool new_full_scan;
+    Status status = watcher_->Changes(&new_changes, &new_full_scan);
+    if (!status.IsOk()) {
+      LOG_ERROR << "Failed to read model repository changes: "
+                << status.AsString();
+      new_full_scan = true;
+    }
+
+    pending_changes_.insert(new_changes.begin(), new_changes.end());
+    pending_full_scan_ = pending_full_scan_ || new_full_scan;
+    full_scan = pending_full_scan_;
+  }
+
   // Each subdirectory of repository path is a model directory from
   // which we read the model configuration.
   std::set<std::string> subdirs;
-  RETURN_IF_ERROR(GetDirectorySubdirs(repository_path_, &subdirs));
+  if (full_scan) {
+    RETURN_IF_ERROR(GetDirectorySubdirs(repository_path_, &subdirs));
+  } else {
+    for (const auto& pr : infos_) {
+      subdirs.insert(pr.first);
+    }
+    for (const auto& child : changed) {
+      bool is_dir = false;
+      Status status =
+          IsDirectory(JoinPath({repository_path_, child}), &is_dir);
+      if (status.IsOk() && is_dir) {
+        subdirs.insert(child);
+      } else {
+        subdirs.erase(child);
+      }
+    }
+  }
+
+  // The models whose configuration must be read, with the
+  // modification time of each.
+  std::vector<std::pair<std::string, int64_t>> need_load_models;
 
   for (const auto& child : subdirs) {
     const auto full_path = JoinPath({repository_path_, child});
@@ -1019,7 +1282,9 @@ ModelRepositoryManager::Poll(
       need_load = true;
     } else {
       mtime_ns = iitr->second->mtime_nsec_;
-      if (IsModified(std::string(full_path), &mtime_ns)) {
+      const bool check_modified =
+          full_scan || (changed.find(child) != changed.end());
+      if (check_modified && IsModified(std::string(full_path), &mtime_ns)) {
         modified->insert(child);
         need_load = true;
       } else {
@@ -1037,39 +1302,45 @@ ModelRepositoryManager::Poll(
     }
 
     if (need_load) {
-      const auto& ret = new_infos.emplace(child, nullptr);
-      if (!ret.second) {
-        return Status(
-            RequestStatusCode::ALREADY_EXISTS,
-            "unexpected model info for model '" + child + "'");
-      }
+      need_load_models.emplace_back(child, mtime_ns);
+    }
+  }
 
-      std::unique_ptr<ModelInfo>& model_info = ret.first->second;
-      model_info.reset(new ModelInfo());
-      ModelConfig& model_config = model_info->model_config_;
-      model_info->mtime_nsec_ = mtime_ns;
-
-      // If enabled, try to automatically generate missing parts of
-      // the model configuration (autofill) from the model
-      // definition. In all cases normalize and validate the config.
-      RETURN_IF_ERROR(GetNormalizedModelConfig(
-          full_path, platform_config_map_, autofill_, &model_config));
-      RETURN_IF_ERROR(ValidateModelConfig(model_config, std::string()));
-
-      model_info->platform_ = GetPlatform(model_config.platform());
-
-      // Make sure the name of the model matches the name of the
-      // directory. This is a somewhat arbitrary requirement but seems
-      // like good practice to require it of the user. It also acts as a
-      // check to make sure we don't have two different models with the
-      // same name.
-      if (model_config.name() != child) {
-        return Status(
-            RequestStatusCode::INVALID_ARG,
-            "unexpected directory name '" + child + "' for model '" +
-                model_config.name() +
-                "', directory name must equal model name");
-      }
+  // Read the configurations on multiple threads as autofill may need
+  // to read the model definition, which is slow for large models.
+  std::vector<std::unique_ptr<ModelInfo>> model_infos(
+      need_load_models.size());
+  std::vector<Status> read_status(need_load_models.size());
+  std::atomic<size_t> next_model(0);
+  auto read_fn = [this, &need_load_models, &model_infos, &read_status,
+                  &next_model]() {
+    size_t idx;
+    while ((idx = next_model++) < need_load_models.size()) {
+      read_status[idx] = ReadModelInfo(
+          need_load_models[idx].first, need_load_models[idx].second,
+          &model_infos[idx]);
+    }
+  };
+
+  std::vector<std::thread> read_threads;
+  const size_t read_thread_cnt =
+      std::min((size_t)model_load_thread_count_, need_load_models.size());
+  for (size_t i = 1; i < read_thread_cnt; ++i) {
+    read_threads.emplace_back(read_fn);
+  }
+  read_fn();
+  for (auto& thd : read_threads) {
+    thd.join();
+  }
+
+  for (size_t idx = 0; idx < need_load_models.size(); ++idx) {
+    RETURN_IF_ERROR(read_status[idx]);
+    const std::string& child = need_load_models[idx].first;
+    const auto& ret = new_infos.emplace(child, std::move(model_infos[idx]));
+    if (!ret.second) {
+      return Status(
+          RequestStatusCode::ALREADY_EXISTS,
+          "unexpected model info for model '" + child + "'");
     }
   }
 
@@ -1090,9 +1361,76 @@ ModelRepositoryManager::Poll(
     infos_.swap(new_infos);
   }
 
+  pending_changes_.clear();
+  pending_full_scan_ = false;
+
+  return Status::Success;
+}
+
+
+Status
+ModelRepositoryManager::ReadModelInfo(
+    const std::string& name, const int64_t mtime_ns,
+    std::unique_ptr<ModelInfo>* model_info)
+{
+  const auto full_path = JoinPath({repository_path_, name});
+
+  model_info->reset(new ModelInfo());
+  ModelConfig& model_config = (*model_info)->model_config_;
+  (*model_info)->mtime_nsec_ = mtime_ns;
+
+  // If enabled, try to automatically generate missing parts of the
+  // model configuration (autofill) from the model definition. In all
+  // cases normalize and validate the config.
+  RETURN_IF_ERROR(GetNormalizedModelConfig(
+      full_path, platform_config_map_, autofill_, &model_config));
+  RETURN_IF_ERROR(ValidateModelConfig(model_config, std::string()));
+
+  (*model_info)->platform_ = GetPlatform(model_config.platform());
+
+  // Make sure the name of the model matches the name of the
+  // directory. This is a somewhat arbitrary requirement but seems like
+  // good practice to require it of the user. It also acts as a check to
+  // make sure we don't have two different models with the same name.
+  if (model_config.name() != name) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unexpected directory name '" + name + "' for model '" +
+            model_config.name() + "', directory name must equal model name");
+  }
+
   return Status::Success;
 }
 
+void
+ModelRepositoryManager::DependencyOrder(
+    const std::set<std::string>& names, std::vector<std::string>* ordered)
+{
+  ordered->clear();
+
+  std::set<std::string> visited;
+  std::function<void(const std::string&)> visit =
+      [this, &names, &visited, &visit, ordered](const std::string& name) {
+        if (!visited.insert(name).second) {
+          return;
+        }
+
+        ModelConfig model_config;
+        if (GetModelConfig(name, &model_config).IsOk()) {
+          for (const auto& step : model_config.ensemble_scheduling().step()) {
+            if (names.find(step.model_name()) != names.end()) {
+              visit(step.model_name());
+            }
+          }
+        }
+
+        ordered->push_back(name);
+      };
+
+  for (const auto& name : names) {
+    visit(name);
+  }
+}
 
 Status
 ModelRepositoryManager::GetModelConfig(
@@ -29,6 +29,7 @@
 #include <mutex>
 #include "src/core/model_config.h"
 #include "src/core/model_config.pb.h"
+#include "src/core/repository_watcher.h"
 #include "src/core/server_status.pb.h"
 #include "src/core/status.h"
 
@@ -42,6 +43,7 @@ class ModelRepositoryManager {
  public:
   using VersionStateMap = std::map<int64_t, ModelReadyState>;
   using ModelStateMap = std::map<std::string, VersionStateMap>;
+  using VersionLoadDurationMap = std::map<int64_t, uint64_t>;
 
   enum ActionType { NO_ACTION, LOAD, UNLOAD };
 
@@ -74,6 +76,8 @@ class ModelRepositoryManager {
   /// \param polling_enabled If true, then PollAndUpdate() is allowed and
   /// LoadUnloadModel() is not allowed. If false, LoadUnloadModel() is allowed
   /// and PollAndUpdate() is not allowed.
+  /// \param model_load_thread_count The number of threads used to read
+  /// model configurations and to load models concurrently.
   /// \return The error status.
   static Status Create(
       const std::string& server_version,
@@ -81,6 +85,7 @@ class ModelRepositoryManager {
       const std::string& repository_path, const bool strict_model_config,
       const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
       const uint32_t repository_poll_secs, const bool polling_enabled,
+      const uint32_t model_load_thread_count,
       std::unique_ptr<ModelRepositoryManager>* model_repository_manager);
 
   /// Poll the model repository to determine the new set of models and
@@ -117,6 +122,12 @@ class ModelRepositoryManager {
   /// publish the version state changes via that mirror function.
   const VersionStateMap GetVersionStates(const std::string& model_name);
 
+  /// \param model_name The model to get load durations from.
+  /// \return the time taken to load each version of the specified
+  /// model, in nanoseconds, for the versions that have been loaded.
+  const VersionLoadDurationMap GetVersionLoadDurations(
+      const std::string& model_name);
+
   /// Obtain the specified backend handle.
   /// \param model_name The model name of the backend handle.
   /// \param model_version The model version of the backend handle.
@@ -138,11 +149,14 @@ class ModelRepositoryManager {
       const std::shared_ptr<ServerStatusManager>& status_manager,
       const std::string& repository_path,
       const PlatformConfigMap& platform_config_map, const bool autofill,
-      const bool polling_enabled, std::unique_ptr<BackendLifeCycle> life_cycle);
+      const bool polling_enabled, const uint32_t model_load_thread_count,
+      std::unique_ptr<BackendLifeCycle> life_cycle);
 
   /// Poll the model repository to determine the new set of models and
   /// compare with the current set. Return the additions, deletions,
-  /// and modifications that have occurred since the last Poll().
+  /// and modifications that have occurred since the last Poll(). If
+  /// the repository is watched only the models reported as changed by
+  /// the watcher are examined.
   /// \param added The names of the models added to the repository.
   /// \param deleted The names of the models removed from the repository.
   /// \param modified The names of the models remaining in the
@@ -154,6 +168,22 @@ class ModelRepositoryManager {
       std::set<std::string>* added, std::set<std::string>* deleted,
       std::set<std::string>* modified, std::set<std::string>* unmodified);
 
+  /// Read, normalize and validate the configuration of a model.
+  /// \param name The model name.
+  /// \param mtime_ns The modification time of the model directory.
+  /// \param model_info Returns the information of the model.
+  /// \return The error status.
+  Status ReadModelInfo(
+      const std::string& name, const int64_t mtime_ns,
+      std::unique_ptr<ModelInfo>* model_info);
+
+  /// Order models so that each model comes after the models in
+  /// 'names' that it depends on as an ensemble.
+  /// \param names The model names.
+  /// \param ordered Returns the model names in dependency order.
+  void DependencyOrder(
+      const std::set<std::string>& names, std::vector<std::string>* ordered);
+
   /// Get the configuration for a named model.
   /// \param name The model name.
   /// \param model_config Returns the model configuration.
@@ -180,11 +210,21 @@ class ModelRepositoryManager {
   const PlatformConfigMap platform_config_map_;
   const bool autofill_;
   const bool polling_enabled_;
+  const uint32_t model_load_thread_count_;
 
   std::mutex poll_mu_;
   std::mutex infos_mu_;
   ModelInfoMap infos_;
 
+  // Watches the repository for changes, or nullptr if every model
+  // must be examined on each poll.
+  std::unique_ptr<RepositoryWatcher> watcher_;
+
+  // The changes reported by the watcher that have not yet been
+  // applied by a successful Poll().
+  std::set<std::string> pending_changes_;
+  bool pending_full_scan_;
+
   std::shared_ptr<ServerStatusManager> status_manager_;
 
   std::unique_ptr<BackendLifeCycle> backend_life_cycle_;
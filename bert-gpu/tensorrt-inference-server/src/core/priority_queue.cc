@@ -0,0 +1,192 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/priority_queue.h"
+
+#include <algorithm>
+#include "src/core/constants.h"
+
+namespace nvidia { namespace inferenceserver {
+
+PriorityQueue::PriorityQueue(
+    const uint32_t level_cnt, const uint64_t max_queue_delay_ns)
+    : max_queue_delay_ns_(max_queue_delay_ns),
+      levels_(std::max(level_cnt, (uint32_t)1)), size_(0),
+      cursor_valid_(false), cursor_level_(0), cursor_pos_(0)
+{
+}
+
+uint64_t
+PriorityQueue::EnqueueTimeNs(const Scheduler::Payload& payload)
+{
+  const struct timespec& queued = payload.queue_timer_->StartTimeStamp();
+  return queued.tv_sec * NANOS_PER_SECOND + queued.tv_nsec;
+}
+
+void
+PriorityQueue::Enqueue(const uint32_t level, Scheduler::Payload&& payload)
+{
+  levels_[std::min(level, (uint32_t)(levels_.size() - 1))].emplace_back(
+      std::move(payload));
+  size_++;
+  cursor_valid_ = false;
+}
+
+Scheduler::Payload
+PriorityQueue::Dequeue()
+{
+  std::deque<Scheduler::Payload>* queue = &front_;
+  for (size_t level = 0; queue->empty(); ++level) {
+    queue = &levels_[level];
+  }
+
+  Scheduler::Payload payload(std::move(queue->front()));
+  queue->pop_front();
+  size_--;
+  cursor_valid_ = false;
+  return payload;
+}
+
+Scheduler::Payload&
+PriorityQueue::At(const size_t pos)
+{
+  if (pos < front_.size()) {
+    return front_[pos];
+  }
+
+  // Resume from the level found by the last call if 'pos' is not
+  // before it, which is the case when walking the queue in order.
+  size_t level = 0;
+  size_t level_pos = front_.size();
+  if (cursor_valid_ && (pos >= cursor_pos_)) {
+    level = cursor_level_;
+    level_pos = cursor_pos_;
+  }
+
+  while ((pos - level_pos) >= levels_[level].size()) {
+    level_pos += levels_[level].size();
+    level++;
+  }
+
+  cursor_valid_ = true;
+  cursor_level_ = level;
+  cursor_pos_ = level_pos;
+  return levels_[level][pos - level_pos];
+}
+
+void
+PriorityQueue::MoveToFront(const size_t pos, const size_t front_pos)
+{
+  if (pos < front_.size()) {
+    std::rotate(
+        front_.begin() + front_pos, front_.begin() + pos,
+        front_.begin() + pos + 1);
+    return;
+  }
+
+  size_t level_pos = pos - front_.size();
+  size_t level = 0;
+  while (level_pos >= levels_[level].size()) {
+    level_pos -= levels_[level].size();
+    level++;
+  }
+
+  std::deque<Scheduler::Payload>& queue = levels_[level];
+  front_.emplace(front_.begin() + front_pos, std::move(queue[level_pos]));
+  queue.erase(queue.begin() + level_pos);
+  cursor_valid_ = false;
+}
+
+void
+PriorityQueue::MoveDelayedToFront(const uint64_t now_ns)
+{
+  if ((max_queue_delay_ns_ == 0) || (now_ns < max_queue_delay_ns_)) {
+    return;
+  }
+
+  // Each level is in arrival order so only the first payload of each
+  // level needs to be checked.
+  const uint64_t delayed_ns = now_ns - max_queue_delay_ns_;
+  while (true) {
+    std::deque<Scheduler::Payload>* oldest = nullptr;
+    uint64_t oldest_ns = 0;
+    for (auto& queue : levels_) {
+      if (queue.empty()) {
+        continue;
+      }
+
+      const uint64_t queued_ns = EnqueueTimeNs(queue.front());
+      if ((oldest == nullptr) ? (queued_ns <= delayed_ns)
+                              : (queued_ns < oldest_ns)) {
+        oldest = &queue;
+        oldest_ns = queued_ns;
+      }
+    }
+
+    if (oldest == nullptr) {
+      break;
+    }
+
+    front_.emplace_back(std::move(oldest->front()));
+    oldest->pop_front();
+    cursor_valid_ = false;
+  }
+}
+
+size_t
+PriorityQueue::RemoveIf(
+    const std::function<bool(const Scheduler::Payload&)>& pred,
+    std::vector<Scheduler::Payload>* removed)
+{
+  size_t first_pos = size_;
+  size_t pos = 0;
+
+  auto remove_from = [&](std::deque<Scheduler::Payload>& queue) {
+    size_t idx = 0;
+    while (idx < queue.size()) {
+      if (pred(queue[idx])) {
+        first_pos = std::min(first_pos, pos);
+        removed->emplace_back(std::move(queue[idx]));
+        queue.erase(queue.begin() + idx);
+        size_--;
+        cursor_valid_ = false;
+      } else {
+        idx++;
+      }
+
+      pos++;
+    }
+  };
+
+  remove_from(front_);
+  for (auto& queue : levels_) {
+    remove_from(queue);
+  }
+
+  return first_pos;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,110 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "src/core/scheduler.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// Queue of scheduler payloads that keeps one FIFO queue for each
+// priority level so that enqueuing is constant time regardless of the
+// priority. Payloads are ordered by priority level, and by arrival
+// within a level, except for the payloads that have been moved to the
+// front of the queue with MoveToFront() or MoveDelayedToFront(). Those
+// are kept in a separate FIFO ahead of all the levels and are never
+// passed by payloads enqueued later.
+//
+// Payloads are addressed by their position in that order. Walking the
+// queue in order with At() is amortized constant time per payload.
+//
+// The queue is not thread-safe, the caller must serialize access.
+class PriorityQueue {
+ public:
+  // Create a queue with 'level_cnt' priority levels, level 0 being
+  // the highest priority. If 'max_queue_delay_ns' is non-zero
+  // MoveDelayedToFront() moves payloads that have been queued for
+  // that long ahead of the payloads of higher priority.
+  PriorityQueue(const uint32_t level_cnt, const uint64_t max_queue_delay_ns);
+
+  // Add 'payload' to the end of priority level 'level'.
+  void Enqueue(const uint32_t level, Scheduler::Payload&& payload);
+
+  // Remove and return the payload at the front of the queue. The
+  // queue must not be empty.
+  Scheduler::Payload Dequeue();
+
+  // Return the payload at position 'pos' of the queue.
+  Scheduler::Payload& At(const size_t pos);
+
+  // Move the payload at position 'pos' to position 'front_pos' of the
+  // queue, shifting the payloads in between back by one. 'front_pos'
+  // must be <= 'pos' and must not be after the payloads that were
+  // already moved to the front.
+  void MoveToFront(const size_t pos, const size_t front_pos);
+
+  // Move the payloads that were enqueued at or before 'now_ns' minus
+  // the maximum queue delay to the front of the queue, behind the
+  // payloads already there, oldest first.
+  void MoveDelayedToFront(const uint64_t now_ns);
+
+  // Remove the payloads for which 'pred' returns true and append them
+  // to 'removed' in queue order. Return the smallest position that a
+  // removed payload had, or Size() if none were removed.
+  size_t RemoveIf(
+      const std::function<bool(const Scheduler::Payload&)>& pred,
+      std::vector<Scheduler::Payload>* removed);
+
+  // The number of payloads in the queue.
+  size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+ private:
+  // Return the time, in nanoseconds, that 'payload' was enqueued.
+  static uint64_t EnqueueTimeNs(const Scheduler::Payload& payload);
+
+  const uint64_t max_queue_delay_ns_;
+
+  // The payloads moved to the front of the queue, followed by the
+  // payloads of each priority level.
+  std::deque<Scheduler::Payload> front_;
+  std::vector<std::deque<Scheduler::Payload>> levels_;
+  size_t size_;
+
+  // The level and the queue position of its first payload found by
+  // the last call to At(), so that walking the queue does not search
+  // the levels from the start for every payload. Invalidated by any
+  // change to the queue.
+  bool cursor_valid_;
+  size_t cursor_level_;
+  size_t cursor_pos_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,198 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/priority_queue.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace nvidia { namespace inferenceserver {
+namespace {
+
+class PriorityQueueTest : public ::testing::Test {
+ protected:
+  // Enqueue a payload named 'name' at priority 'level'. The name is
+  // carried in the payload's status message. The queue timer is
+  // started so that the payload has an enqueue time.
+  void Enqueue(PriorityQueue* queue, uint32_t level, const std::string& name)
+  {
+    Scheduler::Payload payload;
+    payload.queue_timer_.reset(new ModelInferStats::ScopedTimer());
+    payload.queue_timer_->Start();
+    payload.status_ = Status(RequestStatusCode::SUCCESS, name);
+    queue->Enqueue(level, std::move(payload));
+  }
+
+  // Return the names of the payloads in 'queue', in queue order.
+  std::vector<std::string> Names(PriorityQueue* queue)
+  {
+    std::vector<std::string> names;
+    for (size_t pos = 0; pos < queue->Size(); ++pos) {
+      names.push_back(queue->At(pos).status_.Message());
+    }
+    return names;
+  }
+
+  // Dequeue every payload of 'queue' and return their names.
+  std::vector<std::string> DequeueAll(PriorityQueue* queue)
+  {
+    std::vector<std::string> names;
+    while (!queue->Empty()) {
+      names.push_back(queue->Dequeue().status_.Message());
+    }
+    return names;
+  }
+};
+
+TEST_F(PriorityQueueTest, FifoWithinLevel)
+{
+  PriorityQueue queue(1, 0);
+  EXPECT_TRUE(queue.Empty());
+  for (const char* name : {"a", "b", "c", "d"}) {
+    Enqueue(&queue, 0, name);
+  }
+  EXPECT_EQ(queue.Size(), (size_t)4);
+  EXPECT_EQ(Names(&queue), std::vector<std::string>({"a", "b", "c", "d"}));
+  EXPECT_EQ(
+      DequeueAll(&queue), std::vector<std::string>({"a", "b", "c", "d"}));
+}
+
+TEST_F(PriorityQueueTest, PriorityOrder)
+{
+  // Higher priority payloads are ahead of lower priority ones
+  // regardless of arrival, and arrival orders each level.
+  PriorityQueue queue(3, 0);
+  Enqueue(&queue, 2, "low0");
+  Enqueue(&queue, 0, "high0");
+  Enqueue(&queue, 1, "mid0");
+  Enqueue(&queue, 2, "low1");
+  Enqueue(&queue, 0, "high1");
+  Enqueue(&queue, 1, "mid1");
+
+  const std::vector<std::string> expected(
+      {"high0", "high1", "mid0", "mid1", "low0", "low1"});
+  EXPECT_EQ(Names(&queue), expected);
+  EXPECT_EQ(DequeueAll(&queue), expected);
+}
+
+TEST_F(PriorityQueueTest, LevelOutOfRange)
+{
+  // Levels past the last are queued at the lowest priority.
+  PriorityQueue queue(2, 0);
+  Enqueue(&queue, 5, "a");
+  Enqueue(&queue, 1, "b");
+  Enqueue(&queue, 0, "c");
+  EXPECT_EQ(DequeueAll(&queue), std::vector<std::string>({"c", "a", "b"}));
+}
+
+TEST_F(PriorityQueueTest, AtAfterModification)
+{
+  // At() resumes from its last position so it must be correct after
+  // the queue changes between calls.
+  PriorityQueue queue(2, 0);
+  Enqueue(&queue, 1, "b");
+  Enqueue(&queue, 1, "c");
+  EXPECT_EQ(queue.At(1).status_.Message(), "c");
+  Enqueue(&queue, 0, "a");
+  EXPECT_EQ(queue.At(1).status_.Message(), "b");
+  EXPECT_EQ(queue.At(2).status_.Message(), "c");
+  EXPECT_EQ(queue.At(0).status_.Message(), "a");
+}
+
+TEST_F(PriorityQueueTest, MoveToFront)
+{
+  PriorityQueue queue(2, 0);
+  Enqueue(&queue, 0, "a");
+  Enqueue(&queue, 0, "b");
+  Enqueue(&queue, 1, "c");
+  Enqueue(&queue, 1, "d");
+
+  queue.MoveToFront(3, 0);
+  EXPECT_EQ(Names(&queue), std::vector<std::string>({"d", "a", "b", "c"}));
+
+  // Payloads enqueued later, even at higher priority, stay behind
+  // the payloads moved to the front.
+  Enqueue(&queue, 0, "e");
+  queue.MoveToFront(3, 1);
+  EXPECT_EQ(
+      Names(&queue), std::vector<std::string>({"d", "e", "a", "b", "c"}));
+  EXPECT_EQ(
+      DequeueAll(&queue), std::vector<std::string>({"d", "e", "a", "b", "c"}));
+}
+
+TEST_F(PriorityQueueTest, MoveDelayedToFront)
+{
+  // Sleep between enqueues so that the enqueue times are distinct.
+  PriorityQueue queue(2, 1000);
+  for (const auto& level_name : std::vector<std::pair<uint32_t, std::string>>(
+           {{1, "low0"}, {0, "high0"}, {1, "low1"}})) {
+    Enqueue(&queue, level_name.first, level_name.second);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // Nothing has waited long enough yet.
+  queue.MoveDelayedToFront(0);
+  EXPECT_EQ(
+      Names(&queue), std::vector<std::string>({"high0", "low0", "low1"}));
+
+  // Once all have waited long enough they are moved oldest first.
+  Enqueue(&queue, 0, "high1");
+  queue.MoveDelayedToFront(UINT64_MAX);
+  EXPECT_EQ(
+      Names(&queue),
+      std::vector<std::string>({"low0", "high0", "low1", "high1"}));
+}
+
+TEST_F(PriorityQueueTest, RemoveIf)
+{
+  PriorityQueue queue(2, 0);
+  Enqueue(&queue, 1, "x0");
+  Enqueue(&queue, 0, "a");
+  Enqueue(&queue, 1, "b");
+  Enqueue(&queue, 0, "x1");
+
+  std::vector<Scheduler::Payload> removed;
+  const size_t first_pos = queue.RemoveIf(
+      [](const Scheduler::Payload& payload) {
+        return payload.status_.Message()[0] == 'x';
+      },
+      &removed);
+  EXPECT_EQ(first_pos, (size_t)1);
+  ASSERT_EQ(removed.size(), (size_t)2);
+  EXPECT_EQ(removed[0].status_.Message(), "x1");
+  EXPECT_EQ(removed[1].status_.Message(), "x0");
+  EXPECT_EQ(DequeueAll(&queue), std::vector<std::string>({"a", "b"}));
+
+  EXPECT_EQ(
+      queue.RemoveIf([](const Scheduler::Payload&) { return true; }, &removed),
+      (size_t)0);
+}
+
+}  // namespace
+}}  // namespace nvidia::inferenceserver
@@ -31,6 +31,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/top_k.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -97,6 +98,16 @@ InferRequestProvider::Create(
 
   (*provider)->request_header_ = request_header;
 
+  // The timeout is relative to when the server receives the request,
+  // which is when the provider is created.
+  if (request_header.timeout_microseconds() != 0) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    (*provider)->deadline_ns_ =
+        now.tv_sec * NANOS_PER_SECOND + now.tv_nsec +
+        request_header.timeout_microseconds() * 1000;
+  }
+
   for (const auto& io : request_header.input()) {
     auto it = input_buffer.find(io.name());
     if (it == input_buffer.end()) {
@@ -206,6 +217,7 @@ InferRequestProvider::GetNextInputContent(
         return Status(RequestStatusCode::INTERNAL, "contiguous input failed");
       }
 
+      input_copy_byte_size_ += total_size;
       *content = &(buf[0]);
       *content_byte_size = total_size;
     }
@@ -214,6 +226,32 @@ InferRequestProvider::GetNextInputContent(
   return Status::Success;
 }
 
+bool
+InferRequestProvider::GetContiguousInputContent(
+    const std::string& name, const void** content, size_t* content_byte_size)
+{
+  // Override content is small and is only ever returned once, so
+  // always let it be handled by GetNextInputContent().
+  if ((overrides_ != nullptr) &&
+      (overrides_->find(name) != overrides_->end())) {
+    return false;
+  }
+
+  const auto& pr = input_buffer_.find(name);
+  if ((pr == input_buffer_.end()) || (pr->second.second != 0)) {
+    return false;
+  }
+
+  const std::shared_ptr<SystemMemory>& memory = pr->second.first;
+  size_t next_byte_size;
+  if (memory->BufferAt(1, &next_byte_size) != nullptr) {
+    return false;
+  }
+
+  *content = memory->BufferAt(0, content_byte_size);
+  return (*content != nullptr);
+}
+
 Status
 InferRequestProvider::GetSystemMemory(
     const std::string& name, std::shared_ptr<SystemMemory>* input_buffer)
@@ -273,16 +311,16 @@ AddClassResults(
     const std::shared_ptr<LabelProvider>& label_provider,
     const InferResponseProvider::SecondaryLabelProviderMap& lookup_map)
 {
+  // Reused across calls so that only the first classification on a
+  // thread allocates.
+  thread_local std::vector<size_t> idx;
+
   T* probs = reinterpret_cast<T*>(poutput_buffer);
   const size_t entry_cnt = batch1_element_count;
   const size_t class_cnt = std::min(cls_count, entry_cnt);
-  std::vector<size_t> idx(entry_cnt);
 
   for (size_t i = 0; i < batch_size; ++i) {
-    iota(idx.begin(), idx.end(), 0);
-    sort(idx.begin(), idx.end(), [&probs](size_t i1, size_t i2) {
-      return probs[i1] > probs[i2];
-    });
+    TopK(probs, entry_cnt, class_cnt, &idx);
 
     auto bcls = poutput->add_batch_classes();
     for (size_t k = 0; k < class_cnt; ++k) {
@@ -576,6 +614,43 @@ InternalInferResponseProvider::AllocateOutputBuffer(
   RETURN_IF_ERROR(CheckAndSetIfBufferedOutput(
       name, content, content_byte_size, content_shape, &output));
 
+  // Use the buffer set for the output if there is one, otherwise use
+  // the output's allocator if it has one and the allocator provides
+  // the buffer.
+  auto ait = allocated_output_buffer_.find(name);
+  if (ait == allocated_output_buffer_.end()) {
+    auto alloc_it = output_allocator_.find(name);
+    if (alloc_it != output_allocator_.end()) {
+      bool allocated = false;
+      RETURN_IF_ERROR(alloc_it->second(
+          content_byte_size, content_shape, content, &allocated));
+      if (allocated) {
+        auto buffer = std::make_shared<SystemMemoryReference>();
+        buffer->AddBuffer(
+            static_cast<const char*>(*content), content_byte_size);
+        ait = allocated_output_buffer_.emplace(std::make_pair(name, buffer))
+                  .first;
+      } else {
+        *content = nullptr;
+      }
+    }
+  }
+
+  if (ait != allocated_output_buffer_.end()) {
+    if (content_byte_size != ait->second->TotalByteSize()) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "unexpected size " + std::to_string(ait->second->TotalByteSize()) +
+              " for output '" + name + "', expecting " +
+              std::to_string(content_byte_size));
+    }
+
+    size_t byte_size;
+    *content = const_cast<char*>(ait->second->BufferAt(0, &byte_size));
+    output->ptr_ = *content;
+    return Status::Success;
+  }
+
   // Always write output tensor to an output buffer no matter
   // if output has cls field defined
   auto it = output_buffer_.find(name);
@@ -605,6 +680,12 @@ Status
 InternalInferResponseProvider::GetSystemMemory(
     const std::string& name, std::shared_ptr<SystemMemory>* output_buffer)
 {
+  auto ait = allocated_output_buffer_.find(name);
+  if (ait != allocated_output_buffer_.end()) {
+    *output_buffer = ait->second;
+    return Status::Success;
+  }
+
   auto it = output_buffer_.find(name);
   if (it == output_buffer_.end()) {
     return Status(
@@ -615,6 +696,20 @@ InternalInferResponseProvider::GetSystemMemory(
   return Status::Success;
 }
 
+void
+InternalInferResponseProvider::SetOutputAllocator(
+    const std::string& name, const OutputAllocator& allocator)
+{
+  output_allocator_[name] = allocator;
+}
+
+void
+InternalInferResponseProvider::SetOutputBuffer(
+    const std::string& name, const std::shared_ptr<SystemMemory>& buffer)
+{
+  allocated_output_buffer_[name] = buffer;
+}
+
 InternalInferResponseProvider::InternalInferResponseProvider(
     const InferRequestHeader& request_header,
     const std::shared_ptr<LabelProvider>& label_provider)
@@ -662,16 +757,47 @@ GRPCInferResponseProvider::AllocateOutputBuffer(
   // Must always add a raw output into the list so that the number and
   // order of raw output entries equals the output meta-data. But
   // leave empty if not returning raw result for the output.
-  std::string* raw_output = response_->add_raw_output();
+  //
+  // The response message is reused across requests and keeps the raw
+  // outputs of the previous response (see ResetMessages() in
+  // grpc_server.cc). Reusing a raw output that is already large
+  // enough avoids allocating its memory again. The previous response
+  // may have been for another client, so its content is cleared
+  // before the string is resized, which zero-fills the buffer.
+  std::string* raw_output = (raw_output_cnt_ < response_->raw_output_size())
+                                ? response_->mutable_raw_output(raw_output_cnt_)
+                                : response_->add_raw_output();
+  raw_output_cnt_++;
+
   if (output->ptr_ == nullptr) {
+    if (raw_output->capacity() >= content_byte_size) {
+      reuse_cnt_++;
+    } else {
+      allocation_cnt_++;
+      allocation_byte_size_ += content_byte_size - raw_output->capacity();
+    }
+
+    raw_output->clear();
     raw_output->resize(content_byte_size);
     *content = static_cast<void*>(&((*raw_output)[0]));
     output->ptr_ = *content;
+  } else {
+    raw_output->clear();
   }
 
   return Status::Success;
 }
 
+void
+GRPCInferResponseProvider::OutputBufferStats(
+    uint32_t* allocation_cnt, size_t* allocation_byte_size,
+    uint32_t* reuse_cnt) const
+{
+  *allocation_cnt = allocation_cnt_;
+  *allocation_byte_size = allocation_byte_size_;
+  *reuse_cnt = reuse_cnt_;
+}
+
 //
 // HTTPInferResponseProvider
 //
@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <functional>
 #include "libevent/include/event2/buffer.h"
 #include "src/core/api.pb.h"
 #include "src/core/grpc_service.pb.h"
@@ -116,6 +117,18 @@ class InferRequestProvider {
   // batch-byte-size defined.
   const InferRequestHeader& RequestHeader() const { return request_header_; }
 
+  // Return the CLOCK_MONOTONIC time, in nanoseconds, after which the
+  // request should no longer be executed, or 0 if the request does
+  // not have a timeout.
+  uint64_t DeadlineNs() const { return deadline_ns_; }
+
+  // Return true if the request has a deadline and it has passed at
+  // 'now_ns'.
+  bool IsExpired(const uint64_t now_ns) const
+  {
+    return (deadline_ns_ != 0) && (now_ns >= deadline_ns_);
+  }
+
   // Get the next contiguous chunk of bytes for the 'name'd
   // input. Return a pointer to the chunk in 'content'.
   // 'content_byte_size' acts as both input and output. On input
@@ -131,6 +144,25 @@ class InferRequestProvider {
       const std::string& name, const void** content, size_t* content_byte_size,
       bool force_contiguous);
 
+  // If the entire content of the 'name'd input is available as a
+  // single chunk, and none of it has been returned by
+  // GetNextInputContent(), return true and the chunk in 'content' and
+  // 'content_byte_size'. The content is not consumed. Backends use
+  // this to reference the input in place instead of copying it.
+  virtual bool GetContiguousInputContent(
+      const std::string& name, const void** content, size_t* content_byte_size);
+
+  // Return the number of input bytes that had to be copied in host
+  // memory, by this provider or by a backend, to gather the request's
+  // inputs.
+  size_t InputCopyByteSize() const { return input_copy_byte_size_; }
+
+  // Record that 'byte_size' bytes of input were copied in host memory.
+  void IncrementInputCopyByteSize(size_t byte_size)
+  {
+    input_copy_byte_size_ += byte_size;
+  }
+
   // Retrieve the data buffer of input 'name'.
   Status GetSystemMemory(
       const std::string& name, std::shared_ptr<SystemMemory>* input_buffer);
@@ -151,7 +183,8 @@ class InferRequestProvider {
  protected:
   explicit InferRequestProvider(
       const std::string& model_name, const int64_t version)
-      : model_name_(model_name), version_(version)
+      : model_name_(model_name), version_(version), deadline_ns_(0),
+        input_copy_byte_size_(0)
   {
   }
 
@@ -168,6 +201,13 @@ class InferRequestProvider {
   const int64_t version_;
   InferRequestHeader request_header_;
 
+  // Deadline for the request derived from the request header's
+  // timeout, or 0 if the request does not have a timeout.
+  uint64_t deadline_ns_;
+
+  // Input bytes copied in host memory, see InputCopyByteSize().
+  size_t input_copy_byte_size_;
+
   // Input content overrides.
   std::shared_ptr<InputOverrideMap> overrides_;
 
@@ -206,6 +246,13 @@ class NULLInferRequestProvider : public InferRequestProvider {
       const std::string& name, const void** content, size_t* content_byte_size,
       bool force_contiguous) override;
 
+  bool GetContiguousInputContent(
+      const std::string& name, const void** content,
+      size_t* content_byte_size) override
+  {
+    return false;
+  }
+
  private:
   // A buffer of zero bytes that is used commonly as the NULL input.
   static std::vector<uint8_t> buf_;
@@ -240,7 +287,9 @@ class InferResponseProvider {
 
   // Get a buffer to store results for a named output. Must be called
   // exactly once for each output that is being returned for the
-  // request. The output must be listed in the request header.
+  // request. The output must be listed in the request header. The
+  // buffer is not necessarily initialized, so the caller must write
+  // all 'content_byte_size' bytes of it.
   virtual Status AllocateOutputBuffer(
       const std::string& name, void** content, size_t content_byte_size,
       const std::vector<int64_t>& content_shape) = 0;
@@ -330,6 +379,26 @@ class InternalInferResponseProvider : public InferResponseProvider {
   Status GetSystemMemory(
       const std::string& name, std::shared_ptr<SystemMemory>* output_buffer);
 
+  // Function used to allocate an output buffer outside of the
+  // provider. Set 'allocated' to false to have the provider allocate
+  // the buffer itself instead.
+  using OutputAllocator = std::function<Status(
+      size_t content_byte_size, const std::vector<int64_t>& content_shape,
+      void** content, bool* allocated)>;
+
+  // Use 'allocator' to allocate the buffer for the 'name'd output,
+  // for example so the output is written directly into the response
+  // of another request. The buffer is still returned by
+  // GetSystemMemory() but is not owned by this provider.
+  void SetOutputAllocator(
+      const std::string& name, const OutputAllocator& allocator);
+
+  // Use 'buffer', which must be a single block, as the buffer for the
+  // 'name'd output, for example when the output was computed as part
+  // of a larger request.
+  void SetOutputBuffer(
+      const std::string& name, const std::shared_ptr<SystemMemory>& buffer);
+
  private:
   InternalInferResponseProvider(
       const InferRequestHeader& request_header,
@@ -338,6 +407,12 @@ class InternalInferResponseProvider : public InferResponseProvider {
   InferResponseHeader response_header_;
   std::unordered_map<std::string, std::shared_ptr<AllocatedSystemMemory>>
       output_buffer_;
+
+  // The allocators set by SetOutputAllocator(), and the buffers they
+  // allocated or that were set by SetOutputBuffer().
+  std::unordered_map<std::string, OutputAllocator> output_allocator_;
+  std::unordered_map<std::string, std::shared_ptr<SystemMemory>>
+      allocated_output_buffer_;
 };
 
 //
@@ -357,16 +432,34 @@ class GRPCInferResponseProvider : public InferResponseProvider {
       const std::string& name, void** content, size_t content_byte_size,
       const std::vector<int64_t>& content_shape) override;
 
+  // Get the number of output buffers of the response that had to be
+  // grown, the number of bytes they were grown by, and the number of
+  // output buffers that fit in memory initialized by a previous
+  // response.
+  void OutputBufferStats(
+      uint32_t* allocation_cnt, size_t* allocation_byte_size,
+      uint32_t* reuse_cnt) const;
+
  private:
   GRPCInferResponseProvider(
       const InferRequestHeader& request_header, InferResponse* response,
       const std::shared_ptr<LabelProvider>& label_provider)
       : InferResponseProvider(request_header, label_provider),
-        response_(response)
+        response_(response), raw_output_cnt_(0), allocation_cnt_(0),
+        allocation_byte_size_(0), reuse_cnt_(0)
   {
   }
 
   InferResponse* response_;
+
+  // The number of raw outputs of 'response_' used by this response.
+  // Any raw outputs past those hold the outputs of a previous
+  // response that was sent with the same message.
+  int raw_output_cnt_;
+
+  uint32_t allocation_cnt_;
+  size_t allocation_byte_size_;
+  uint32_t reuse_cnt_;
 };
 
 //
@@ -0,0 +1,123 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/ready_backends.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Source of snapshot generations for all ReadyBackends objects. Zero
+// is never used so that it can indicate "no cached snapshot".
+std::atomic<uint64_t> next_generation(1);
+
+}  // namespace
+
+ReadyBackends::ReadyBackends()
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  Publish();
+}
+
+void
+ReadyBackends::SetReady(
+    const std::string& model_name, const int64_t version,
+    const std::shared_ptr<BackendHandle>& handle)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  models_[model_name][version] = handle;
+  Publish();
+}
+
+void
+ReadyBackends::SetNotReady(const std::string& model_name, const int64_t version)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  auto itr = models_.find(model_name);
+  if (itr == models_.end()) {
+    return;
+  }
+
+  itr->second.erase(version);
+  if (itr->second.empty()) {
+    models_.erase(itr);
+  }
+
+  Publish();
+}
+
+bool
+ReadyBackends::Get(
+    const std::string& model_name, const int64_t version,
+    std::shared_ptr<BackendHandle>* handle) const
+{
+  const std::shared_ptr<const ModelMap>& snapshot = Snapshot();
+
+  const auto mitr = snapshot->find(model_name);
+  if (mitr == snapshot->end()) {
+    return false;
+  }
+
+  // The versions are ordered so the last is the latest ready version.
+  const VersionMap& versions = mitr->second;
+  const auto vitr =
+      (version == -1) ? std::prev(versions.end()) : versions.find(version);
+  if (vitr == versions.end()) {
+    return false;
+  }
+
+  // The handle has expired if the version was unloaded after the
+  // snapshot was published.
+  *handle = vitr->second.lock();
+  return (*handle != nullptr);
+}
+
+const std::shared_ptr<const ReadyBackends::ModelMap>&
+ReadyBackends::Snapshot() const
+{
+  struct CachedSnapshot {
+    uint64_t generation_ = 0;
+    std::shared_ptr<const ModelMap> snapshot_;
+  };
+  thread_local CachedSnapshot cached;
+
+  if (cached.generation_ != generation_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mu_);
+    cached.snapshot_ = snapshot_;
+    cached.generation_ = generation_.load(std::memory_order_relaxed);
+  }
+
+  return cached.snapshot_;
+}
+
+void
+ReadyBackends::Publish()
+{
+  snapshot_ = std::make_shared<const ModelMap>(models_);
+  generation_.store(next_generation++, std::memory_order_release);
+}
+
+}}  // namespace nvidia::inferenceserver
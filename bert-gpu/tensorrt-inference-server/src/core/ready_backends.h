@@ -0,0 +1,95 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "src/core/model_repository_manager.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// Read-mostly index of the ready versions of each model, used to
+// resolve the backend for an inference request. Loading and unloading
+// publish a new immutable snapshot of the index. Lookups use a
+// snapshot cached by the calling thread and so take no locks unless a
+// new snapshot has been published since the thread's last lookup. The
+// latest ready version of a model is found without scanning its
+// versions.
+//
+// Snapshots hold weak references to the backend handles so that a
+// snapshot cached by an idle thread doesn't keep an unloaded backend
+// alive.
+class ReadyBackends {
+ public:
+  using BackendHandle = ModelRepositoryManager::BackendHandle;
+
+  ReadyBackends();
+
+  // Record that 'version' of 'model_name' is ready and is served by
+  // 'handle'.
+  void SetReady(
+      const std::string& model_name, const int64_t version,
+      const std::shared_ptr<BackendHandle>& handle);
+
+  // Record that 'version' of 'model_name' is no longer ready.
+  void SetNotReady(const std::string& model_name, const int64_t version);
+
+  // Get the handle for 'version' of 'model_name', or for the latest
+  // ready version if 'version' is -1. Return false if that version is
+  // not ready.
+  bool Get(
+      const std::string& model_name, const int64_t version,
+      std::shared_ptr<BackendHandle>* handle) const;
+
+ private:
+  using VersionMap = std::map<int64_t, std::weak_ptr<BackendHandle>>;
+  using ModelMap = std::unordered_map<std::string, VersionMap>;
+
+  // Get the latest snapshot. The returned reference is valid until the
+  // calling thread next calls this function.
+  const std::shared_ptr<const ModelMap>& Snapshot() const;
+
+  // Publish 'models_' as the latest snapshot. 'mu_' must be held.
+  void Publish();
+
+  // Protects 'models_' and 'snapshot_'.
+  mutable std::mutex mu_;
+
+  // The index that is modified by SetReady() and SetNotReady().
+  ModelMap models_;
+
+  // The latest published snapshot and its generation. Generations are
+  // unique across all ReadyBackends objects so a thread's cached
+  // snapshot is never mistaken for the snapshot of another object.
+  std::shared_ptr<const ModelMap> snapshot_;
+  std::atomic<uint64_t> generation_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,299 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/repository_watcher.h"
+
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "src/core/filesystem.h"
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Network filesystems on which inotify does not report the changes
+// made by other hosts.
+constexpr long kNfsSuperMagic = 0x6969;
+constexpr long kSmbSuperMagic = 0x517B;
+constexpr long kCifsSuperMagic = 0xFF534D42;
+constexpr long kFuseSuperMagic = 0x65735546;
+
+// Any of these events in a model directory, or in a directory below
+// it, can change the model.
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY |
+                                IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+}  // namespace
+
+Status
+RepositoryWatcher::Create(
+    const std::string& repository_path,
+    std::unique_ptr<RepositoryWatcher>* watcher)
+{
+  struct statfs fs_stat;
+  if (statfs(repository_path.c_str(), &fs_stat) != 0) {
+    return Status(
+        RequestStatusCode::INTERNAL, "failed to stat filesystem of '" +
+                                         repository_path +
+                                         "': " + std::strerror(errno));
+  }
+
+  const long fs_type = fs_stat.f_type;
+  if ((fs_type == kNfsSuperMagic) || (fs_type == kSmbSuperMagic) ||
+      (fs_type == kCifsSuperMagic) || (fs_type == kFuseSuperMagic)) {
+    return Status(
+        RequestStatusCode::UNSUPPORTED,
+        "changes made to a network filesystem by other hosts are not "
+        "reported");
+  }
+
+  const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    return Status(
+        RequestStatusCode::UNSUPPORTED,
+        std::string("failed to initialize inotify: ") + std::strerror(errno));
+  }
+
+  std::unique_ptr<RepositoryWatcher> local_watcher(
+      new RepositoryWatcher(repository_path, fd));
+  Status status = local_watcher->ResetWatches();
+  if (!status.IsOk()) {
+    return Status(RequestStatusCode::UNSUPPORTED, status.Message());
+  }
+
+  *watcher = std::move(local_watcher);
+  return Status::Success;
+}
+
+RepositoryWatcher::RepositoryWatcher(
+    const std::string& repository_path, const int fd)
+    : repository_path_(repository_path), fd_(fd), initial_(true),
+      missed_changes_(false)
+{
+}
+
+RepositoryWatcher::~RepositoryWatcher()
+{
+  close(fd_);
+}
+
+Status
+RepositoryWatcher::Changes(std::set<std::string>* changed, bool* full_scan)
+{
+  changed->clear();
+
+  alignas(struct inotify_event) char buf[64 * 1024];
+  while (true) {
+    const ssize_t len = read(fd_, buf, sizeof(buf));
+    if (len < 0) {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        break;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return Status(
+          RequestStatusCode::INTERNAL,
+          std::string("failed to read repository changes: ") +
+              std::strerror(errno));
+    }
+
+    for (const char* ptr = buf; ptr < buf + len;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(ptr);
+      HandleEvent(*event, changed);
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+
+  *full_scan = initial_ || missed_changes_;
+  initial_ = false;
+
+  // The watches are reset before the full scan so that any change
+  // made while scanning is reported by the next call.
+  if (missed_changes_) {
+    Status status = ResetWatches();
+    if (!status.IsOk()) {
+      LOG_VERBOSE(1) << "failed to watch model repository: "
+                     << status.AsString();
+    }
+  }
+
+  return Status::Success;
+}
+
+void
+RepositoryWatcher::HandleEvent(
+    const struct inotify_event& event, std::set<std::string>* changed)
+{
+  if ((event.mask & IN_Q_OVERFLOW) != 0) {
+    missed_changes_ = true;
+    return;
+  }
+
+  const auto itr = watches_.find(event.wd);
+  if (itr == watches_.end()) {
+    return;
+  }
+
+  // The directory is no longer watched, either because it was removed
+  // or because the watch was removed.
+  if ((event.mask & IN_IGNORED) != 0) {
+    watches_.erase(itr);
+    return;
+  }
+
+  // Copy the watches as they may be replaced below.
+  const std::vector<Watch> watches = itr->second;
+  for (const auto& watch : watches) {
+    if (watch.model_name_.empty()) {
+      // The repository directory itself was removed or moved.
+      if (event.len == 0) {
+        missed_changes_ = true;
+        continue;
+      }
+
+      // An entry of the repository changed. When a model is added or
+      // removed its watches are replaced, a new entry is watched if it
+      // is a directory.
+      const std::string model_name(event.name);
+      changed->insert(model_name);
+      if ((event.mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                         IN_MOVED_TO)) != 0) {
+        RemoveWatches(model_name);
+      }
+      if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+        Status status = AddWatches(
+            JoinPath({repository_path_, model_name}), model_name);
+        if (!status.IsOk()) {
+          missed_changes_ = true;
+        }
+      }
+    } else {
+      changed->insert(watch.model_name_);
+
+      // The directories within the model changed so watch them again
+      // to follow new and renamed directories.
+      if (((event.mask & IN_ISDIR) != 0) &&
+          ((event.mask & (IN_CREATE | IN_MOVED_FROM | IN_MOVED_TO)) != 0)) {
+        RemoveWatches(watch.model_name_);
+        Status status = AddWatches(
+            JoinPath({repository_path_, watch.model_name_}),
+            watch.model_name_);
+        if (!status.IsOk()) {
+          missed_changes_ = true;
+        }
+      }
+    }
+  }
+}
+
+Status
+RepositoryWatcher::AddWatches(
+    const std::string& path, const std::string& model_name)
+{
+  const int wd = inotify_add_watch(fd_, path.c_str(), kWatchMask);
+  if (wd < 0) {
+    // Entries that are not directories, or that were removed since
+    // they were listed, are not watched. A removal is reported by the
+    // parent directory.
+    if ((errno == ENOENT) || (errno == ENOTDIR)) {
+      return Status::Success;
+    }
+
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to watch '" + path + "': " + std::strerror(errno));
+  }
+
+  watches_[wd].push_back(Watch{path, model_name});
+
+  if (model_name.empty()) {
+    return Status::Success;
+  }
+
+  std::set<std::string> subdirs;
+  RETURN_IF_ERROR(GetDirectorySubdirs(path, &subdirs));
+  for (const auto& subdir : subdirs) {
+    RETURN_IF_ERROR(AddWatches(JoinPath({path, subdir}), model_name));
+  }
+
+  return Status::Success;
+}
+
+void
+RepositoryWatcher::RemoveWatches(const std::string& model_name)
+{
+  for (auto itr = watches_.begin(); itr != watches_.end();) {
+    auto& watches = itr->second;
+    for (auto witr = watches.begin(); witr != watches.end();) {
+      if (witr->model_name_ == model_name) {
+        witr = watches.erase(witr);
+      } else {
+        ++witr;
+      }
+    }
+
+    if (watches.empty()) {
+      inotify_rm_watch(fd_, itr->first);
+      itr = watches_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+Status
+RepositoryWatcher::ResetWatches()
+{
+  for (const auto& pr : watches_) {
+    inotify_rm_watch(fd_, pr.first);
+  }
+  watches_.clear();
+
+  // Until every watch is in place changes may be missed.
+  missed_changes_ = true;
+
+  RETURN_IF_ERROR(AddWatches(repository_path_, std::string()));
+
+  std::set<std::string> subdirs;
+  RETURN_IF_ERROR(GetDirectorySubdirs(repository_path_, &subdirs));
+  for (const auto& subdir : subdirs) {
+    RETURN_IF_ERROR(
+        AddWatches(JoinPath({repository_path_, subdir}), subdir));
+  }
+
+  missed_changes_ = false;
+  return Status::Success;
+}
+
+}}  // namespace nvidia::inferenceserver
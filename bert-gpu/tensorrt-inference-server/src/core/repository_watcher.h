@@ -0,0 +1,109 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "src/core/status.h"
+
+struct inotify_event;
+
+namespace nvidia { namespace inferenceserver {
+
+/// Watch a model repository for changes so that a poll of the
+/// repository only needs to examine the models that changed instead
+/// of every file of every model. Uses inotify, which reports changes
+/// made through the local kernel only. The watcher cannot be created
+/// on platforms or filesystems where that is not sufficient, in which
+/// case the repository must be fully polled.
+class RepositoryWatcher {
+ public:
+  /// Create a watcher for a repository and each of its models.
+  /// \param repository_path The file-system path of the repository.
+  /// \param watcher Returns the watcher.
+  /// \return UNSUPPORTED if changes to the repository cannot be
+  /// watched, error status otherwise.
+  static Status Create(
+      const std::string& repository_path,
+      std::unique_ptr<RepositoryWatcher>* watcher);
+
+  ~RepositoryWatcher();
+
+  /// Collect the changes observed since the last call, without
+  /// blocking.
+  /// \param changed Returns the names of the models that were added,
+  /// removed or modified, based on the directory name in the
+  /// repository.
+  /// \param full_scan Returns true if some changes may have been
+  /// missed, in which case 'changed' is incomplete and the whole
+  /// repository must be polled.
+  /// \return The error status.
+  Status Changes(std::set<std::string>* changed, bool* full_scan);
+
+ private:
+  RepositoryWatcher(const std::string& repository_path, const int fd);
+
+  // Watch 'path' and all directories below it as part of
+  // 'model_name'. An empty 'model_name' watches the repository itself
+  // without recursing.
+  Status AddWatches(const std::string& path, const std::string& model_name);
+
+  // Stop watching every directory of 'model_name'.
+  void RemoveWatches(const std::string& model_name);
+
+  // Replace all watches with watches of the repository and every
+  // model currently in it.
+  Status ResetWatches();
+
+  // Record the changes reported by 'event' in 'changed'.
+  void HandleEvent(
+      const struct inotify_event& event, std::set<std::string>* changed);
+
+  const std::string repository_path_;
+  const int fd_;
+
+  // Map from watch descriptor to the paths and models watched by
+  // it. The same directory is watched by a single descriptor so it
+  // belongs to multiple models when it is shared by symlinks.
+  struct Watch {
+    std::string path_;
+    std::string model_name_;
+  };
+  std::unordered_map<int, std::vector<Watch>> watches_;
+
+  // True until the first call to Changes(), which always requests a
+  // full scan to establish the initial state of the repository.
+  bool initial_;
+
+  // Set when a watch could not be added or events were dropped, until
+  // the watches are reset.
+  bool missed_changes_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include "src/core/provider.h"
 #include "src/core/server_status.h"
 #include "src/core/status.h"
 
@@ -52,6 +53,16 @@ class Scheduler {
           status_(payload.status_)
     {
     }
+    Payload& operator=(Payload&& payload)
+    {
+      queue_timer_ = std::move(payload.queue_timer_);
+      stats_ = std::move(payload.stats_);
+      request_provider_ = std::move(payload.request_provider_);
+      response_provider_ = std::move(payload.response_provider_);
+      complete_function_ = std::move(payload.complete_function_);
+      status_ = payload.status_;
+      return *this;
+    }
     Payload(
         std::unique_ptr<ModelInferStats::ScopedTimer>& queue_timer,
         const std::shared_ptr<ModelInferStats>& stats,
@@ -65,6 +76,22 @@ class Scheduler {
     {
     }
 
+    // Complete the payload without executing it because the deadline
+    // of its request passed while it was waiting to be scheduled.
+    void CompleteTimedOut()
+    {
+      queue_timer_.reset();
+      if (stats_ != nullptr) {
+        stats_->SetTimedOut(true);
+      }
+      if (complete_function_ != nullptr) {
+        complete_function_(Status(
+            RequestStatusCode::UNAVAILABLE,
+            "inference request for model '" + request_provider_->ModelName() +
+                "' timed out before it could be executed"));
+      }
+    }
+
     std::unique_ptr<ModelInferStats::ScopedTimer> queue_timer_;
     std::shared_ptr<ModelInferStats> stats_;
     std::shared_ptr<InferRequestProvider> request_provider_;
@@ -667,6 +667,7 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(const int nice)
 
   while (!scheduler_thread_exit_) {
     auto payloads = std::make_shared<std::vector<Scheduler::Payload>>();
+    std::vector<Scheduler::Payload> expired_payloads;
     uint64_t wait_microseconds = 0;
 
     // Hold the lock for as short a time as possible.
@@ -701,6 +702,10 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(const int nice)
         if (max_slot < 0) {
           wait_microseconds = default_wait_microseconds;
         } else {
+          struct timespec now;
+          clock_gettime(CLOCK_MONOTONIC, &now);
+          const uint64_t now_ns = now.tv_sec * NANOS_PER_SECOND + now.tv_nsec;
+
           // Collect payloads from slot 0 to max_slot.
           for (int32_t slot = 0; slot <= max_slot; ++slot) {
             bool end_of_sequence = false;
@@ -724,6 +729,22 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(const int nice)
                 use_null_provider = true;
                 end_of_sequence = true;
                 queue.pop_front();
+              } else if (slot_payload.request_provider_->IsExpired(now_ns)) {
+                // If the payload's deadline has passed then don't
+                // execute it and instead use a null provider to keep
+                // the slot aligned. The start of a sequence is always
+                // executed so that the backend sees the sequence
+                // begin. An expired payload that ends the sequence
+                // still ends it.
+                const uint32_t flags =
+                    slot_payload.request_provider_->RequestHeader().flags();
+                if ((flags & InferRequestHeader::FLAG_SEQUENCE_START) == 0) {
+                  use_null_provider = true;
+                  end_of_sequence =
+                      ((flags & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
+                  expired_payloads.emplace_back(std::move(slot_payload));
+                  queue.pop_front();
+                }
               }
             }
 
@@ -821,6 +842,10 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(const int nice)
       }
     }
 
+    for (auto& payload : expired_payloads) {
+      payload.CompleteTimedOut();
+    }
+
     if ((payloads != nullptr) && !payloads->empty()) {
       auto OnCompleteQueuedPayloads = [payloads](Status status) {
         // Payloads that don't have a completion function don't have
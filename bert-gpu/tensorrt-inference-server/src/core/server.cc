@@ -94,6 +94,7 @@ InferenceServer::InferenceServer()
   profiling_enabled_ = false;
   exit_timeout_secs_ = 30;
   repository_poll_secs_ = 15;
+  model_load_thread_cnt_ = 4;
 
   tf_soft_placement_enabled_ = true;
   tf_gpu_memory_fraction_ = 0.0;
@@ -132,7 +133,8 @@ InferenceServer::Init()
   status = ModelRepositoryManager::Create(
       version_, status_manager_, model_store_path_, strict_model_config_,
       tf_gpu_memory_fraction_, tf_soft_placement_enabled_,
-      repository_poll_secs_, true /* polling */, &model_repository_manager_);
+      repository_poll_secs_, true /* polling */, model_load_thread_cnt_,
+      &model_repository_manager_);
   if (!status.IsOk()) {
     LOG_ERROR << status.Message();
     if (model_repository_manager_ == nullptr) {
@@ -116,6 +116,10 @@ class InferenceServer {
   uint32_t RepositoryPollSeconds() const { return repository_poll_secs_; }
   void SetRepositoryPollSeconds(uint32_t s) { repository_poll_secs_ = s; }
 
+  // Get / set the number of threads used to load models.
+  uint32_t ModelLoadThreadCount() const { return model_load_thread_cnt_; }
+  void SetModelLoadThreadCount(uint32_t c) { model_load_thread_cnt_ = c; }
+
   // Get / set the server exit timeout, in seconds.
   int32_t ExitTimeoutSeconds() const { return exit_timeout_secs_; }
   void SetExitTimeoutSeconds(int32_t s) { exit_timeout_secs_ = std::max(0, s); }
@@ -173,6 +177,7 @@ class InferenceServer {
   bool strict_readiness_;
   bool profiling_enabled_;
   uint32_t repository_poll_secs_;
+  uint32_t model_load_thread_cnt_;
   uint32_t exit_timeout_secs_;
 
   bool tf_soft_placement_enabled_;
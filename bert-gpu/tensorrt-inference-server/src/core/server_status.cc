@@ -27,6 +27,7 @@
 #include "src/core/server_status.h"
 
 #include <time.h>
+#include <atomic>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/metric_model_reporter.h"
@@ -44,11 +45,12 @@ SetModelVersionReadyState(
   const std::string& model_name = ms.config().name();
 
   // Set all model versions for which we have status to
-  // unavailable... and then override that with actual status for the
-  // versions that are currently being served.
+  // unavailable and not loaded... and then override that with actual
+  // status for the versions that are currently being served.
   auto& mvs = *ms.mutable_version_status();
   for (auto& itr : mvs) {
     itr.second.set_ready_state(ModelReadyState::MODEL_UNAVAILABLE);
+    itr.second.set_load_duration_ns(0);
   }
 
   // [TODO] Once ModelRepositoryManager (MRM) is improved, instead of polling
@@ -60,6 +62,30 @@ SetModelVersionReadyState(
   for (const auto& version_and_state : versions_and_states) {
     mvs[version_and_state.first].set_ready_state(version_and_state.second);
   }
+
+  const auto versions_and_durations =
+      model_repository_manager->GetVersionLoadDurations(model_name);
+  for (const auto& version_and_duration : versions_and_durations) {
+    mvs[version_and_duration.first].set_load_duration_ns(
+        version_and_duration.second);
+  }
+}
+
+void
+SetStatHistogram(const std::vector<uint64_t>& counts, StatHistogram* stat)
+{
+  stat->Clear();
+  for (size_t idx = 0; idx < counts.size(); ++idx) {
+    if (counts[idx] != 0) {
+      stat->add_bucket_upper_bound_ns(
+          LatencyHistogram::BucketUpperBoundNs(idx));
+      stat->add_bucket_count(counts[idx]);
+    }
+  }
+
+  stat->set_p50_ns(LatencyHistogram::Percentile(counts, 50));
+  stat->set_p90_ns(LatencyHistogram::Percentile(counts, 90));
+  stat->set_p99_ns(LatencyHistogram::Percentile(counts, 99));
 }
 
 }  // namespace
@@ -76,17 +102,30 @@ Status
 ServerStatusManager::InitForModel(
     const std::string& model_name, const ModelConfig& model_config)
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  bool readded = false;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
 
-  auto& ms = *server_status_.mutable_model_status();
-  if (ms.find(model_name) == ms.end()) {
-    LOG_INFO << "New status tracking for model '" << model_name << "'";
-  } else {
-    LOG_INFO << "New status tracking for re-added model '" << model_name << "'";
-    ms[model_name].Clear();
+    auto& ms = *server_status_.mutable_model_status();
+    if (ms.find(model_name) == ms.end()) {
+      LOG_INFO << "New status tracking for model '" << model_name << "'";
+    } else {
+      LOG_INFO << "New status tracking for re-added model '" << model_name
+               << "'";
+      ms[model_name].Clear();
+      readded = true;
+    }
+
+    ms[model_name].mutable_config()->CopyFrom(model_config);
   }
 
-  ms[model_name].mutable_config()->CopyFrom(model_config);
+  // A re-added model starts with no inference statistics.
+  if (readded) {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mu_);
+      shard.models_.erase(model_name);
+    }
+  }
 
   return Status::Success;
 }
@@ -117,13 +156,17 @@ ServerStatusManager::Get(
     ServerReadyState server_ready_state, uint64_t server_uptime_ns,
     ModelRepositoryManager* model_repository_manager) const
 {
-  std::lock_guard<std::mutex> lock(mu_);
-  server_status->CopyFrom(server_status_);
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    server_status->CopyFrom(server_status_);
+  }
+
   server_status->set_id(server_id);
   server_status->set_ready_state(server_ready_state);
   server_status->set_uptime_ns(server_uptime_ns);
 
   for (auto& msitr : *server_status->mutable_model_status()) {
+    MergeInferStats(msitr.first, &msitr.second);
     SetModelVersionReadyState(msitr.second, model_repository_manager);
   }
 
@@ -137,23 +180,27 @@ ServerStatusManager::Get(
     const std::string& model_name,
     ModelRepositoryManager* model_repository_manager) const
 {
-  std::lock_guard<std::mutex> lock(mu_);
-
-  server_status->Clear();
-  server_status->set_version(server_status_.version());
-  server_status->set_id(server_id);
-  server_status->set_ready_state(server_ready_state);
-  server_status->set_uptime_ns(server_uptime_ns);
+  auto& ms = *server_status->mutable_model_status();
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+
+    server_status->Clear();
+    server_status->set_version(server_status_.version());
+    server_status->set_id(server_id);
+    server_status->set_ready_state(server_ready_state);
+    server_status->set_uptime_ns(server_uptime_ns);
+
+    const auto& itr = server_status_.model_status().find(model_name);
+    if (itr == server_status_.model_status().end()) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "no status available for unknown model '" + model_name + "'");
+    }
 
-  const auto& itr = server_status_.model_status().find(model_name);
-  if (itr == server_status_.model_status().end()) {
-    return Status(
-        RequestStatusCode::INVALID_ARG,
-        "no status available for unknown model '" + model_name + "'");
+    ms[model_name].CopyFrom(itr->second);
   }
 
-  auto& ms = *server_status->mutable_model_status();
-  ms[model_name].CopyFrom(itr->second);
+  MergeInferStats(model_name, &ms[model_name]);
   SetModelVersionReadyState(ms[model_name], model_repository_manager);
 
   return Status::Success;
@@ -197,40 +244,20 @@ ServerStatusManager::UpdateFailedInferStats(
     const std::string& model_name, const int64_t model_version,
     size_t batch_size, uint64_t request_duration_ns)
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  StatsShard& shard = ThreadShard();
+  std::lock_guard<std::mutex> lock(shard.mu_);
 
   // Model must exist...
-  auto itr = server_status_.mutable_model_status()->find(model_name);
-  if (itr == server_status_.model_status().end()) {
+  VersionStatsCounters* counters =
+      GetVersionCounters(shard, model_name, model_version);
+  if (counters == nullptr) {
     LOG_ERROR << "can't update INFER duration stat for " << model_name;
   } else {
     // batch_size may be zero if the failure occurred before it could
     // be determined... but we still record the failure.
-
-    // model version
-    auto& mvs = *itr->second.mutable_version_status();
-    auto mvs_itr = mvs.find(model_version);
-    if (mvs_itr == mvs.end()) {
-      ModelVersionStatus& version_status = mvs[model_version];
-      InferRequestStats& stats =
-          (*version_status.mutable_infer_stats())[batch_size];
-      stats.mutable_failed()->set_count(1);
-      stats.mutable_failed()->set_total_time_ns(request_duration_ns);
-    } else {
-      ModelVersionStatus& version_status = mvs_itr->second;
-      auto& is = *version_status.mutable_infer_stats();
-      auto is_itr = is.find(batch_size);
-      if (is_itr == is.end()) {
-        InferRequestStats& stats = is[batch_size];
-        stats.mutable_failed()->set_count(1);
-        stats.mutable_failed()->set_total_time_ns(request_duration_ns);
-      } else {
-        InferRequestStats& stats = is_itr->second;
-        stats.mutable_failed()->set_count(stats.failed().count() + 1);
-        stats.mutable_failed()->set_total_time_ns(
-            stats.failed().total_time_ns() + request_duration_ns);
-      }
-    }
+    InferStatsCounters& stats = counters->infer_stats_[batch_size];
+    stats.failed_count_++;
+    stats.failed_ns_ += request_duration_ns;
   }
 }
 
@@ -240,63 +267,195 @@ ServerStatusManager::UpdateSuccessInferStats(
     size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
     uint64_t queue_duration_ns, uint64_t compute_duration_ns)
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  StatsShard& shard = ThreadShard();
+  std::lock_guard<std::mutex> lock(shard.mu_);
 
   // Model must exist...
-  auto itr = server_status_.mutable_model_status()->find(model_name);
-  if (itr == server_status_.model_status().end()) {
+  VersionStatsCounters* counters =
+      GetVersionCounters(shard, model_name, model_version);
+  if (counters == nullptr) {
     LOG_ERROR << "can't update duration stat for " << model_name;
   } else if (batch_size == 0) {
     LOG_ERROR << "can't update INFER durations without batch size for "
               << model_name;
   } else {
-    // model version
-    auto& mvs = *itr->second.mutable_version_status();
-    auto mvs_itr = mvs.find(model_version);
-    InferRequestStats* new_stats = nullptr;
-    InferRequestStats* existing_stats = nullptr;
-    if (mvs_itr == mvs.end()) {
-      ModelVersionStatus& version_status = mvs[model_version];
-      version_status.set_model_inference_count(batch_size);
-      version_status.set_model_execution_count(execution_cnt);
-      new_stats = &((*version_status.mutable_infer_stats())[batch_size]);
-    } else {
-      ModelVersionStatus& version_status = mvs_itr->second;
+    counters->inference_count_ += batch_size;
+    counters->execution_count_ += execution_cnt;
+
+    InferStatsCounters& stats = counters->infer_stats_[batch_size];
+    stats.success_count_++;
+    stats.success_ns_ += request_duration_ns;
+    stats.compute_count_++;
+    stats.compute_ns_ += compute_duration_ns;
+    stats.queue_count_++;
+    stats.queue_ns_ += queue_duration_ns;
+
+    // Each shard has its own histograms so that they are updated
+    // under the uncontended shard mutex like the other statistics.
+    if (stats.histograms_ == nullptr) {
+      stats.histograms_.reset(new InferStatsHistograms());
+    }
+    stats.histograms_->success_.Record(request_duration_ns);
+    stats.histograms_->compute_.Record(compute_duration_ns);
+    stats.histograms_->queue_.Record(queue_duration_ns);
+  }
+}
+
+void
+ServerStatusManager::UpdateInputTensorStats(
+    const std::string& model_name, const int64_t model_version,
+    uint32_t allocation_cnt, uint32_t reuse_cnt)
+{
+  StatsShard& shard = ThreadShard();
+  std::lock_guard<std::mutex> lock(shard.mu_);
+
+  VersionStatsCounters* counters =
+      GetVersionCounters(shard, model_name, model_version);
+  if (counters == nullptr) {
+    LOG_ERROR << "can't update input tensor stats for " << model_name;
+  } else {
+    counters->input_tensor_allocation_count_ += allocation_cnt;
+    counters->input_tensor_reuse_count_ += reuse_cnt;
+  }
+}
+
+void
+ServerStatusManager::UpdateOutputBufferStats(
+    const std::string& model_name, const int64_t model_version,
+    uint32_t allocation_cnt, size_t allocation_byte_size, uint32_t reuse_cnt)
+{
+  StatsShard& shard = ThreadShard();
+  std::lock_guard<std::mutex> lock(shard.mu_);
+
+  VersionStatsCounters* counters =
+      GetVersionCounters(shard, model_name, model_version);
+  if (counters == nullptr) {
+    LOG_ERROR << "can't update output buffer stats for " << model_name;
+  } else {
+    counters->output_buffer_allocation_count_ += allocation_cnt;
+    counters->output_buffer_allocation_byte_size_ += allocation_byte_size;
+    counters->output_buffer_reuse_count_ += reuse_cnt;
+  }
+}
+
+ServerStatusManager::VersionStatsCounters*
+ServerStatusManager::GetVersionCounters(
+    StatsShard& shard, const std::string& model_name,
+    const int64_t model_version)
+{
+  auto itr = shard.models_.find(model_name);
+  if (itr == shard.models_.end()) {
+    // First update for the model in this shard so check that status
+    // is being tracked for the model.
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      const auto& ms = server_status_.model_status();
+      if (ms.find(model_name) == ms.end()) {
+        return nullptr;
+      }
+    }
+
+    itr = shard.models_.emplace(model_name, ModelStatsCounters()).first;
+  }
+
+  return &itr->second[model_version];
+}
+
+ServerStatusManager::StatsShard&
+ServerStatusManager::ThreadShard()
+{
+  // Assign shards to threads round-robin so that threads are spread
+  // evenly across the shards.
+  static std::atomic<uint32_t> next_shard_idx(0);
+  thread_local const uint32_t shard_idx =
+      next_shard_idx++ % SERVER_STATUS_STATS_SHARD_COUNT;
+  return shards_[shard_idx];
+}
+
+void
+ServerStatusManager::MergeInferStats(
+    const std::string& model_name, ModelStatus* ms) const
+{
+  // The histogram bucket counts summed across the shards, indexed by
+  // model version and batch size.
+  struct HistogramCounts {
+    std::vector<uint64_t> success_;
+    std::vector<uint64_t> compute_;
+    std::vector<uint64_t> queue_;
+  };
+  std::map<std::pair<int64_t, uint32_t>, HistogramCounts> histogram_counts;
+
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mu_);
+
+    const auto itr = shard.models_.find(model_name);
+    if (itr == shard.models_.end()) {
+      continue;
+    }
+
+    for (const auto& vitr : itr->second) {
+      const VersionStatsCounters& counters = vitr.second;
+      ModelVersionStatus& version_status =
+          (*ms->mutable_version_status())[vitr.first];
       version_status.set_model_inference_count(
-          version_status.model_inference_count() + batch_size);
+          version_status.model_inference_count() + counters.inference_count_);
       version_status.set_model_execution_count(
-          version_status.model_execution_count() + execution_cnt);
-
-      auto& is = *version_status.mutable_infer_stats();
-      auto is_itr = is.find(batch_size);
-      if (is_itr == is.end()) {
-        new_stats = &is[batch_size];
-      } else {
-        existing_stats = &is_itr->second;
+          version_status.model_execution_count() + counters.execution_count_);
+      version_status.set_input_tensor_allocation_count(
+          version_status.input_tensor_allocation_count() +
+          counters.input_tensor_allocation_count_);
+      version_status.set_input_tensor_reuse_count(
+          version_status.input_tensor_reuse_count() +
+          counters.input_tensor_reuse_count_);
+      version_status.set_output_buffer_allocation_count(
+          version_status.output_buffer_allocation_count() +
+          counters.output_buffer_allocation_count_);
+      version_status.set_output_buffer_allocation_byte_size(
+          version_status.output_buffer_allocation_byte_size() +
+          counters.output_buffer_allocation_byte_size_);
+      version_status.set_output_buffer_reuse_count(
+          version_status.output_buffer_reuse_count() +
+          counters.output_buffer_reuse_count_);
+
+      for (const auto& sitr : counters.infer_stats_) {
+        const InferStatsCounters& c = sitr.second;
+        InferRequestStats& stats =
+            (*version_status.mutable_infer_stats())[sitr.first];
+        if (c.success_count_ != 0) {
+          StatDuration* d = stats.mutable_success();
+          d->set_count(d->count() + c.success_count_);
+          d->set_total_time_ns(d->total_time_ns() + c.success_ns_);
+          d = stats.mutable_compute();
+          d->set_count(d->count() + c.compute_count_);
+          d->set_total_time_ns(d->total_time_ns() + c.compute_ns_);
+          d = stats.mutable_queue();
+          d->set_count(d->count() + c.queue_count_);
+          d->set_total_time_ns(d->total_time_ns() + c.queue_ns_);
+        }
+        if (c.failed_count_ != 0) {
+          StatDuration* d = stats.mutable_failed();
+          d->set_count(d->count() + c.failed_count_);
+          d->set_total_time_ns(d->total_time_ns() + c.failed_ns_);
+        }
+        if (c.histograms_ != nullptr) {
+          HistogramCounts& counts =
+              histogram_counts[std::make_pair(vitr.first, sitr.first)];
+          c.histograms_->success_.AddCounts(&counts.success_);
+          c.histograms_->compute_.AddCounts(&counts.compute_);
+          c.histograms_->queue_.AddCounts(&counts.queue_);
+        }
       }
     }
+  }
 
-    if (new_stats != nullptr) {
-      new_stats->mutable_success()->set_count(1);
-      new_stats->mutable_success()->set_total_time_ns(request_duration_ns);
-      new_stats->mutable_compute()->set_count(1);
-      new_stats->mutable_compute()->set_total_time_ns(compute_duration_ns);
-      new_stats->mutable_queue()->set_count(1);
-      new_stats->mutable_queue()->set_total_time_ns(queue_duration_ns);
-    } else if (existing_stats != nullptr) {
-      InferRequestStats& stats = *existing_stats;
-      stats.mutable_success()->set_count(stats.success().count() + 1);
-      stats.mutable_success()->set_total_time_ns(
-          stats.success().total_time_ns() + request_duration_ns);
-      stats.mutable_compute()->set_count(stats.compute().count() + 1);
-      stats.mutable_compute()->set_total_time_ns(
-          stats.compute().total_time_ns() + compute_duration_ns);
-      stats.mutable_queue()->set_count(stats.queue().count() + 1);
-      stats.mutable_queue()->set_total_time_ns(
-          stats.queue().total_time_ns() + queue_duration_ns);
-    } else {
-      LOG_ERROR << "Internal error logging INFER stats for " << model_name;
-    }
+  for (const auto& hitr : histogram_counts) {
+    ModelVersionStatus& version_status =
+        (*ms->mutable_version_status())[hitr.first.first];
+    InferRequestStats& stats =
+        (*version_status.mutable_infer_stats())[hitr.first.second];
+    SetStatHistogram(hitr.second.success_, stats.mutable_success_histogram());
+    SetStatHistogram(hitr.second.compute_, stats.mutable_compute_histogram());
+    SetStatHistogram(hitr.second.queue_, stats.mutable_queue_histogram());
   }
 }
 
@@ -363,11 +522,28 @@ ModelInferStats::~ModelInferStats()
                                     ? metric_reporter_->ModelVersion()
                                     : requested_model_version_;
 
+  if ((input_tensor_allocation_count_ != 0) ||
+      (input_tensor_reuse_count_ != 0)) {
+    status_manager_->UpdateInputTensorStats(
+        model_name_, model_version, input_tensor_allocation_count_,
+        input_tensor_reuse_count_);
+  }
+
+  if ((output_buffer_allocation_count_ != 0) ||
+      (output_buffer_reuse_count_ != 0)) {
+    status_manager_->UpdateOutputBufferStats(
+        model_name_, model_version, output_buffer_allocation_count_,
+        output_buffer_allocation_byte_size_, output_buffer_reuse_count_);
+  }
+
   if (failed_) {
     status_manager_->UpdateFailedInferStats(
         model_name_, model_version, batch_size_, request_duration_ns_);
     if (metric_reporter_ != nullptr) {
       metric_reporter_->MetricInferenceFailure(gpu_device_).Increment();
+      if (timed_out_) {
+        metric_reporter_->MetricInferenceTimeout(gpu_device_).Increment();
+      }
     }
   } else {
     status_manager_->UpdateSuccessInferStats(
@@ -382,6 +558,18 @@ ModelInferStats::~ModelInferStats()
         metric_reporter_->MetricInferenceExecutionCount(gpu_device_)
             .Increment(execution_count_);
       }
+      if (input_copy_byte_size_ > 0) {
+        metric_reporter_->MetricInferenceInputCopyBytes(gpu_device_)
+            .Increment(input_copy_byte_size_);
+      }
+      if (output_copy_byte_size_ > 0) {
+        metric_reporter_->MetricInferenceOutputCopyBytes(gpu_device_)
+            .Increment(output_copy_byte_size_);
+      }
+      if (ensemble_tensor_peak_byte_size_ > 0) {
+        metric_reporter_->MetricInferenceEnsembleTensorPeakBytes(gpu_device_)
+            .Increment(ensemble_tensor_peak_byte_size_);
+      }
 
       metric_reporter_->MetricInferenceRequestDuration(gpu_device_)
           .Increment(request_duration_ns_ / 1000);
@@ -390,6 +578,13 @@ ModelInferStats::~ModelInferStats()
       metric_reporter_->MetricInferenceQueueDuration(gpu_device_)
           .Increment(queue_duration_ns_ / 1000);
 
+      metric_reporter_->MetricInferenceRequestLatency(gpu_device_)
+          .Observe(request_duration_ns_ / 1000);
+      metric_reporter_->MetricInferenceComputeLatency(gpu_device_)
+          .Observe(compute_duration_ns_ / 1000);
+      metric_reporter_->MetricInferenceQueueLatency(gpu_device_)
+          .Observe(queue_duration_ns_ / 1000);
+
       metric_reporter_->MetricInferenceLoadRatio(gpu_device_)
           .Observe(
               (double)request_duration_ns_ /
@@ -26,7 +26,11 @@
 #pragma once
 
 #include <time.h>
+#include <map>
 #include <mutex>
+#include <unordered_map>
+#include "src/core/constants.h"
+#include "src/core/latency_histogram.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_repository_manager.h"
 #include "src/core/server_status.pb.h"
@@ -105,7 +109,12 @@ class ModelInferStats {
       const std::string& model_name)
       : status_manager_(status_manager), model_name_(model_name),
         requested_model_version_(-1), batch_size_(0), gpu_device_(-1),
-        failed_(false), execution_count_(0), request_duration_ns_(0),
+        failed_(false), timed_out_(false), execution_count_(0),
+        input_tensor_allocation_count_(0), input_tensor_reuse_count_(0),
+        output_buffer_allocation_count_(0),
+        output_buffer_allocation_byte_size_(0), output_buffer_reuse_count_(0),
+        input_copy_byte_size_(0), output_copy_byte_size_(0),
+        ensemble_tensor_peak_byte_size_(0), request_duration_ns_(0),
         queue_duration_ns_(0), compute_duration_ns_(0)
   {
   }
@@ -116,6 +125,11 @@ class ModelInferStats {
   // Mark inferencing request as failed / not-failed.
   void SetFailed(bool failed) { failed_ = failed; }
 
+  // Mark inferencing request as timed-out / not-timed-out. A request
+  // is timed-out if its deadline passed before it could be
+  // executed. A timed-out request is also reported as failed.
+  void SetTimedOut(bool timed_out) { timed_out_ = timed_out; }
+
   // Set the model version explicitly requested for the inference, or
   // -1 if latest version was requested.
   void SetRequestedVersion(int64_t v) { requested_model_version_ = v; }
@@ -138,6 +152,50 @@ class ModelInferStats {
   // the batched requests will count the execution).
   void SetModelExecutionCount(uint32_t count) { execution_count_ = count; }
 
+  // Set the number of input tensor buffers that were allocated, and
+  // the number that were reused, for the model execution that
+  // performed this inference request. Like the execution count these
+  // are only set for one of the requests of a batch.
+  void SetInputTensorCounts(uint32_t allocation_cnt, uint32_t reuse_cnt)
+  {
+    input_tensor_allocation_count_ = allocation_cnt;
+    input_tensor_reuse_count_ = reuse_cnt;
+  }
+
+  // Set the number of response output buffers that had to be grown,
+  // the number of bytes they were grown by, and the number that
+  // reused memory of an earlier response.
+  void SetOutputBufferStats(
+      uint32_t allocation_cnt, size_t allocation_byte_size,
+      uint32_t reuse_cnt)
+  {
+    output_buffer_allocation_count_ = allocation_cnt;
+    output_buffer_allocation_byte_size_ = allocation_byte_size;
+    output_buffer_reuse_count_ = reuse_cnt;
+  }
+
+  // Set the number of input bytes that had to be copied in host
+  // memory to gather the inputs for this inference request. Inputs
+  // that are passed to the model in place are not counted.
+  void SetInputCopyByteSize(size_t byte_size)
+  {
+    input_copy_byte_size_ = byte_size;
+  }
+
+  // Set the number of output bytes that had to be copied in host
+  // memory to return the outputs of this inference request.
+  void SetOutputCopyByteSize(size_t byte_size)
+  {
+    output_copy_byte_size_ = byte_size;
+  }
+
+  // Set the largest number of bytes of intermediate tensors that an
+  // ensemble inference request held at any one time.
+  void SetEnsembleTensorPeakByteSize(size_t byte_size)
+  {
+    ensemble_tensor_peak_byte_size_ = byte_size;
+  }
+
   // Get a ScopedTimer that measures entire inference request-response
   // duration. The lifetime of 'timer' must not exceed the
   // lifetime of 'this' object.
@@ -161,8 +219,17 @@ class ModelInferStats {
   size_t batch_size_;
   int gpu_device_;
   bool failed_;
+  bool timed_out_;
 
   uint32_t execution_count_;
+  uint32_t input_tensor_allocation_count_;
+  uint32_t input_tensor_reuse_count_;
+  uint32_t output_buffer_allocation_count_;
+  size_t output_buffer_allocation_byte_size_;
+  uint32_t output_buffer_reuse_count_;
+  size_t input_copy_byte_size_;
+  size_t output_copy_byte_size_;
+  size_t ensemble_tensor_peak_byte_size_;
   mutable uint64_t request_duration_ns_;
   mutable uint64_t queue_duration_ns_;
   mutable uint64_t compute_duration_ns_;
@@ -209,8 +276,85 @@ class ServerStatusManager {
       size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
       uint64_t queue_duration_ns, uint64_t compute_duration_ns);
 
+  // Add to the input tensor allocation counts of a model version.
+  void UpdateInputTensorStats(
+      const std::string& model_name, const int64_t model_version,
+      uint32_t allocation_cnt, uint32_t reuse_cnt);
+
+  // Add to the response output buffer counts of a model version.
+  void UpdateOutputBufferStats(
+      const std::string& model_name, const int64_t model_version,
+      uint32_t allocation_cnt, size_t allocation_byte_size,
+      uint32_t reuse_cnt);
+
  private:
+  // Duration distributions for one batch size of a model version.
+  struct InferStatsHistograms {
+    LatencyHistogram success_;
+    LatencyHistogram compute_;
+    LatencyHistogram queue_;
+  };
+
+  // Inference statistics for one batch size of a model version.
+  struct InferStatsCounters {
+    uint64_t success_count_ = 0;
+    uint64_t success_ns_ = 0;
+    uint64_t failed_count_ = 0;
+    uint64_t failed_ns_ = 0;
+    uint64_t compute_count_ = 0;
+    uint64_t compute_ns_ = 0;
+    uint64_t queue_count_ = 0;
+    uint64_t queue_ns_ = 0;
+    std::unique_ptr<InferStatsHistograms> histograms_;
+  };
+
+  // Inference statistics for one model version.
+  struct VersionStatsCounters {
+    uint64_t inference_count_ = 0;
+    uint64_t execution_count_ = 0;
+    uint64_t input_tensor_allocation_count_ = 0;
+    uint64_t input_tensor_reuse_count_ = 0;
+    uint64_t output_buffer_allocation_count_ = 0;
+    uint64_t output_buffer_allocation_byte_size_ = 0;
+    uint64_t output_buffer_reuse_count_ = 0;
+    std::map<uint32_t, InferStatsCounters> infer_stats_;
+  };
+
+  using ModelStatsCounters =
+      std::unordered_map<int64_t, VersionStatsCounters>;
+
+  // Inference statistics are accumulated into shards instead of
+  // directly into 'server_status_' so that concurrent requests don't
+  // serialize on 'mu_'. Each thread always updates the same shard and
+  // so the shard mutex is uncontended except when status is being
+  // reported. The shards are aggregated into the reported status
+  // when status is requested.
+  struct StatsShard {
+    std::mutex mu_;
+    std::unordered_map<std::string, ModelStatsCounters> models_;
+
+    // Keep shards used by different threads on separate cache lines.
+    char pad_[64];
+  };
+
+  // Get the counters for a model version in the calling thread's
+  // shard. Return nullptr if status is not being tracked for the
+  // model. The shard mutex must be held when this function is
+  // called.
+  VersionStatsCounters* GetVersionCounters(
+      StatsShard& shard, const std::string& model_name,
+      const int64_t model_version);
+
+  // Get the shard used by the calling thread.
+  StatsShard& ThreadShard();
+
+  // Add the inference statistics for 'model_name' from all shards to
+  // 'ms'.
+  void MergeInferStats(const std::string& model_name, ModelStatus* ms) const;
+
   mutable std::mutex mu_;
   ServerStatus server_status_;
+
+  mutable StatsShard shards_[SERVER_STATUS_STATS_SHARD_COUNT];
 };
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,135 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+// Return in 'idx' the indices of the 'k' largest of the 'cnt'
+// elements of 'values', ordered from largest to smallest. Equal
+// elements are ordered by index. 'idx' is used as scratch and so
+// should be reused across calls to avoid allocation.
+//
+// A small 'k' is selected with a single pass that keeps the indices
+// of the largest elements seen so far. The elements are checked a
+// block at a time against the smallest of those, which the compiler
+// can vectorize, and only a block that contains a larger element is
+// examined element by element. Once the first blocks have been seen
+// almost every block is skipped. A larger 'k' uses a partial
+// selection (std::nth_element) followed by a sort of the selected
+// indices.
+template <typename T>
+void TopK(
+    const T* values, const size_t cnt, size_t k, std::vector<size_t>* idx);
+
+//
+// Implementation
+//
+namespace detail {
+
+// The largest 'k' that uses the single pass selection.
+constexpr size_t kTopKScanMaxCount = 32;
+
+// The number of elements checked together by the single pass
+// selection.
+constexpr size_t kTopKScanBlockSize = 32;
+
+template <typename T>
+void
+TopKScanInsert(const T* values, const size_t i, std::vector<size_t>* idx)
+{
+  // Equal elements are already ordered by index since 'i' is larger
+  // than any index in 'idx'.
+  const T value = values[i];
+  auto itr = std::upper_bound(
+      idx->begin(), idx->end(), value,
+      [values](const T v, const size_t j) { return v > values[j]; });
+  idx->insert(itr, i);
+  idx->pop_back();
+}
+
+}  // namespace detail
+
+template <typename T>
+void
+TopK(const T* values, const size_t cnt, size_t k, std::vector<size_t>* idx)
+{
+  k = std::min(k, cnt);
+  idx->clear();
+  if (k == 0) {
+    return;
+  }
+
+  const auto greater = [values](const size_t i1, const size_t i2) {
+    return (values[i1] > values[i2]) ||
+           ((values[i1] == values[i2]) && (i1 < i2));
+  };
+
+  if (k > detail::kTopKScanMaxCount) {
+    idx->resize(cnt);
+    std::iota(idx->begin(), idx->end(), 0);
+    std::nth_element(idx->begin(), idx->begin() + (k - 1), idx->end(), greater);
+    idx->resize(k);
+    std::sort(idx->begin(), idx->end(), greater);
+    return;
+  }
+
+  idx->reserve(k + 1);
+  idx->resize(k);
+  std::iota(idx->begin(), idx->end(), 0);
+  std::sort(idx->begin(), idx->end(), greater);
+
+  constexpr size_t block_size = detail::kTopKScanBlockSize;
+  size_t i = k;
+  for (; i + block_size <= cnt; i += block_size) {
+    const T threshold = values[idx->back()];
+    const T* block = values + i;
+    int any_larger = 0;
+    for (size_t j = 0; j < block_size; ++j) {
+      any_larger |= (block[j] > threshold);
+    }
+
+    if (any_larger != 0) {
+      for (size_t j = 0; j < block_size; ++j) {
+        if (block[j] > values[idx->back()]) {
+          detail::TopKScanInsert(values, i + j, idx);
+        }
+      }
+    }
+  }
+
+  for (; i < cnt; ++i) {
+    if (values[i] > values[idx->back()]) {
+      detail::TopKScanInsert(values, i, idx);
+    }
+  }
+}
+
+}}  // namespace nvidia::inferenceserver
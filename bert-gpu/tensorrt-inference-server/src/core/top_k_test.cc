@@ -0,0 +1,117 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/top_k.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace nvidia { namespace inferenceserver {
+namespace {
+
+// The indices of the 'k' largest of 'values' found with a full sort,
+// largest first and equal values ordered by index.
+template <typename T>
+std::vector<size_t>
+SortTopK(const std::vector<T>& values, const size_t k)
+{
+  std::vector<size_t> idx(values.size());
+  std::iota(idx.begin(), idx.end(), 0);
+  std::stable_sort(idx.begin(), idx.end(), [&values](size_t i1, size_t i2) {
+    return values[i1] > values[i2];
+  });
+  idx.resize(std::min(k, values.size()));
+  return idx;
+}
+
+// Check TopK against the full sort for several sizes and 'k', both
+// below and above the single pass limit and for counts that are not
+// a multiple of the block size.
+template <typename T>
+void
+CheckTopK(const T max_value)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int64_t> dist(0, (int64_t)max_value);
+
+  std::vector<size_t> idx;
+  for (const size_t cnt : {1, 7, 31, 32, 33, 100, 1000, 1001}) {
+    std::vector<T> values(cnt);
+    for (auto& v : values) {
+      v = static_cast<T>(dist(gen));
+    }
+
+    for (const size_t k : {1, 2, 5, 31, 32, 33, 64, 1000, 2000}) {
+      TopK(values.data(), values.size(), k, &idx);
+      EXPECT_EQ(idx, SortTopK(values, k)) << "cnt " << cnt << ", k " << k;
+    }
+  }
+}
+
+TEST(TopKTest, Empty)
+{
+  std::vector<float> values{1.0f, 2.0f};
+  std::vector<size_t> idx{5, 6};
+  TopK(values.data(), values.size(), 0, &idx);
+  EXPECT_TRUE(idx.empty());
+  TopK(values.data(), 0, 3, &idx);
+  EXPECT_TRUE(idx.empty());
+}
+
+TEST(TopKTest, Ascending)
+{
+  // Every element is larger than those before it so the single pass
+  // inserts every element.
+  std::vector<float> values(500);
+  std::iota(values.begin(), values.end(), 0.0f);
+  std::vector<size_t> idx;
+  TopK(values.data(), values.size(), 10, &idx);
+  EXPECT_EQ(idx, SortTopK(values, 10));
+}
+
+TEST(TopKTest, MatchesSortFloat)
+{
+  CheckTopK<float>(1000);
+}
+
+TEST(TopKTest, MatchesSortInt32)
+{
+  CheckTopK<int32_t>(1 << 20);
+}
+
+TEST(TopKTest, MatchesSortTies)
+{
+  // Few distinct values so most elements are equal to another.
+  CheckTopK<uint8_t>(3);
+  CheckTopK<int32_t>(7);
+}
+
+}  // namespace
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,392 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "src/backends/custom/custom.h"
+#include "src/core/model_config.h"
+#include "src/core/model_config.pb.h"
+
+#define LOG_ERROR std::cerr
+#define LOG_INFO std::cout
+
+// This custom backend is an example of a backend that implements
+// CustomExecuteAsync. It copies input INPUT0 to output OUTPUT0, like
+// the identity backend, but does the copy on a thread owned by the
+// backend and reports each completed execution with the completion
+// callback instead of returning from the execute call.
+//
+// At most 'kMaxPendingExecutions' executions are queued for the
+// backend thread. CustomExecuteAsync blocks while the queue is full,
+// which limits the number of outstanding executions.
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace identity_async {
+
+// Integer error codes. TRTIS requires that success must be 0. All
+// other codes are interpreted by TRTIS as failures.
+enum ErrorCodes {
+  kSuccess = 0,
+  kUnknown,
+  kInvalidModelConfig,
+  kGpuNotSupported,
+  kInputOutput,
+  kInputContents,
+  kRequestOutput,
+  kOutputBuffer,
+  kExiting
+};
+
+constexpr size_t kMaxPendingExecutions = 2;
+
+// Context object. All state must be kept in this object.
+class Context {
+ public:
+  Context(
+      const std::string& instance_name, const ModelConfig& config,
+      const int gpu_device);
+  ~Context();
+
+  // Initialize the context. Validate that the model configuration,
+  // etc. is something that we can handle and start the execution
+  // thread.
+  int Init();
+
+  // Queue an execution of the payloads for the execution thread.
+  int ExecuteAsync(
+      const uint32_t payload_cnt, CustomPayload* payloads,
+      CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn,
+      CustomExecuteCompleteFn_t complete_fn, void* complete_context);
+
+ private:
+  // An execution waiting for the execution thread.
+  struct Execution {
+    uint32_t payload_cnt_;
+    CustomPayload* payloads_;
+    CustomGetNextInputFn_t input_fn_;
+    CustomGetOutputFn_t output_fn_;
+    CustomExecuteCompleteFn_t complete_fn_;
+    void* complete_context_;
+  };
+
+  // The execution thread. Executes the queued executions in order and
+  // reports the completion of each.
+  void ExecutionThread();
+
+  // Copy the input of one payload to its output.
+  int Execute(
+      CustomPayload* payload, CustomGetNextInputFn_t input_fn,
+      CustomGetOutputFn_t output_fn);
+
+  // The name of this instance of the backend.
+  const std::string instance_name_;
+
+  // The model configuration.
+  const ModelConfig model_config_;
+
+  // The GPU device ID to execute on or CUSTOM_NO_GPU_DEVICE if should
+  // execute on CPU.
+  const int gpu_device_;
+
+  // The datatype of the input and output.
+  DataType datatype_;
+
+  // The executions queued for the execution thread.
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Execution> queue_;
+  bool exiting_;
+  std::thread thread_;
+};
+
+Context::Context(
+    const std::string& instance_name, const ModelConfig& model_config,
+    const int gpu_device)
+    : instance_name_(instance_name), model_config_(model_config),
+      gpu_device_(gpu_device), datatype_(DataType::TYPE_INVALID),
+      exiting_(false)
+{
+}
+
+Context::~Context()
+{
+  // The inference server does not finalize the backend while an
+  // execution is outstanding, and never from within the completion
+  // callback, so the execution thread is idle and can be joined.
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    exiting_ = true;
+  }
+  cv_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+int
+Context::Init()
+{
+  // Execution on GPUs not supported since only a trivial amount of
+  // computation is required.
+  if (gpu_device_ != CUSTOM_NO_GPU_DEVICE) {
+    return kGpuNotSupported;
+  }
+
+  // The model must have a single input and output with the same
+  // datatype and shape.
+  if ((model_config_.input_size() != 1) ||
+      (model_config_.output_size() != 1) ||
+      (model_config_.input(0).name() != "INPUT0") ||
+      (model_config_.output(0).name() != "OUTPUT0") ||
+      (model_config_.input(0).data_type() !=
+       model_config_.output(0).data_type()) ||
+      !CompareDims(
+          model_config_.input(0).dims(), model_config_.output(0).dims())) {
+    return kInputOutput;
+  }
+
+  datatype_ = model_config_.input(0).data_type();
+  thread_ = std::thread([this] { ExecutionThread(); });
+
+  return kSuccess;
+}
+
+int
+Context::ExecuteAsync(
+    const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn,
+    CustomExecuteCompleteFn_t complete_fn, void* complete_context)
+{
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this] {
+      return exiting_ || (queue_.size() < kMaxPendingExecutions);
+    });
+    if (exiting_) {
+      return kExiting;
+    }
+
+    queue_.emplace_back(Execution{
+        payload_cnt, payloads, input_fn, output_fn, complete_fn,
+        complete_context});
+  }
+
+  cv_.notify_all();
+  return kSuccess;
+}
+
+void
+Context::ExecutionThread()
+{
+  while (true) {
+    Execution execution;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return exiting_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+
+      execution = queue_.front();
+      queue_.pop_front();
+    }
+
+    // Wake a caller of ExecuteAsync that is waiting for room in the
+    // queue.
+    cv_.notify_all();
+
+    for (uint32_t pidx = 0; pidx < execution.payload_cnt_; ++pidx) {
+      CustomPayload* payload = &execution.payloads_[pidx];
+      if (payload->error_code == 0) {
+        payload->error_code =
+            Execute(payload, execution.input_fn_, execution.output_fn_);
+      }
+    }
+
+    // After this call the payloads must no longer be accessed.
+    execution.complete_fn_(execution.complete_context_, kSuccess);
+  }
+}
+
+int
+Context::Execute(
+    CustomPayload* payload, CustomGetNextInputFn_t input_fn,
+    CustomGetOutputFn_t output_fn)
+{
+  // The only output is OUTPUT0 so there is nothing to do if it is not
+  // requested.
+  if (payload->output_cnt == 0) {
+    return kSuccess;
+  }
+  if ((payload->output_cnt != 1) ||
+      strcmp(payload->required_output_names[0], "OUTPUT0")) {
+    return kRequestOutput;
+  }
+
+  std::vector<int64_t> shape;
+  if (model_config_.max_batch_size() != 0) {
+    shape.push_back(payload->batch_size);
+  }
+  shape.insert(
+      shape.end(), payload->input_shape_dims[0],
+      payload->input_shape_dims[0] + payload->input_shape_dim_cnts[0]);
+
+  const int64_t batchn_byte_size = GetByteSize(datatype_, shape);
+  if (batchn_byte_size < 0) {
+    return kOutputBuffer;
+  }
+
+  void* obuffer;
+  if (!output_fn(
+          payload->output_context, "OUTPUT0", shape.size(), &shape[0],
+          batchn_byte_size, &obuffer)) {
+    return kOutputBuffer;
+  }
+
+  // If no error but the 'obuffer' is returned as nullptr, then skip
+  // writing this output.
+  if (obuffer == nullptr) {
+    return kSuccess;
+  }
+
+  char* output_buffer = reinterpret_cast<char*>(obuffer);
+
+  uint64_t total_byte_size = 0;
+  while (true) {
+    const void* content;
+    uint64_t content_byte_size = batchn_byte_size - total_byte_size;
+    if (!input_fn(
+            payload->input_context, "INPUT0", &content, &content_byte_size)) {
+      return kInputContents;
+    }
+
+    // If 'content' returns nullptr we have all the input.
+    if (content == nullptr) {
+      break;
+    }
+
+    if ((total_byte_size + content_byte_size) > (uint64_t)batchn_byte_size) {
+      return kInputContents;
+    }
+
+    memcpy(output_buffer + total_byte_size, content, content_byte_size);
+    total_byte_size += content_byte_size;
+  }
+
+  return kSuccess;
+}
+
+/////////////
+
+extern "C" {
+
+int
+CustomInitialize(const CustomInitializeData* data, void** custom_context)
+{
+  // Convert the serialized model config to a ModelConfig object.
+  ModelConfig model_config;
+  if (!model_config.ParseFromString(std::string(
+          data->serialized_model_config, data->serialized_model_config_size))) {
+    return kInvalidModelConfig;
+  }
+
+  // Create the context and validate that the model configuration is
+  // something that we can handle.
+  Context* context = new Context(
+      std::string(data->instance_name), model_config, data->gpu_device_id);
+  int err = context->Init();
+  if (err != kSuccess) {
+    delete context;
+    return err;
+  }
+
+  *custom_context = static_cast<void*>(context);
+
+  return kSuccess;
+}
+
+int
+CustomFinalize(void* custom_context)
+{
+  if (custom_context != nullptr) {
+    Context* context = static_cast<Context*>(custom_context);
+    delete context;
+  }
+
+  return kSuccess;
+}
+
+const char*
+CustomErrorString(void* custom_context, int errcode)
+{
+  switch (errcode) {
+    case kSuccess:
+      return "success";
+    case kInvalidModelConfig:
+      return "invalid model configuration";
+    case kGpuNotSupported:
+      return "execution on GPU not supported";
+    case kInputOutput:
+      return "model must have input INPUT0 and output OUTPUT0 with matching "
+             "shape and data-type";
+    case kInputContents:
+      return "unable to get input tensor values";
+    case kRequestOutput:
+      return "inference request for unknown output";
+    case kOutputBuffer:
+      return "unable to get buffer for output tensor values";
+    case kExiting:
+      return "execution requested while finalizing";
+    default:
+      break;
+  }
+
+  return "unknown error";
+}
+
+int
+CustomExecuteAsync(
+    void* custom_context, const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn,
+    CustomExecuteCompleteFn_t complete_fn, void* complete_context)
+{
+  if (custom_context == nullptr) {
+    return kUnknown;
+  }
+
+  Context* context = static_cast<Context*>(custom_context);
+  return context->ExecuteAsync(
+      payload_cnt, payloads, input_fn, output_fn, complete_fn,
+      complete_context);
+}
+
+}  // extern "C"
+
+}}}}  // namespace nvidia::inferenceserver::custom::identity_async
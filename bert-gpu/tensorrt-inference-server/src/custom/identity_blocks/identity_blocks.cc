@@ -0,0 +1,361 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "src/backends/custom/custom.h"
+#include "src/core/model_config.h"
+#include "src/core/model_config.pb.h"
+
+#define LOG_ERROR std::cerr
+#define LOG_INFO std::cout
+
+// This custom backend is an example of a backend that reads its
+// inputs with the input_blocks_fn callback instead of
+// CustomGetNextInput. For each input it gets the content of all the
+// payloads of the execution with a single call and copies the content
+// of each payload to the corresponding output.
+//
+// The model inputs are followed by the sequence batcher control
+// inputs, if any, and the i'th output receives the content of the
+// i'th of those. So an output that corresponds to a control input
+// returns the control value that the sequence batcher provided for
+// the request.
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace identity_blocks {
+
+// Integer error codes. TRTIS requires that success must be 0. All
+// other codes are interpreted by TRTIS as failures.
+enum ErrorCodes {
+  kSuccess = 0,
+  kUnknown,
+  kInvalidModelConfig,
+  kGpuNotSupported,
+  kNoInputBlocks,
+  kInputOutput,
+  kInputContents,
+  kOutputBuffer
+};
+
+// Context object. All state must be kept in this object.
+class Context {
+ public:
+  Context(
+      const std::string& instance_name, const ModelConfig& config,
+      const int gpu_device, CustomGetInputBlocksFn_t input_blocks_fn);
+
+  // Initialize the context. Validate that the model configuration,
+  // etc. is something that we can handle.
+  int Init();
+
+  // Perform custom execution on the payloads.
+  int Execute(
+      const uint32_t payload_cnt, CustomPayload* payloads,
+      CustomGetOutputFn_t output_fn);
+
+ private:
+  // An input, or control input, and the output it is copied to.
+  struct Tensor {
+    std::string output_name_;
+    DataType datatype_;
+    std::vector<int64_t> dims_;
+  };
+
+  // Copy the content of input 'input_index' of every payload to the
+  // corresponding output.
+  int CopyInput(
+      const uint32_t input_index, const uint32_t payload_cnt,
+      CustomPayload* payloads, CustomGetOutputFn_t output_fn);
+
+  // The name of this instance of the backend.
+  const std::string instance_name_;
+
+  // The model configuration.
+  const ModelConfig model_config_;
+
+  // The GPU device ID to execute on or CUSTOM_NO_GPU_DEVICE if should
+  // execute on CPU.
+  const int gpu_device_;
+
+  // The callback to get all the blocks of an input.
+  const CustomGetInputBlocksFn_t input_blocks_fn_;
+
+  // The inputs followed by the control inputs, indexed as expected
+  // by 'input_blocks_fn_'.
+  std::vector<Tensor> tensors_;
+};
+
+Context::Context(
+    const std::string& instance_name, const ModelConfig& model_config,
+    const int gpu_device, CustomGetInputBlocksFn_t input_blocks_fn)
+    : instance_name_(instance_name), model_config_(model_config),
+      gpu_device_(gpu_device), input_blocks_fn_(input_blocks_fn)
+{
+}
+
+int
+Context::Init()
+{
+  // Execution on GPUs not supported since only a trivial amount of
+  // computation is required.
+  if (gpu_device_ != CUSTOM_NO_GPU_DEVICE) {
+    return kGpuNotSupported;
+  }
+
+  if (input_blocks_fn_ == nullptr) {
+    return kNoInputBlocks;
+  }
+
+  for (const auto& input : model_config_.input()) {
+    std::vector<int64_t> dims(input.dims().begin(), input.dims().end());
+    tensors_.push_back(Tensor{"", input.data_type(), dims});
+  }
+
+  // A control input is a tensor with a single element, INT32 if the
+  // control values are given by 'int32_false_true' and FP32 if they
+  // are given by 'fp32_false_true'.
+  for (const auto& control_input :
+       model_config_.sequence_batching().control_input()) {
+    if (control_input.control_size() != 1) {
+      return kInputOutput;
+    }
+
+    const DataType datatype =
+        (control_input.control(0).int32_false_true_size() > 0)
+            ? DataType::TYPE_INT32
+            : DataType::TYPE_FP32;
+    tensors_.push_back(Tensor{"", datatype, std::vector<int64_t>{1}});
+  }
+
+  // There must be one output for each input and control input, with
+  // the same datatype and shape. Only fixed-size shapes are supported
+  // so that the size of each payload's content is known.
+  if (model_config_.output_size() != (int)tensors_.size()) {
+    return kInputOutput;
+  }
+
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    const ModelOutput& output = model_config_.output(i);
+    std::vector<int64_t> dims(output.dims().begin(), output.dims().end());
+    if ((output.data_type() != tensors_[i].datatype_) ||
+        (dims != tensors_[i].dims_) ||
+        (GetByteSize(tensors_[i].datatype_, dims) < 0)) {
+      return kInputOutput;
+    }
+
+    tensors_[i].output_name_ = output.name();
+  }
+
+  return kSuccess;
+}
+
+int
+Context::Execute(
+    const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetOutputFn_t output_fn)
+{
+  for (uint32_t i = 0; i < tensors_.size(); ++i) {
+    int err = CopyInput(i, payload_cnt, payloads, output_fn);
+    if (err != kSuccess) {
+      return err;
+    }
+  }
+
+  return kSuccess;
+}
+
+int
+Context::CopyInput(
+    const uint32_t input_index, const uint32_t payload_cnt,
+    CustomPayload* payloads, CustomGetOutputFn_t output_fn)
+{
+  if (payload_cnt == 0) {
+    return kSuccess;
+  }
+
+  // The input context of any payload can be used to get the blocks of
+  // all the payloads.
+  uint32_t block_cnt;
+  const CustomInputBlock* blocks;
+  const uint32_t* payload_block_starts;
+  if (!input_blocks_fn_(
+          payloads[0].input_context, input_index, &block_cnt, &blocks,
+          &payload_block_starts)) {
+    return kInputContents;
+  }
+
+  const Tensor& tensor = tensors_[input_index];
+  for (uint32_t pidx = 0; pidx < payload_cnt; ++pidx) {
+    CustomPayload& payload = payloads[pidx];
+    if (payload.error_code != 0) {
+      continue;
+    }
+
+    // Nothing to do if the output is not requested.
+    bool requested = false;
+    for (uint32_t oidx = 0; oidx < payload.output_cnt; ++oidx) {
+      if (tensor.output_name_ == payload.required_output_names[oidx]) {
+        requested = true;
+        break;
+      }
+    }
+    if (!requested) {
+      continue;
+    }
+
+    std::vector<int64_t> shape;
+    if (model_config_.max_batch_size() != 0) {
+      shape.push_back(payload.batch_size);
+    }
+    shape.insert(shape.end(), tensor.dims_.begin(), tensor.dims_.end());
+
+    const int64_t batchn_byte_size = GetByteSize(tensor.datatype_, shape);
+    void* obuffer;
+    if (!output_fn(
+            payload.output_context, tensor.output_name_.c_str(),
+            shape.size(), &shape[0], batchn_byte_size, &obuffer)) {
+      payload.error_code = kOutputBuffer;
+      continue;
+    }
+
+    // If no error but the 'obuffer' is returned as nullptr, then skip
+    // writing this output.
+    if (obuffer == nullptr) {
+      continue;
+    }
+
+    char* output_buffer = reinterpret_cast<char*>(obuffer);
+
+    uint64_t total_byte_size = 0;
+    for (uint32_t b = payload_block_starts[pidx];
+         b < payload_block_starts[pidx + 1]; ++b) {
+      const CustomInputBlock& block = blocks[b];
+      if ((total_byte_size + block.content_byte_size) >
+          (uint64_t)batchn_byte_size) {
+        payload.error_code = kInputContents;
+        break;
+      }
+
+      memcpy(
+          output_buffer + total_byte_size, block.content,
+          block.content_byte_size);
+      total_byte_size += block.content_byte_size;
+    }
+
+    if ((payload.error_code == 0) &&
+        (total_byte_size != (uint64_t)batchn_byte_size)) {
+      payload.error_code = kInputContents;
+    }
+  }
+
+  return kSuccess;
+}
+
+/////////////
+
+extern "C" {
+
+int
+CustomInitialize(const CustomInitializeData* data, void** custom_context)
+{
+  // Convert the serialized model config to a ModelConfig object.
+  ModelConfig model_config;
+  if (!model_config.ParseFromString(std::string(
+          data->serialized_model_config, data->serialized_model_config_size))) {
+    return kInvalidModelConfig;
+  }
+
+  // Create the context and validate that the model configuration is
+  // something that we can handle.
+  Context* context = new Context(
+      std::string(data->instance_name), model_config, data->gpu_device_id,
+      data->input_blocks_fn);
+  int err = context->Init();
+  if (err != kSuccess) {
+    delete context;
+    return err;
+  }
+
+  *custom_context = static_cast<void*>(context);
+
+  return kSuccess;
+}
+
+int
+CustomFinalize(void* custom_context)
+{
+  if (custom_context != nullptr) {
+    Context* context = static_cast<Context*>(custom_context);
+    delete context;
+  }
+
+  return kSuccess;
+}
+
+const char*
+CustomErrorString(void* custom_context, int errcode)
+{
+  switch (errcode) {
+    case kSuccess:
+      return "success";
+    case kInvalidModelConfig:
+      return "invalid model configuration";
+    case kGpuNotSupported:
+      return "execution on GPU not supported";
+    case kNoInputBlocks:
+      return "input_blocks_fn callback not provided";
+    case kInputOutput:
+      return "model must have one output for each input and control input, "
+             "with matching fixed-size shape and data-type";
+    case kInputContents:
+      return "unable to get input tensor values";
+    case kOutputBuffer:
+      return "unable to get buffer for output tensor values";
+    default:
+      break;
+  }
+
+  return "unknown error";
+}
+
+int
+CustomExecute(
+    void* custom_context, const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn)
+{
+  if (custom_context == nullptr) {
+    return kUnknown;
+  }
+
+  Context* context = static_cast<Context*>(custom_context);
+  return context->Execute(payload_cnt, payloads, output_fn);
+}
+
+}  // extern "C"
+
+}}}}  // namespace nvidia::inferenceserver::custom::identity_blocks
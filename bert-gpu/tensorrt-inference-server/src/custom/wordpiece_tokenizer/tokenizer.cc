@@ -0,0 +1,506 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/custom/wordpiece_tokenizer/tokenizer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include "src/custom/wordpiece_tokenizer/unicode_tables.h"
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace wordpiece_tokenizer {
+
+namespace {
+
+// Words longer than this many characters are mapped to the unknown
+// word piece, as in the reference implementation.
+constexpr size_t kMaxCharsPerWord = 200;
+
+struct LowerTable {
+  uint32_t first_;
+  uint32_t last_;
+  const uint16_t* values_;
+};
+
+constexpr LowerTable kLowerTables[] = {
+    {0x00C0, 0x024F, kLowerLatin},
+    {0x0370, 0x04FF, kLowerGreekCyrillic},
+    {0x1E00, 0x1FFF, kLowerLatinGreekExtended},
+};
+
+template <size_t N>
+bool
+InRanges(const uint32_t cp, const CodepointRange (&ranges)[N])
+{
+  const CodepointRange* itr = std::upper_bound(
+      ranges, ranges + N, cp,
+      [](const uint32_t c, const CodepointRange& r) { return c < r.first_; });
+  return (itr != ranges) && (cp <= (itr - 1)->last_);
+}
+
+bool
+IsWhitespace(const uint32_t cp)
+{
+  if ((cp == ' ') || (cp == '\t') || (cp == '\n') || (cp == '\r')) {
+    return true;
+  }
+
+  // The line and paragraph separators are not space separators but
+  // words are also split on them by the reference implementation.
+  if ((cp == 0x2028) || (cp == 0x2029)) {
+    return true;
+  }
+
+  return (cp >= 0x80) && InRanges(cp, kWhitespace);
+}
+
+bool
+IsControl(const uint32_t cp)
+{
+  // Tab, newline and carriage return are treated as whitespace.
+  if ((cp == '\t') || (cp == '\n') || (cp == '\r')) {
+    return false;
+  }
+  return InRanges(cp, kControl);
+}
+
+bool
+IsPunctuation(const uint32_t cp)
+{
+  // All non-letter/number ASCII characters are treated as punctuation,
+  // even those that are not in a Unicode punctuation category.
+  if (cp < 0x80) {
+    return ((cp >= 33) && (cp <= 47)) || ((cp >= 58) && (cp <= 64)) ||
+           ((cp >= 91) && (cp <= 96)) || ((cp >= 123) && (cp <= 126));
+  }
+  return InRanges(cp, kPunctuation);
+}
+
+// Return true if 'cp' is in one of the CJK Unified Ideographs blocks.
+// Each such character is a separate word.
+bool
+IsChineseChar(const uint32_t cp)
+{
+  return ((cp >= 0x4E00) && (cp <= 0x9FFF)) ||
+         ((cp >= 0x3400) && (cp <= 0x4DBF)) ||
+         ((cp >= 0x20000) && (cp <= 0x2A6DF)) ||
+         ((cp >= 0x2A700) && (cp <= 0x2B73F)) ||
+         ((cp >= 0x2B740) && (cp <= 0x2B81F)) ||
+         ((cp >= 0x2B820) && (cp <= 0x2CEAF)) ||
+         ((cp >= 0xF900) && (cp <= 0xFAFF)) ||
+         ((cp >= 0x2F800) && (cp <= 0x2FA1F));
+}
+
+// Return the lower-cased form of 'cp' with any accent removed, or 0 if
+// 'cp' is an accent that is removed.
+uint32_t
+LowerAndStripAccent(const uint32_t cp)
+{
+  if (cp < 0x80) {
+    return ((cp >= 'A') && (cp <= 'Z')) ? (cp + ('a' - 'A')) : cp;
+  }
+  for (const auto& table : kLowerTables) {
+    if ((cp >= table.first_) && (cp <= table.last_)) {
+      return table.values_[cp - table.first_];
+    }
+  }
+  if ((cp >= 0xFF21) && (cp <= 0xFF3A)) {
+    // Fullwidth Latin capital letters.
+    return cp + (0xFF41 - 0xFF21);
+  }
+  return InRanges(cp, kNonSpacingMarks) ? 0 : cp;
+}
+
+// If 'cp' is a precomposed Hangul syllable set 'jamo' to its
+// canonical decomposition and return the number of jamo, otherwise
+// return 0. The decomposition is the one that accent stripping
+// applies, and is computed as specified by the Unicode standard.
+size_t
+DecomposeHangul(const uint32_t cp, uint32_t* jamo)
+{
+  constexpr uint32_t kSBase = 0xAC00, kLBase = 0x1100, kVBase = 0x1161,
+                     kTBase = 0x11A7;
+  constexpr uint32_t kVCount = 21, kTCount = 28, kSCount = 11172;
+  if ((cp < kSBase) || (cp >= kSBase + kSCount)) {
+    return 0;
+  }
+
+  const uint32_t s = cp - kSBase;
+  jamo[0] = kLBase + s / (kVCount * kTCount);
+  jamo[1] = kVBase + (s % (kVCount * kTCount)) / kTCount;
+  if ((s % kTCount) == 0) {
+    return 2;
+  }
+  jamo[2] = kTBase + (s % kTCount);
+  return 3;
+}
+
+// Decode the UTF-8 character at 'pos' of the 'len' bytes at 'text' and
+// advance 'pos' past it. Return false if the bytes at 'pos' are not a
+// valid character, in which case 'pos' is advanced by one byte.
+bool
+DecodeUtf8(const char* text, const size_t len, size_t* pos, uint32_t* cp)
+{
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(text) + *pos;
+  const size_t avail = len - *pos;
+
+  size_t cnt;
+  uint32_t min;
+  if (s[0] < 0x80) {
+    *cp = s[0];
+    *pos += 1;
+    return true;
+  } else if ((s[0] & 0xE0) == 0xC0) {
+    cnt = 2;
+    min = 0x80;
+    *cp = s[0] & 0x1F;
+  } else if ((s[0] & 0xF0) == 0xE0) {
+    cnt = 3;
+    min = 0x800;
+    *cp = s[0] & 0x0F;
+  } else if ((s[0] & 0xF8) == 0xF0) {
+    cnt = 4;
+    min = 0x10000;
+    *cp = s[0] & 0x07;
+  } else {
+    *pos += 1;
+    return false;
+  }
+
+  if (avail < cnt) {
+    *pos += 1;
+    return false;
+  }
+  for (size_t i = 1; i < cnt; ++i) {
+    if ((s[i] & 0xC0) != 0x80) {
+      *pos += 1;
+      return false;
+    }
+    *cp = (*cp << 6) | (s[i] & 0x3F);
+  }
+
+  // Reject overlong encodings, surrogates and out-of-range values.
+  if ((*cp < min) || (*cp > 0x10FFFF) || ((*cp >= 0xD800) && (*cp <= 0xDFFF))) {
+    *pos += 1;
+    return false;
+  }
+
+  *pos += cnt;
+  return true;
+}
+
+void
+AppendUtf8(const uint32_t cp, std::string* str)
+{
+  if (cp < 0x80) {
+    str->push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    str->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    str->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    str->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    str->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    str->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    str->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+}  // namespace
+
+//
+// Vocab
+//
+std::shared_ptr<const Vocab>
+Vocab::Load(const std::string& path)
+{
+  static std::mutex mu;
+  static std::unordered_map<std::string, std::weak_ptr<const Vocab>> loaded;
+
+  std::lock_guard<std::mutex> lock(mu);
+  std::shared_ptr<const Vocab> vocab = loaded[path].lock();
+  if (vocab != nullptr) {
+    return vocab;
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    return nullptr;
+  }
+
+  std::shared_ptr<Vocab> new_vocab(new Vocab());
+  new_vocab->build_nodes_.resize(2);
+
+  std::string line;
+  int32_t id = 0;
+  while (std::getline(file, line)) {
+    const size_t begin = line.find_first_not_of(" \t\r\n");
+    const size_t end = line.find_last_not_of(" \t\r\n");
+    if (begin != std::string::npos) {
+      new_vocab->Add(line.substr(begin, end - begin + 1), id);
+    }
+    id++;
+  }
+
+  new_vocab->Finalize();
+
+  loaded[path] = new_vocab;
+  return new_vocab;
+}
+
+void
+Vocab::Add(const std::string& token, const int32_t id)
+{
+  uint32_t node = kStartRoot;
+  size_t begin = 0;
+  if ((token.size() > 2) && (token.compare(0, 2, "##") == 0)) {
+    node = kContinuationRoot;
+    begin = 2;
+  }
+
+  for (size_t i = begin; i < token.size(); ++i) {
+    const uint8_t byte = static_cast<uint8_t>(token[i]);
+    auto& children = build_nodes_[node].children_;
+    auto itr = std::lower_bound(
+        children.begin(), children.end(), std::make_pair(byte, uint32_t(0)));
+    if ((itr != children.end()) && (itr->first == byte)) {
+      node = itr->second;
+    } else {
+      const uint32_t child = build_nodes_.size();
+      children.insert(itr, std::make_pair(byte, child));
+      build_nodes_.emplace_back();
+      node = child;
+    }
+  }
+
+  // A later duplicate of a word piece takes precedence, as in the
+  // reference implementation.
+  build_nodes_[node].id_ = id;
+}
+
+void
+Vocab::Finalize()
+{
+  const size_t node_cnt = build_nodes_.size();
+  ids_.reserve(node_cnt);
+  edge_begin_.reserve(node_cnt + 1);
+
+  for (const auto& node : build_nodes_) {
+    ids_.push_back(node.id_);
+    edge_begin_.push_back(edge_bytes_.size());
+    for (const auto& child : node.children_) {
+      edge_bytes_.push_back(child.first);
+      edge_targets_.push_back(child.second);
+    }
+  }
+  edge_begin_.push_back(edge_bytes_.size());
+
+  build_nodes_.clear();
+  build_nodes_.shrink_to_fit();
+}
+
+uint32_t
+Vocab::Child(const uint32_t node, const uint8_t byte) const
+{
+  const uint32_t begin = edge_begin_[node];
+  const uint32_t end = edge_begin_[node + 1];
+
+  // Most nodes have few children so a linear search is fastest. The
+  // roots and the nodes near them have many children.
+  if ((end - begin) <= 8) {
+    for (uint32_t e = begin; e < end; ++e) {
+      if (edge_bytes_[e] == byte) {
+        return edge_targets_[e];
+      }
+    }
+    return 0;
+  }
+
+  const uint8_t* first = &edge_bytes_[0] + begin;
+  const uint8_t* last = &edge_bytes_[0] + end;
+  const uint8_t* itr = std::lower_bound(first, last, byte);
+  if ((itr == last) || (*itr != byte)) {
+    return 0;
+  }
+  return edge_targets_[itr - &edge_bytes_[0]];
+}
+
+int32_t
+Vocab::Id(const std::string& token) const
+{
+  uint32_t node = kStartRoot;
+  size_t begin = 0;
+  if ((token.size() > 2) && (token.compare(0, 2, "##") == 0)) {
+    node = kContinuationRoot;
+    begin = 2;
+  }
+
+  for (size_t i = begin; i < token.size(); ++i) {
+    // The start root is never a child so 0 indicates no match.
+    node = Child(node, static_cast<uint8_t>(token[i]));
+    if (node == 0) {
+      return -1;
+    }
+  }
+
+  return ids_[node];
+}
+
+size_t
+Vocab::LongestPrefix(
+    const char* word, const size_t len, const bool continuation,
+    int32_t* id) const
+{
+  uint32_t node = continuation ? kContinuationRoot : kStartRoot;
+  size_t match_len = 0;
+  for (size_t i = 0; i < len; ++i) {
+    node = Child(node, static_cast<uint8_t>(word[i]));
+    if (node == 0) {
+      break;
+    }
+    if (ids_[node] >= 0) {
+      match_len = i + 1;
+      *id = ids_[node];
+    }
+  }
+
+  return match_len;
+}
+
+//
+// Tokenizer
+//
+Tokenizer::Tokenizer(
+    const std::shared_ptr<const Vocab>& vocab, bool do_lower_case)
+    : vocab_(vocab), do_lower_case_(do_lower_case),
+      unk_id_(vocab->Id("[UNK]"))
+{
+}
+
+void
+Tokenizer::Tokenize(
+    const char* text, const size_t len, std::vector<int32_t>* ids) const
+{
+  std::string word;
+  size_t char_cnt = 0;
+
+  auto end_word = [this, &word, &char_cnt, ids]() {
+    if (!word.empty()) {
+      AddWordPieces(word, char_cnt, ids);
+      word.clear();
+      char_cnt = 0;
+    }
+  };
+
+  size_t pos = 0;
+  while (pos < len) {
+    uint32_t cp;
+    if (!DecodeUtf8(text, len, &pos, &cp)) {
+      continue;
+    }
+
+    if ((cp == 0) || (cp == 0xFFFD) || IsControl(cp)) {
+      continue;
+    }
+
+    if (IsWhitespace(cp)) {
+      end_word();
+      continue;
+    }
+
+    // Chinese characters are separate words and are not lower-cased.
+    // Hangul syllables are decomposed into their jamo when stripping
+    // accents.
+    bool separate_word = IsChineseChar(cp);
+    if (!separate_word) {
+      if (do_lower_case_) {
+        uint32_t jamo[3];
+        const size_t jamo_cnt = DecomposeHangul(cp, jamo);
+        if (jamo_cnt > 0) {
+          for (size_t j = 0; j < jamo_cnt; ++j) {
+            AppendUtf8(jamo[j], &word);
+          }
+          char_cnt += jamo_cnt;
+          continue;
+        }
+
+        cp = LowerAndStripAccent(cp);
+        if (cp == 0) {
+          continue;
+        }
+      }
+      separate_word = IsPunctuation(cp);
+    }
+
+    if (separate_word) {
+      end_word();
+      AppendUtf8(cp, &word);
+      char_cnt = 1;
+      end_word();
+    } else {
+      AppendUtf8(cp, &word);
+      char_cnt++;
+    }
+  }
+
+  end_word();
+}
+
+void
+Tokenizer::AddWordPieces(
+    const std::string& word, const size_t char_cnt,
+    std::vector<int32_t>* ids) const
+{
+  if (char_cnt > kMaxCharsPerWord) {
+    ids->push_back(unk_id_);
+    return;
+  }
+
+  // Greedily take the longest word piece at each position. If any
+  // part of the word doesn't match then the whole word is unknown.
+  const size_t word_begin = ids->size();
+  size_t start = 0;
+  while (start < word.size()) {
+    int32_t id;
+    const size_t match_len = vocab_->LongestPrefix(
+        word.data() + start, word.size() - start, (start > 0), &id);
+    if (match_len == 0) {
+      ids->resize(word_begin);
+      ids->push_back(unk_id_);
+      return;
+    }
+
+    ids->push_back(id);
+    start += match_len;
+  }
+}
+
+}}}}  // namespace nvidia::inferenceserver::custom::wordpiece_tokenizer
@@ -0,0 +1,131 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace wordpiece_tokenizer {
+
+// Vocabulary of word pieces. The word pieces are stored in a trie of
+// their UTF-8 bytes so that the longest word piece that is a prefix
+// of a word is found with a single walk over the word, instead of a
+// lookup of every candidate substring. Word pieces that continue a
+// word (those starting with "##") are stored without the "##" under a
+// separate root.
+class Vocab {
+ public:
+  // Load the vocabulary from 'path', which contains one word piece
+  // per line. The id of a word piece is its line number, starting at
+  // 0. Return nullptr if the file cannot be read. Vocabularies are
+  // shared by all callers that load the same path.
+  static std::shared_ptr<const Vocab> Load(const std::string& path);
+
+  // Return the id of 'token', or -1 if 'token' is not in the
+  // vocabulary.
+  int32_t Id(const std::string& token) const;
+
+  // Find the longest word piece that is a prefix of the 'len' bytes
+  // at 'word'. If 'continuation' is true only the word pieces that
+  // continue a word are matched. Return the length of the word piece
+  // in bytes, or 0 if no word piece matches, and set 'id' to its id.
+  size_t LongestPrefix(
+      const char* word, const size_t len, const bool continuation,
+      int32_t* id) const;
+
+ private:
+  Vocab() = default;
+
+  // Add 'token' with 'id'.
+  void Add(const std::string& token, const int32_t id);
+
+  // Return the child of 'node' for 'byte', or 0 if there isn't one.
+  uint32_t Child(const uint32_t node, const uint8_t byte) const;
+
+  // Convert the trie built by Add() to the flat representation used
+  // for lookups.
+  void Finalize();
+
+  // Root nodes of the word-start and word-continuation tries.
+  static constexpr uint32_t kStartRoot = 0;
+  static constexpr uint32_t kContinuationRoot = 1;
+
+  // The trie as built by Add(). Each node's children are kept sorted
+  // by byte.
+  struct BuildNode {
+    int32_t id_ = -1;
+    std::vector<std::pair<uint8_t, uint32_t>> children_;
+  };
+  std::vector<BuildNode> build_nodes_;
+
+  // The trie used for lookups. The children of node 'n' are the
+  // edges in [edge_begin_[n], edge_begin_[n + 1]), sorted by byte.
+  std::vector<int32_t> ids_;
+  std::vector<uint32_t> edge_begin_;
+  std::vector<uint8_t> edge_bytes_;
+  std::vector<uint32_t> edge_targets_;
+};
+
+// Tokenizer equivalent to FullTokenizer of the BERT reference
+// implementation: text is split into words by whitespace and
+// punctuation (BasicTokenizer) and each word is split into the
+// longest matching word pieces of the vocabulary (WordpieceTokenizer).
+//
+// Unicode character properties are taken from the tables in
+// unicode_tables.h. Lower-casing and accent stripping are exact for
+// the Latin, Greek and Cyrillic scripts and for Hangul, and remove
+// all non-spacing marks. The cased letters of other scripts and
+// compatibility characters are left unchanged, which only matters
+// for multilingual vocabularies.
+class Tokenizer {
+ public:
+  Tokenizer(const std::shared_ptr<const Vocab>& vocab, bool do_lower_case);
+
+  // Append to 'ids' the ids of the word pieces of the 'len' bytes of
+  // UTF-8 text at 'text'. Invalid UTF-8 sequences are ignored.
+  void Tokenize(
+      const char* text, const size_t len, std::vector<int32_t>* ids) const;
+
+  // The id of the unknown word piece.
+  int32_t UnknownId() const { return unk_id_; }
+
+ private:
+  // Append to 'ids' the ids of the word pieces of 'word', which holds
+  // 'char_cnt' characters.
+  void AddWordPieces(
+      const std::string& word, const size_t char_cnt,
+      std::vector<int32_t>* ids) const;
+
+  const std::shared_ptr<const Vocab> vocab_;
+  const bool do_lower_case_;
+  const int32_t unk_id_;
+};
+
+}}}}  // namespace nvidia::inferenceserver::custom::wordpiece_tokenizer
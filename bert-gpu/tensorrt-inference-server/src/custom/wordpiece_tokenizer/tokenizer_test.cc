@@ -0,0 +1,150 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/custom/wordpiece_tokenizer/tokenizer.h"
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+// The expected tokenizations are those of the BERT reference
+// implementation (tokenization_test.py), mapped to the ids of
+// testdata/vocab.txt.
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace wordpiece_tokenizer {
+namespace {
+
+class TokenizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    const char* srcdir = getenv("TEST_SRCDIR");
+    ASSERT_TRUE(srcdir != nullptr);
+    vocab_ = Vocab::Load(
+        std::string(srcdir) +
+        "/inference_server/src/custom/wordpiece_tokenizer/testdata/vocab.txt");
+    ASSERT_TRUE(vocab_ != nullptr);
+  }
+
+  std::vector<int32_t> Tokenize(const std::string& text, bool do_lower_case)
+  {
+    Tokenizer tokenizer(vocab_, do_lower_case);
+    std::vector<int32_t> ids;
+    tokenizer.Tokenize(text.data(), text.size(), &ids);
+    return ids;
+  }
+
+  std::shared_ptr<const Vocab> vocab_;
+};
+
+TEST_F(TokenizerTest, Vocab)
+{
+  EXPECT_EQ(vocab_->Id("[UNK]"), 0);
+  EXPECT_EQ(vocab_->Id("##want"), 4);
+  EXPECT_EQ(vocab_->Id("zz"), 23);
+  EXPECT_EQ(vocab_->Id("unwanted"), -1);
+}
+
+TEST_F(TokenizerTest, FullTokenizer)
+{
+  // un ##want ##ed , runn ##ing
+  EXPECT_EQ(
+      Tokenize("UNwant\xC3\xA9" "d,running", true),
+      (std::vector<int32_t>{7, 4, 5, 10, 8, 9}));
+}
+
+TEST_F(TokenizerTest, ChineseCharacters)
+{
+  // ah 博 推 zz
+  EXPECT_EQ(
+      Tokenize("ah\xE5\x8D\x9A\xE6\x8E\xA8zz", true),
+      (std::vector<int32_t>{20, 21, 22, 23}));
+}
+
+TEST_F(TokenizerTest, BasicTokenizerLower)
+{
+  // hello ! how are you ?
+  EXPECT_EQ(
+      Tokenize(" \tHeLLo!how  \n Are yoU?  ", true),
+      (std::vector<int32_t>{11, 12, 13, 14, 15, 16}));
+  // hello
+  EXPECT_EQ(Tokenize("H\xC3\xA9llo", true), (std::vector<int32_t>{11}));
+}
+
+TEST_F(TokenizerTest, BasicTokenizerNoLower)
+{
+  // HeLLo ! how Are yoU ?
+  EXPECT_EQ(
+      Tokenize(" \tHeLLo!how  \n Are yoU?  ", false),
+      (std::vector<int32_t>{17, 12, 13, 18, 19, 16}));
+}
+
+TEST_F(TokenizerTest, WordpieceTokenizer)
+{
+  EXPECT_TRUE(Tokenize("", true).empty());
+  // un ##want ##ed runn ##ing
+  EXPECT_EQ(
+      Tokenize("unwanted running", true),
+      (std::vector<int32_t>{7, 4, 5, 8, 9}));
+  // [UNK] runn ##ing
+  EXPECT_EQ(
+      Tokenize("unwantedX running", true), (std::vector<int32_t>{0, 8, 9}));
+}
+
+TEST_F(TokenizerTest, CleanText)
+{
+  // Control characters and the replacement character are removed and
+  // don't split words.
+  const char text[] = "un\0wanted\xEF\xBF\xBD running";
+  EXPECT_EQ(
+      Tokenize(std::string(text, sizeof(text) - 1), true),
+      (std::vector<int32_t>{7, 4, 5, 8, 9}));
+}
+
+TEST_F(TokenizerTest, LongWord)
+{
+  // Words of more than 200 characters are unknown even if they could
+  // be split into word pieces.
+  std::string word("un");
+  for (int i = 0; i < 99; ++i) {
+    word += "ed";
+  }
+  std::vector<int32_t> ids = Tokenize(word, true);
+  ASSERT_EQ(ids.size(), 100u);
+  EXPECT_EQ(ids[0], 7);
+  EXPECT_EQ(ids[99], 5);
+
+  word = "running";
+  for (int i = 0; i < 97; ++i) {
+    word += "ed";
+  }
+  EXPECT_EQ(Tokenize(word + " un", true), (std::vector<int32_t>{0, 7}));
+}
+
+}  // namespace
+}}}}  // namespace nvidia::inferenceserver::custom::wordpiece_tokenizer
@@ -0,0 +1,512 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "src/backends/custom/custom.h"
+#include "src/core/model_config.h"
+#include "src/core/model_config.pb.h"
+#include "src/custom/wordpiece_tokenizer/tokenizer.h"
+
+#define LOG_ERROR std::cerr
+#define LOG_INFO std::cout
+
+// This custom backend tokenizes raw text into the input tensors of a
+// BERT model, so that clients can send sentences instead of running
+// the BERT tokenizer themselves. It is intended to be used as the
+// first step of an ensemble that feeds the BERT model.
+//
+// There must be one or two inputs, each a single STRING element. The
+// first input is the first text segment and the optional second input
+// is the second text segment (for example the question and the
+// paragraph). There must be three TYPE_INT32 outputs named
+// "input_ids", "input_mask" and "segment_ids", each with shape
+// [ max_seq_length ]. The outputs are formed as in the BERT reference
+// implementation: "[CLS] A [SEP]" or "[CLS] A [SEP] B [SEP]", with the
+// longer segment truncated first when the tokens don't fit, and
+// padded with zeros to 'max_seq_length'.
+//
+// The model configuration must provide the vocabulary in the
+// "vocab_file" parameter, either as an absolute path or as a path
+// relative to the model directory. The optional "do_lower_case"
+// parameter ("true" or "false", default "true") must match the
+// vocabulary. Tokenization runs on the CPU so throughput scales with
+// the number of instances in the instance group.
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+namespace wordpiece_tokenizer {
+
+// Integer error codes. TRTIS requires that success must be 0. All
+// other codes are interpreted by TRTIS as failures.
+enum ErrorCodes {
+  kSuccess = 0,
+  kUnknown,
+  kInvalidModelConfig,
+  kVocab,
+  kInput,
+  kInputBuffer,
+  kInputSize,
+  kOutput,
+  kOutputBuffer
+};
+
+// Context object. All state must be kept in this object.
+class Context {
+ public:
+  Context(
+      const std::string& instance_name, const ModelConfig& config,
+      const size_t server_parameter_cnt, const char** server_parameters);
+
+  // Initialize the context. Validate that the model configuration,
+  // etc. is something that we can handle.
+  int Init();
+
+  // Perform custom execution on the payloads.
+  int Execute(
+      const uint32_t payload_cnt, CustomPayload* payloads,
+      CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn);
+
+ private:
+  // Get the 'batch_size' strings of the input tensor. Each string of a
+  // STRING tensor is preceded by its 4-byte length.
+  int GetInputStrings(
+      CustomGetNextInputFn_t input_fn, void* input_context, const char* name,
+      const uint32_t batch_size, std::vector<std::string>* strings);
+
+  // Tokenize the text segments of a batch entry and write the
+  // resulting 'max_seq_length_' values of each output at 'input_ids',
+  // 'input_mask' and 'segment_ids'.
+  void Tokenize(
+      const std::string& text_a, const std::string* text_b,
+      int32_t* input_ids, int32_t* input_mask, int32_t* segment_ids);
+
+  // The name of this instance of the backend.
+  const std::string instance_name_;
+
+  // The model configuration.
+  const ModelConfig model_config_;
+
+  // The server parameter values.
+  std::vector<std::string> server_params_;
+
+  // The tokenizer and the ids of the special word pieces.
+  std::unique_ptr<Tokenizer> tokenizer_;
+  int32_t cls_id_;
+  int32_t sep_id_;
+
+  // The length of the output sequences.
+  size_t max_seq_length_;
+
+  // Scratch buffers reused across executions.
+  std::vector<std::string> text_a_;
+  std::vector<std::string> text_b_;
+  std::vector<int32_t> ids_a_;
+  std::vector<int32_t> ids_b_;
+  std::vector<int32_t> input_ids_;
+  std::vector<int32_t> input_mask_;
+  std::vector<int32_t> segment_ids_;
+};
+
+Context::Context(
+    const std::string& instance_name, const ModelConfig& model_config,
+    const size_t server_parameter_cnt, const char** server_parameters)
+    : instance_name_(instance_name), model_config_(model_config), cls_id_(-1),
+      sep_id_(-1), max_seq_length_(0)
+{
+  // Must make a copy of server_parameters since we don't own those
+  // strings.
+  for (size_t i = 0; i < server_parameter_cnt; ++i) {
+    server_params_.push_back(server_parameters[i]);
+  }
+}
+
+int
+Context::Init()
+{
+  // There must be one or two inputs, each a single string.
+  if ((model_config_.input_size() < 1) || (model_config_.input_size() > 2)) {
+    return kInput;
+  }
+  for (const auto& input : model_config_.input()) {
+    if ((input.dims_size() != 1) || (input.dims(0) != 1)) {
+      return kInput;
+    }
+    if (input.data_type() != DataType::TYPE_STRING) {
+      return kInput;
+    }
+  }
+
+  // There must be exactly one output for each of the three BERT input
+  // tensors, all with the same fixed-size shape.
+  if (model_config_.output_size() != 3) {
+    return kOutput;
+  }
+  std::set<std::string> output_names;
+  for (const auto& output : model_config_.output()) {
+    if ((output.name() != "input_ids") && (output.name() != "input_mask") &&
+        (output.name() != "segment_ids")) {
+      return kOutput;
+    }
+    if (!output_names.insert(output.name()).second) {
+      return kOutput;
+    }
+    if ((output.dims_size() != 1) || (output.dims(0) < 3)) {
+      return kOutput;
+    }
+    if (output.data_type() != DataType::TYPE_INT32) {
+      return kOutput;
+    }
+    if ((max_seq_length_ != 0) && (max_seq_length_ != (size_t)output.dims(0))) {
+      return kOutput;
+    }
+    max_seq_length_ = output.dims(0);
+  }
+
+  std::string vocab_file;
+  bool do_lower_case = true;
+  for (const auto& pr : model_config_.parameters()) {
+    if (pr.first == "vocab_file") {
+      vocab_file = pr.second.string_value();
+    } else if (pr.first == "do_lower_case") {
+      do_lower_case = (pr.second.string_value() != "false");
+    }
+  }
+
+  if (vocab_file.empty()) {
+    return kVocab;
+  }
+
+  // A relative vocabulary path is relative to the model directory.
+  if ((vocab_file[0] != '/') &&
+      (server_params_.size() > CustomServerParameter::MODEL_REPOSITORY_PATH)) {
+    vocab_file =
+        server_params_[CustomServerParameter::MODEL_REPOSITORY_PATH] + "/" +
+        model_config_.name() + "/" + vocab_file;
+  }
+
+  std::shared_ptr<const Vocab> vocab = Vocab::Load(vocab_file);
+  if (vocab == nullptr) {
+    LOG_ERROR << "unable to load vocabulary '" << vocab_file << "'"
+              << std::endl;
+    return kVocab;
+  }
+
+  cls_id_ = vocab->Id("[CLS]");
+  sep_id_ = vocab->Id("[SEP]");
+  if ((cls_id_ < 0) || (sep_id_ < 0) || (vocab->Id("[UNK]") < 0)) {
+    LOG_ERROR << "vocabulary '" << vocab_file
+              << "' must contain [CLS], [SEP] and [UNK]" << std::endl;
+    return kVocab;
+  }
+
+  tokenizer_.reset(new Tokenizer(vocab, do_lower_case));
+
+  return kSuccess;
+}
+
+int
+Context::Execute(
+    const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn)
+{
+  const bool has_text_b = (model_config_.input_size() == 2);
+
+  for (size_t idx = 0; idx < payload_cnt; idx++) {
+    CustomPayload& payload = payloads[idx];
+
+    // If output wasn't requested just do nothing.
+    if (payload.output_cnt == 0) {
+      continue;
+    }
+
+    const uint32_t batch_size =
+        (payload.batch_size == 0) ? 1 : payload.batch_size;
+
+    int err = GetInputStrings(
+        input_fn, payload.input_context, model_config_.input(0).name().c_str(),
+        batch_size, &text_a_);
+    if ((err == kSuccess) && has_text_b) {
+      err = GetInputStrings(
+          input_fn, payload.input_context,
+          model_config_.input(1).name().c_str(), batch_size, &text_b_);
+    }
+    if (err != kSuccess) {
+      payload.error_code = err;
+      continue;
+    }
+
+    const size_t element_cnt = batch_size * max_seq_length_;
+    input_ids_.resize(element_cnt);
+    input_mask_.resize(element_cnt);
+    segment_ids_.resize(element_cnt);
+
+    for (size_t b = 0; b < batch_size; ++b) {
+      const size_t offset = b * max_seq_length_;
+      Tokenize(
+          text_a_[b], has_text_b ? &text_b_[b] : nullptr, &input_ids_[offset],
+          &input_mask_[offset], &segment_ids_[offset]);
+    }
+
+    std::vector<int64_t> output_shape;
+    if (model_config_.max_batch_size() != 0) {
+      output_shape.push_back(payload.batch_size);
+    }
+    output_shape.push_back(max_seq_length_);
+    const uint64_t output_byte_size = element_cnt * sizeof(int32_t);
+
+    for (uint32_t oidx = 0; oidx < payload.output_cnt; ++oidx) {
+      const char* output_name = payload.required_output_names[oidx];
+      const int32_t* values = (strcmp(output_name, "input_ids") == 0)
+                                  ? &input_ids_[0]
+                                  : (strcmp(output_name, "input_mask") == 0)
+                                        ? &input_mask_[0]
+                                        : &segment_ids_[0];
+
+      void* obuffer;
+      if (!output_fn(
+              payload.output_context, output_name, output_shape.size(),
+              &output_shape[0], output_byte_size, &obuffer)) {
+        payload.error_code = kOutputBuffer;
+        break;
+      }
+
+      // If no error but the 'obuffer' is returned as nullptr, then
+      // skip writing this output.
+      if (obuffer != nullptr) {
+        memcpy(obuffer, values, output_byte_size);
+      }
+    }
+  }
+
+  return kSuccess;
+}
+
+int
+Context::GetInputStrings(
+    CustomGetNextInputFn_t input_fn, void* input_context, const char* name,
+    const uint32_t batch_size, std::vector<std::string>* strings)
+{
+  strings->clear();
+
+  // The values for an input tensor are not necessarily in one
+  // contiguous chunk and a string or its length may be split across
+  // chunks, so the strings are assembled as the chunks are read.
+  char size_buffer[4];
+  size_t size_byte_cnt = 0;
+  uint32_t remaining = 0;
+  while (true) {
+    const void* content;
+    uint64_t content_byte_size = -1;
+    if (!input_fn(input_context, name, &content, &content_byte_size)) {
+      return kInputBuffer;
+    }
+
+    // If 'content' returns nullptr we have all the input.
+    if (content == nullptr) {
+      break;
+    }
+
+    const char* pos = static_cast<const char*>(content);
+    const char* end = pos + content_byte_size;
+    while (pos < end) {
+      if (remaining == 0) {
+        if (size_byte_cnt == 0) {
+          strings->emplace_back();
+        }
+        while ((size_byte_cnt < sizeof(size_buffer)) && (pos < end)) {
+          size_buffer[size_byte_cnt++] = *pos++;
+        }
+        if (size_byte_cnt < sizeof(size_buffer)) {
+          break;
+        }
+        memcpy(&remaining, size_buffer, sizeof(remaining));
+        size_byte_cnt = 0;
+
+        // The length comes from the client so only reserve for the
+        // bytes that are actually available. A length larger than the
+        // input is caught by the size check below.
+        strings->back().reserve(
+            std::min(static_cast<size_t>(remaining), (size_t)(end - pos)));
+        continue;
+      }
+
+      const size_t byte_cnt =
+          std::min(static_cast<size_t>(remaining), (size_t)(end - pos));
+      strings->back().append(pos, byte_cnt);
+      pos += byte_cnt;
+      remaining -= byte_cnt;
+    }
+  }
+
+  // Make sure we end up with exactly the amount of input we expect.
+  if ((size_byte_cnt != 0) || (remaining != 0) ||
+      (strings->size() != batch_size)) {
+    return kInputSize;
+  }
+
+  return kSuccess;
+}
+
+void
+Context::Tokenize(
+    const std::string& text_a, const std::string* text_b, int32_t* input_ids,
+    int32_t* input_mask, int32_t* segment_ids)
+{
+  ids_a_.clear();
+  ids_b_.clear();
+  tokenizer_->Tokenize(text_a.data(), text_a.size(), &ids_a_);
+  if (text_b != nullptr) {
+    tokenizer_->Tokenize(text_b->data(), text_b->size(), &ids_b_);
+  }
+
+  // Account for [CLS] and the [SEP] after each segment, then remove
+  // tokens from the end of the longer segment until the rest fit.
+  const size_t max_token_cnt = max_seq_length_ - ((text_b != nullptr) ? 3 : 2);
+  while ((ids_a_.size() + ids_b_.size()) > max_token_cnt) {
+    if (ids_a_.size() > ids_b_.size()) {
+      ids_a_.pop_back();
+    } else {
+      ids_b_.pop_back();
+    }
+  }
+
+  size_t pos = 0;
+  auto append = [&](const int32_t id, const int32_t segment) {
+    input_ids[pos] = id;
+    input_mask[pos] = 1;
+    segment_ids[pos] = segment;
+    pos++;
+  };
+
+  append(cls_id_, 0);
+  for (const int32_t id : ids_a_) {
+    append(id, 0);
+  }
+  append(sep_id_, 0);
+
+  if (text_b != nullptr) {
+    for (const int32_t id : ids_b_) {
+      append(id, 1);
+    }
+    append(sep_id_, 1);
+  }
+
+  for (; pos < max_seq_length_; ++pos) {
+    input_ids[pos] = 0;
+    input_mask[pos] = 0;
+    segment_ids[pos] = 0;
+  }
+}
+
+/////////////
+
+extern "C" {
+
+int
+CustomInitialize(const CustomInitializeData* data, void** custom_context)
+{
+  // Convert the serialized model config to a ModelConfig object.
+  ModelConfig model_config;
+  if (!model_config.ParseFromString(std::string(
+          data->serialized_model_config, data->serialized_model_config_size))) {
+    return kInvalidModelConfig;
+  }
+
+  // Create the context and validate that the model configuration is
+  // something that we can handle.
+  Context* context = new Context(
+      std::string(data->instance_name), model_config,
+      data->server_parameter_cnt, data->server_parameters);
+  int err = context->Init();
+  if (err != kSuccess) {
+    delete context;
+    return err;
+  }
+
+  *custom_context = static_cast<void*>(context);
+
+  return kSuccess;
+}
+
+int
+CustomFinalize(void* custom_context)
+{
+  if (custom_context != nullptr) {
+    Context* context = static_cast<Context*>(custom_context);
+    delete context;
+  }
+
+  return kSuccess;
+}
+
+const char*
+CustomErrorString(void* custom_context, int errcode)
+{
+  switch (errcode) {
+    case kSuccess:
+      return "success";
+    case kInvalidModelConfig:
+      return "invalid model configuration";
+    case kVocab:
+      return "unable to load vocabulary specified by 'vocab_file' parameter";
+    case kInput:
+      return "expected one or two inputs, each 1 STRING element";
+    case kInputBuffer:
+      return "unable to get buffer for input tensor values";
+    case kInputSize:
+      return "input obtained does not match batch size";
+    case kOutput:
+      return "expected INT32 outputs 'input_ids', 'input_mask' and "
+             "'segment_ids' with the same shape [ max_seq_length ]";
+    case kOutputBuffer:
+      return "unable to get buffer for output tensor values";
+    default:
+      break;
+  }
+
+  return "unknown error";
+}
+
+int
+CustomExecute(
+    void* custom_context, const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn)
+{
+  if (custom_context == nullptr) {
+    return kUnknown;
+  }
+
+  Context* context = static_cast<Context*>(custom_context);
+  return context->Execute(payload_cnt, payloads, input_fn, output_fn);
+}
+
+}  // extern "C"
+
+}}}}  // namespace nvidia::inferenceserver::custom::wordpiece_tokenizer
@@ -26,9 +26,11 @@
 //
 #pragma once
 
+#include <map>
 #include <memory>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "src/nvrpc/Interfaces.h"
 
@@ -39,6 +41,9 @@ namespace nvrpc {
 // arbitrary call order of ServerReaderWriter::Read() and
 // ServerReaderWriter::Write(), so we are able to handle
 // reading request and writing response seperately.
+// Requests keep being read while earlier requests are executing, up
+// to MaxInFlightRequests() requests whose response has not been
+// written yet.
 template <class Request, class Response>
 class BidirectionalStreamingLifeCycle : public IContextLifeCycle {
  public:
@@ -61,6 +66,8 @@ class BidirectionalStreamingLifeCycle : public IContextLifeCycle {
   struct ExecutionContext {
     RequestType m_Request;
     ResponseType m_Response;
+    // The position of the request in the stream
+    uint64_t m_Sequence;
   };
 
   using ExecutionContextType = ExecutionContext<RequestType, ResponseType>;
@@ -96,6 +103,24 @@ class BidirectionalStreamingLifeCycle : public IContextLifeCycle {
   // Function to actually process the request
   virtual void ExecuteRPC(RequestType& request, ResponseType& response) = 0;
 
+  // The maximum number of requests of a stream that have been read but
+  // whose response has not been written. Reading is paused while the
+  // limit is reached. Zero means no limit.
+  virtual size_t MaxInFlightRequests() { return 0; }
+
+  // If true the responses are written in the order of the requests,
+  // otherwise in the order the requests complete.
+  virtual bool WriteResponsesInOrder() { return false; }
+
+  // Reset the request and response of a completed RPC so that they
+  // can be reused by a later RPC. Clearing a message keeps the memory
+  // held by its repeated and string fields for reuse.
+  virtual void ResetMessages(RequestType& request, ResponseType& response)
+  {
+    request.Clear();
+    response.Clear();
+  }
+
   uintptr_t GetExecutionContext() final override;
   void CompleteExecution(uintptr_t execution_context) final override;
 
@@ -113,19 +138,47 @@ class BidirectionalStreamingLifeCycle : public IContextLifeCycle {
   bool StateResponseDone(bool ok);
   bool StateFinishedDone(bool ok);
 
+  // Whether MaxInFlightRequests() is reached, must be called with
+  // m_QueueMutex held
+  bool InFlightLimitReached();
+
+  // Return an execution context for the next request, reusing the
+  // messages of a completed request if there is one. Must be called
+  // with m_QueueMutex held
+  std::shared_ptr<ExecutionContextType> NextExecutionContext();
+
   // Function pointers
   ExecutorQueueFuncType m_QueuingFunc;
   bool (BidirectionalStreamingLifeCycle<RequestType, ResponseType>::*
             m_NextState)(bool);
 
   // Variables
-  // The mutex will be more useful once we can keep reading requests
-  // without waiting for response to be sent
+  // The mutex protects the execution contexts as requests are read,
+  // completed and written on different threads
   std::mutex m_QueueMutex;
   std::unordered_map<uintptr_t, std::shared_ptr<ExecutionContextType>>
       live_contexts;
   std::queue<std::shared_ptr<ExecutionContextType>> m_WriteBackQueue;
 
+  // Completed requests that wait for an earlier request to complete
+  // when writing responses in order, by sequence number
+  std::map<uint64_t, std::shared_ptr<ExecutionContextType>>
+      m_CompletedContexts;
+  uint64_t m_NextReadSequence;
+  uint64_t m_NextWriteSequence;
+
+  // Set when no read is pending because MaxInFlightRequests() was
+  // reached, the read is issued once a response is written
+  bool m_ReadPaused;
+
+  // Execution contexts whose response has been written, kept to be
+  // reused by later requests of this and later streams. At most
+  // MaxInFlightRequests() contexts, or kMaxFreeContexts if there is
+  // no in-flight limit, are kept so that a burst of requests doesn't
+  // pin its messages for the lifetime of the stream.
+  static constexpr size_t kMaxFreeContexts = 16;
+  std::vector<std::shared_ptr<ExecutionContextType>> m_FreeContexts;
+
   std::shared_ptr<ExecutionContextType> m_ExecutionContext;
 
   StateContext<RequestType, ResponseType> m_ReadStateContext;
@@ -202,6 +255,10 @@ BidirectionalStreamingLifeCycle<Request, Response>::Reset()
     std::lock_guard<std::mutex> lock(m_QueueMutex);
     m_WriteBackQueue.swap(empty_queue);
     live_contexts.clear();
+    m_CompletedContexts.clear();
+    m_NextReadSequence = 0;
+    m_NextWriteSequence = 0;
+    m_ReadPaused = false;
     m_ExecutionContext.reset();
     m_Context.reset(new ::grpc::ServerContext);
     m_ReaderWriter.reset(
@@ -229,7 +286,7 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateInitializedDone(
   // Start reading once connection is created
   {
     std::lock_guard<std::mutex> lock(m_QueueMutex);
-    m_ExecutionContext.reset(new ExecutionContext<Request, Response>);
+    m_ExecutionContext = NextExecutionContext();
     m_NextState = &BidirectionalStreamingLifeCycle<
         RequestType, ResponseType>::StateRequestDone;
   }
@@ -251,7 +308,8 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateRequestDone(bool ok)
   if (!ok) {
     {
       std::lock_guard<std::mutex> lock(m_QueueMutex);
-      if (!live_contexts.empty() || !m_WriteBackQueue.empty()) {
+      if (!live_contexts.empty() || !m_CompletedContexts.empty() ||
+          !m_WriteBackQueue.empty()) {
         // if state is not StateRequestDone, Finish() is called
         // or is going to be called, don't "undo" the state change
         if (m_NextState == &BidirectionalStreamingLifeCycle<
@@ -271,15 +329,26 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateRequestDone(bool ok)
     std::lock_guard<std::mutex> lock(m_QueueMutex);
 
     // Put the execution context in live context set
+    m_ExecutionContext->m_Sequence = m_NextReadSequence++;
     live_contexts.emplace(GetExecutionContext(), m_ExecutionContext);
   }
   // Always start RPC on receiving request successfully
   ExecuteRPC(m_ExecutionContext->m_Request, m_ExecutionContext->m_Response);
 
-  // Start reading the next request
-  m_ExecutionContext.reset(new ExecutionContext<Request, Response>);
-  m_ReaderWriter->Read(
-      &m_ExecutionContext->m_Request, m_ReadStateContext.IContext::Tag());
+  // Start reading the next request, unless too many requests are in
+  // flight in which case StateResponseDone() starts reading once
+  // enough responses are written
+  bool should_read = false;
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_ExecutionContext = NextExecutionContext();
+    m_ReadPaused = InFlightLimitReached();
+    should_read = !m_ReadPaused;
+  }
+  if (should_read) {
+    m_ReaderWriter->Read(
+        &m_ExecutionContext->m_Request, m_ReadStateContext.IContext::Tag());
+  }
 
   return true;
 }
@@ -299,17 +368,38 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateResponseDone(bool ok)
   }
 
   // Done writing back one response
-  bool should_write = true;
+  std::shared_ptr<ExecutionContextType> next_write;
+  bool should_read = false;
   bool should_finish = false;
   {
     std::lock_guard<std::mutex> lock(m_QueueMutex);
 
-    // Front of the queue is done, clean up that execution context
+    // Front of the queue is done, keep that execution context for
+    // reuse unless enough contexts are already kept
+    size_t max_free = MaxInFlightRequests();
+    if (max_free == 0) {
+      max_free = kMaxFreeContexts;
+    }
+    if (m_FreeContexts.size() < max_free) {
+      m_FreeContexts.push_back(m_WriteBackQueue.front());
+      ResetMessages(
+          m_FreeContexts.back()->m_Request,
+          m_FreeContexts.back()->m_Response);
+    }
     m_WriteBackQueue.pop();
-    should_write = !m_WriteBackQueue.empty();
+    if (!m_WriteBackQueue.empty()) {
+      next_write = m_WriteBackQueue.front();
+    }
+
+    // Resume reading if it was paused for this response
+    if (m_ReadPaused && !InFlightLimitReached()) {
+      m_ReadPaused = false;
+      should_read = true;
+    }
 
     // check if all requests are processed
-    if (!should_write && live_contexts.empty() &&
+    if ((next_write == nullptr) && live_contexts.empty() &&
+        m_CompletedContexts.empty() &&
         m_NextState == &BidirectionalStreamingLifeCycle<
                            RequestType, ResponseType>::StateResponseDone) {
       should_finish = true;
@@ -319,12 +409,15 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateResponseDone(bool ok)
     FinishResponse();
     return true;
   }
+  if (should_read) {
+    m_ReaderWriter->Read(
+        &m_ExecutionContext->m_Request, m_ReadStateContext.IContext::Tag());
+  }
   // Only call Write() if the write back queue is not empty,
   // the CompleteExecution() will call Write() otherwise.
-  if (should_write) {
+  if (next_write != nullptr) {
     m_ReaderWriter->Write(
-        m_WriteBackQueue.front()->m_Response,
-        m_WriteStateContext.IContext::Tag());
+        next_write->m_Response, m_WriteStateContext.IContext::Tag());
   }
   return true;
 }
@@ -336,6 +429,30 @@ BidirectionalStreamingLifeCycle<Request, Response>::StateFinishedDone(bool ok)
   return false;
 }
 
+template <class Request, class Response>
+bool
+BidirectionalStreamingLifeCycle<Request, Response>::InFlightLimitReached()
+{
+  const size_t max_in_flight = MaxInFlightRequests();
+  return (max_in_flight != 0) &&
+         ((live_contexts.size() + m_CompletedContexts.size() +
+           m_WriteBackQueue.size()) >= max_in_flight);
+}
+
+template <class Request, class Response>
+std::shared_ptr<typename BidirectionalStreamingLifeCycle<
+    Request, Response>::ExecutionContextType>
+BidirectionalStreamingLifeCycle<Request, Response>::NextExecutionContext()
+{
+  if (m_FreeContexts.empty()) {
+    return std::make_shared<ExecutionContextType>();
+  }
+
+  auto context = std::move(m_FreeContexts.back());
+  m_FreeContexts.pop_back();
+  return context;
+}
+
 template <class Request, class Response>
 uintptr_t
 BidirectionalStreamingLifeCycle<Request, Response>::GetExecutionContext()
@@ -348,15 +465,32 @@ void
 BidirectionalStreamingLifeCycle<Request, Response>::CompleteExecution(
     uintptr_t execution_context)
 {
-  bool should_write = false;
+  std::shared_ptr<ExecutionContextType> next_write;
   bool should_cancel = false;
   {
     std::lock_guard<std::mutex> lock(m_QueueMutex);
     auto it = live_contexts.find(execution_context);
     if (it != live_contexts.end()) {
-      should_write = m_WriteBackQueue.empty();
-      m_WriteBackQueue.push(it->second);
-      live_contexts.erase(execution_context);
+      // A response is being written if the queue is not empty
+      const bool writing = !m_WriteBackQueue.empty();
+      if (WriteResponsesInOrder()) {
+        // Queue this and any following completed responses once all
+        // earlier responses are queued
+        m_CompletedContexts.emplace(it->second->m_Sequence, it->second);
+        while (!m_CompletedContexts.empty() &&
+               (m_CompletedContexts.begin()->first == m_NextWriteSequence)) {
+          m_WriteBackQueue.push(m_CompletedContexts.begin()->second);
+          m_CompletedContexts.erase(m_CompletedContexts.begin());
+          m_NextWriteSequence++;
+        }
+      } else {
+        m_WriteBackQueue.push(it->second);
+      }
+      live_contexts.erase(it);
+
+      if (!writing && !m_WriteBackQueue.empty()) {
+        next_write = m_WriteBackQueue.front();
+      }
     } else {
       // Unexpected behavior, cancel the stream
       should_cancel = true;
@@ -371,10 +505,9 @@ BidirectionalStreamingLifeCycle<Request, Response>::CompleteExecution(
   if (should_cancel) {
     CancelResponse();
   }
-  if (should_write) {
+  if (next_write != nullptr) {
     m_ReaderWriter->Write(
-        m_WriteBackQueue.front()->m_Response,
-        m_WriteStateContext.IContext::Tag());
+        next_write->m_Response, m_WriteStateContext.IContext::Tag());
   }
 }
 
@@ -47,6 +47,36 @@ Executor::ProgressEngine(int thread_id)
   bool ok;
   void* tag;
   auto myCQ = m_ServerCompletionQueues[thread_id].get();
+  auto& myContexts = m_Contexts[thread_id];
+
+  // A failure is reported to Run(), but the CQ is still polled so that
+  // it is drained when the executor is shut down.
+  std::exception_ptr error;
+  try {
+    for (const auto& registration : m_Registrations) {
+      for (int j = 0; j < registration.numContextsPerThread; j++) {
+        myContexts.emplace_back(this->CreateContext(
+            registration.rpc, myCQ, registration.resources));
+      }
+    }
+    // Queue the Execution Contexts in the recieve queue
+    for (auto& ctx : myContexts) {
+      // Reseting the context decrements the gauge
+      ResetContext(ctx.get());
+    }
+  }
+  catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_StartedMutex);
+    if ((error != nullptr) && (m_StartupError == nullptr)) {
+      m_StartupError = error;
+    }
+    m_StartedThreads++;
+  }
+  m_StartedCv.notify_all();
 
   while (myCQ->Next(&tag, &ok)) {
     auto ctx = IContext::Detag(tag);
@@ -30,7 +30,11 @@
 #include "src/nvrpc/Resources.h"
 #include "src/nvrpc/ThreadPool.h"
 
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 namespace nvrpc {
 
@@ -46,33 +50,37 @@ class Executor : public IExecutor {
     for (int i = 0; i < m_ThreadPool->Size(); i++) {
       m_ServerCompletionQueues.emplace_back(builder.AddCompletionQueue());
     }
+    m_Contexts.resize(m_ServerCompletionQueues.size());
   }
 
+  // The contexts are created by the progress engine that polls their CQ
+  // so that each thread owns its CQ and contexts, and their allocations
+  // are first touched by that thread.
   void RegisterContexts(
       IRPC* rpc, std::shared_ptr<Resources> resources,
       int numContextsPerThread) final override
   {
-    // CHECK_EQ(m_ThreadPool->Size(), m_ServerCompletionQueues.size()) <<
-    // "Incorrect number of CQs";
-    for (int i = 0; i < m_ThreadPool->Size(); i++) {
-      auto cq = m_ServerCompletionQueues[i].get();
-      for (int j = 0; j < numContextsPerThread; j++) {
-        m_Contexts.emplace_back(this->CreateContext(rpc, cq, resources));
-      }
-    }
+    m_Registrations.push_back({rpc, resources, numContextsPerThread});
   }
 
+  // Throws the first exception raised while a thread was creating its
+  // Execution Contexts. The threads keep polling their CQs after a
+  // failure, so the executor must still be Shutdown().
   void Run() final override
   {
     m_Running = true;
-    // Launch the threads polling on their CQs
+    // Launch the threads polling on their CQs. Each thread creates and
+    // queues its Execution Contexts in the recieve queue before polling.
+    // Wait for all of them so that the executor is serving once Run()
+    // returns.
     for (int i = 0; i < m_ThreadPool->Size(); i++) {
-      m_ThreadPool->enqueue([this, i] { ProgressEngine(i); });
+      m_ThreadPool->Submit([this, i] { ProgressEngine(i); });
     }
-    // Queue the Execution Contexts in the recieve queue
-    for (size_t i = 0; i < m_Contexts.size(); i++) {
-      // Reseting the context decrements the gauge
-      ResetContext(m_Contexts[i].get());
+    std::unique_lock<std::mutex> lock(m_StartedMutex);
+    m_StartedCv.wait(
+        lock, [this] { return m_StartedThreads == m_ThreadPool->Size(); });
+    if (m_StartupError != nullptr) {
+      std::rethrow_exception(m_StartupError);
     }
   }
 
@@ -85,12 +93,27 @@ class Executor : public IExecutor {
   }
 
  private:
+  struct Registration {
+    IRPC* rpc;
+    std::shared_ptr<Resources> resources;
+    int numContextsPerThread;
+  };
+
   void ProgressEngine(int thread_id);
 
   volatile bool m_Running;
-  std::vector<std::unique_ptr<IContext>> m_Contexts;
+  std::vector<Registration> m_Registrations;
+  std::vector<std::vector<std::unique_ptr<IContext>>> m_Contexts;
   std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>>
       m_ServerCompletionQueues;
+
+  // The number of threads that are done creating their contexts, and
+  // the first exception raised while doing so.
+  std::mutex m_StartedMutex;
+  std::condition_variable m_StartedCv;
+  int m_StartedThreads = 0;
+  std::exception_ptr m_StartupError;
+
   std::unique_ptr<ThreadPool> m_ThreadPool;
 };
 
@@ -51,6 +51,15 @@ class LifeCycleUnary : public IContextLifeCycle {
 
   virtual void ExecuteRPC(RequestType& request, ResponseType& response) = 0;
 
+  // Reset the request and response of a completed RPC so that they
+  // can be reused by a later RPC. Clearing a message keeps the memory
+  // held by its repeated and string fields for reuse.
+  virtual void ResetMessages(RequestType& request, ResponseType& response)
+  {
+    request.Clear();
+    response.Clear();
+  }
+
   uintptr_t GetExecutionContext() final override { return 0; }
   void CompleteExecution(uintptr_t execution_context) final override
   {
@@ -130,8 +139,7 @@ void
 LifeCycleUnary<Request, Response>::Reset()
 {
   OnLifeCycleReset();
-  m_Request.Clear();
-  m_Response.Clear();
+  ResetMessages(m_Request, m_Response);
   m_Context.reset(new ::grpc::ServerContext);
   m_ResponseWriter.reset(
       new ::grpc::ServerAsyncResponseWriter<ResponseType>(m_Context.get()));
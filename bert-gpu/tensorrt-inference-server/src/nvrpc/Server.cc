@@ -69,8 +69,25 @@ Server::AsyncRun()
 {
   m_Running = true;
   m_Server = m_Builder.BuildAndStart();
-  for (size_t i = 0; i < m_Executors.size(); i++) {
-    m_Executors[i]->Run();
+  if (m_Server == nullptr) {
+    for (size_t i = 0; i < m_Executors.size(); i++) {
+      m_Executors[i]->Shutdown();
+    }
+    m_Executors.clear();
+    throw std::runtime_error(
+        "Unable to start the Server on " + m_ServerAddress + ".");
+  }
+
+  try {
+    for (size_t i = 0; i < m_Executors.size(); i++) {
+      m_Executors[i]->Run();
+    }
+  }
+  catch (...) {
+    // Stop the executors, including the threads of the one that failed,
+    // before reporting the failure.
+    Shutdown();
+    throw;
   }
 }
 
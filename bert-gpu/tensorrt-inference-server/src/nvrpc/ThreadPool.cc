@@ -54,35 +54,257 @@
 //
 #include "src/nvrpc/ThreadPool.h"
 
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 namespace nvrpc {
+namespace {
+
+// The pool and queue index of the calling thread when it is a worker,
+// so that tasks it submits go to its own queue.
+thread_local ThreadPool* tl_pool = nullptr;
+thread_local size_t tl_index = 0;
+
+// The number of tasks in a row that a worker has taken from its local
+// deque while its injection queue was not empty. After
+// kMaxLocalStreak such tasks the worker takes the oldest injected
+// task, so a worker that keeps submitting to itself can't starve
+// tasks submitted from outside the pool.
+constexpr size_t kMaxLocalStreak = 32;
+thread_local size_t tl_local_streak = 0;
+
+// Return the NUMA node of 'cpu', or 0 if it can't be determined (for
+// example on a kernel without NUMA support).
+int
+CpuNumaNode(int cpu)
+{
+  const std::string path =
+      "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+
+  int node = 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if ((strncmp(entry->d_name, "node", 4) == 0) &&
+        (entry->d_name[4] >= '0') && (entry->d_name[4] <= '9')) {
+      node = atoi(entry->d_name + 4);
+      break;
+    }
+  }
+
+  closedir(dir);
+  return node;
+}
+
+}  // namespace
+
+ThreadPool::Task::Task(Task&& other) noexcept : ops(other.ops)
+{
+  if (ops != nullptr) {
+    ops->move(&storage, &other.storage);
+    other.ops = nullptr;
+  }
+}
+
+ThreadPool::Task&
+ThreadPool::Task::operator=(Task&& other) noexcept
+{
+  if (this != &other) {
+    Reset();
+    ops = other.ops;
+    if (ops != nullptr) {
+      ops->move(&storage, &other.storage);
+      other.ops = nullptr;
+    }
+  }
+  return *this;
+}
+
+void
+ThreadPool::Task::Reset()
+{
+  if (ops != nullptr) {
+    ops->destroy(&storage);
+    ops = nullptr;
+  }
+}
+
+ThreadPool::ThreadPool(size_t nThreads)
+    : next_queue(0), pending(0), idle(0), stop(false)
+{
+  for (size_t i = 0; i < nThreads; ++i) {
+    queues.emplace_back(new WorkQueue);
+  }
+  for (size_t i = 0; i < nThreads; ++i) {
+    InitThread(i, -1);
+  }
+}
+
+ThreadPool::ThreadPool(const std::vector<int>& cpus)
+    : next_queue(0), pending(0), idle(0), stop(false)
+{
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    queues.emplace_back(new WorkQueue);
+  }
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    InitThread(i, cpus[i]);
+  }
+}
 
-ThreadPool::ThreadPool(size_t nThreads) : stop(false)
+std::vector<int>
+ThreadPool::NumaOrderedCpus(size_t nThreads)
 {
+  std::vector<std::pair<int, int>> node_cpus;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &mask)) {
+        node_cpus.emplace_back(CpuNumaNode(cpu), cpu);
+      }
+    }
+  }
+
+  std::vector<int> cpus;
+  if (node_cpus.empty()) {
+    return cpus;
+  }
+
+  std::sort(node_cpus.begin(), node_cpus.end());
   for (size_t i = 0; i < nThreads; ++i) {
-    InitThread();
+    cpus.push_back(node_cpus[i % node_cpus.size()].second);
   }
+
+  return cpus;
 }
 
 void
-ThreadPool::InitThread()
+ThreadPool::InitThread(size_t index, int cpu)
 {
-  workers.emplace_back([this]() {
+  workers.emplace_back([this, index]() {
+    tl_pool = this;
+    tl_index = index;
+
+    Task task;
     for (;;) {
-      std::function<void()> task;
-
-      {
-        std::unique_lock<std::mutex> lock(this->queue_mutex);
-        this->condition.wait(
-            lock, [this]() { return this->stop || !this->tasks.empty(); });
-        if (this->stop && this->tasks.empty())
-          return;
-        task = move(this->tasks.front());
-        this->tasks.pop();
+      if (Pop(index, &task)) {
+        task();
+        task = Task();
+        continue;
       }
 
-      task();
+      // 'idle' is raised before 'pending' is checked and Push() raises
+      // 'pending' before checking 'idle', so either this worker sees the
+      // new task or the submitter sees this worker and wakes it.
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      idle++;
+      condition.wait(lock, [this]() { return stop || (pending > 0); });
+      idle--;
+      if (stop && (pending == 0)) {
+        return;
+      }
     }
   });
+
+  // Pinning is best effort, a CPU outside of the cgroup or affinity
+  // mask of the process leaves the thread unpinned.
+  if (cpu >= 0) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(
+        workers.back().native_handle(), sizeof(cpu_set_t), &cpuset);
+  }
+}
+
+void
+ThreadPool::Push(Task&& task)
+{
+  // don't allow enqueueing after stopping the pool, except from the
+  // pool's own tasks which are still drained
+  if (stop && (tl_pool != this)) {
+    throw std::runtime_error("enqueue on stopped ThreadPool");
+  }
+
+  // Count the task before it is visible so that 'pending' never drops
+  // below the number of queued tasks.
+  pending++;
+  if (tl_pool == this) {
+    WorkQueue& own = *queues[tl_index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.local.emplace_back(std::move(task));
+  } else {
+    const size_t index =
+        next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    WorkQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.injected.emplace_back(std::move(task));
+  }
+
+  if (idle > 0) {
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    condition.notify_one();
+  }
+}
+
+bool
+ThreadPool::Pop(size_t index, Task* task)
+{
+  // The owner takes the most recent task from its local deque, which
+  // is the one most likely to still be in its cache, unless it has
+  // done so kMaxLocalStreak times in a row while injected tasks were
+  // waiting. Injected tasks are taken oldest first.
+  {
+    WorkQueue& own = *queues[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.local.empty() &&
+        (own.injected.empty() || (tl_local_streak < kMaxLocalStreak))) {
+      if (!own.injected.empty()) {
+        tl_local_streak++;
+      }
+      *task = std::move(own.local.back());
+      own.local.pop_back();
+      pending--;
+      return true;
+    }
+    if (!own.injected.empty()) {
+      tl_local_streak = 0;
+      *task = std::move(own.injected.front());
+      own.injected.pop_front();
+      pending--;
+      return true;
+    }
+  }
+
+  // Steal the oldest task of another worker, preferring tasks
+  // submitted from outside the pool.
+  for (size_t i = 1; i < queues.size(); ++i) {
+    WorkQueue& victim = *queues[(index + i) % queues.size()];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      continue;
+    }
+    std::deque<Task>& tasks =
+        victim.injected.empty() ? victim.local : victim.injected;
+    if (!tasks.empty()) {
+      *task = std::move(tasks.front());
+      tasks.pop_front();
+      pending--;
+      return true;
+    }
+  }
+
+  return false;
 }
 
 int
@@ -95,7 +317,7 @@ ThreadPool::Size()
 ThreadPool::~ThreadPool()
 {
   {
-    std::unique_lock<std::mutex> lock(queue_mutex);
+    std::unique_lock<std::mutex> lock(sleep_mutex);
     stop = true;
   }
   condition.notify_all();
@@ -55,30 +55,125 @@
 //   * Added an extra safety check (lines 30-31) in the construction (.cc file).
 //   * Added CPU affinity options to the constructor
 //   * Added Size() method to get thread count
+//   * Added NumaOrderedCpus() to choose the CPUs for the affinity constructor
+//   * Replaced the shared task queue with per-worker deques and work stealing
+//   * Added Submit() for fire-and-forget tasks and the allocation-free Task
 //
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <future>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace nvrpc {
 
 /**
- * @brief Manages a Pool of Threads that consume a shared work Queue
+ * @brief Manages a Pool of Threads that consume per-worker work Queues
  *
  * ThreadPool is the primary resoruce class for handling threads used throughout
  * the examples and tests.  The library is entirely a BYO-resources; however,
  * this implemenation is provided as a convenience class.  Many thanks to the
  * original authors for a beautifully designed class.
+ *
+ * Each worker owns a local deque and a FIFO injection queue of tasks.  Tasks
+ * submitted from a worker are pushed on and popped from the back of that
+ * worker's local deque; tasks submitted from other threads are spread
+ * round-robin over the injection queues and run in submission order.  A worker
+ * periodically takes from its injection queue even while it has local tasks,
+ * so external tasks are not starved.  A worker with no tasks steals the oldest
+ * task of the other workers before going to sleep.
  */
 class ThreadPool {
  public:
+  /**
+   * @brief Move-only callable stored in the work Queues
+   *
+   * Callables of up to kInlineSize bytes are stored inline, so the lambdas
+   * used throughout nvrpc are queued without a heap allocation.  Larger
+   * callables are moved to the heap.
+   */
+  class Task {
+   public:
+    static constexpr size_t kInlineSize = 64;
+
+    Task() : ops(nullptr) {}
+
+    template <
+        class F, class Fn = typename std::decay<F>::type,
+        class = typename std::enable_if<!std::is_same<Fn, Task>::value>::type>
+    Task(F&& f);
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { Reset(); }
+
+    void operator()() { ops->invoke(&storage); }
+    explicit operator bool() const { return ops != nullptr; }
+
+   private:
+    struct Ops {
+      void (*invoke)(void*);
+      void (*move)(void* dst, void* src);
+      void (*destroy)(void*);
+    };
+
+    template <class Fn>
+    struct InlineOps {
+      static void Invoke(void* s) { (*static_cast<Fn*>(s))(); }
+      static void Move(void* dst, void* src)
+      {
+        new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+        static_cast<Fn*>(src)->~Fn();
+      }
+      static void Destroy(void* s) { static_cast<Fn*>(s)->~Fn(); }
+    };
+
+    template <class Fn>
+    struct HeapOps {
+      static void Invoke(void* s) { (**static_cast<Fn**>(s))(); }
+      static void Move(void* dst, void* src)
+      {
+        *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+      }
+      static void Destroy(void* s) { delete *static_cast<Fn**>(s); }
+    };
+
+    template <class Fn, class F>
+    void Init(F&& f, std::true_type /* inline */);
+    template <class Fn, class F>
+    void Init(F&& f, std::false_type /* inline */);
+    void Reset();
+
+    typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type
+        storage;
+    const Ops* ops;
+  };
+
   /**
    * @brief Construct a new Thread Pool
    * @param nThreads Number of Worker Threads
    */
   ThreadPool(size_t nThreads);
 
+  /**
+   * @brief Construct a new Thread Pool with one Worker Thread per entry of
+   * cpus, each pinned to that CPU
+   * @param cpus CPU id of each Worker Thread
+   */
+  ThreadPool(const std::vector<int>& cpus);
+
   ~ThreadPool();
 
   /**
@@ -95,6 +190,9 @@ class ThreadPool {
    * using libevent or asio.  Happy to accept PRs to improve the async
    * abilities.
    *
+   * Prefer Submit() when the result is not needed, enqueue allocates the
+   * shared state of the returned future.
+   *
    * @tparam F
    * @tparam Args
    * @param f
@@ -105,25 +203,96 @@ class ThreadPool {
   auto enqueue(F&& f, Args&&... args)
       -> std::future<typename std::result_of<F(Args...)>::type>;
 
+  /**
+   * @brief Submit fire-and-forget Work to the ThreadPool
+   *
+   * Unlike enqueue there is no future, and a callable that fits in a Task is
+   * queued without allocating.
+   *
+   * @tparam F
+   * @param f
+   */
+  template <class F>
+  void Submit(F&& f)
+  {
+    Push(Task(std::forward<F>(f)));
+  }
+
   /**
    * @brief Number of Threads in the Pool
    */
   int Size();
 
+  /**
+   * @brief Pick CPUs to pin nThreads Worker Threads to
+   *
+   * The CPUs are taken from the affinity mask of the calling process and
+   * are grouped by NUMA node, so that consecutive threads share a node.  If
+   * there are more threads than CPUs the CPUs are reused round-robin.
+   */
+  static std::vector<int> NumaOrderedCpus(size_t nThreads);
+
  private:
-  void InitThread();
+  struct WorkQueue {
+    std::mutex mutex;
+    // tasks submitted by the worker itself, run newest first
+    std::deque<Task> local;
+    // tasks submitted from outside the pool, run oldest first
+    std::deque<Task> injected;
+  };
+
+  void InitThread(size_t index, int cpu);
+  void Push(Task&& task);
+  bool Pop(size_t index, Task* task);
 
   // need to keep track of threads so we can join them
   std::vector<std::thread> workers;
-  // the task queue
-  std::queue<std::function<void()>> tasks;
+  // the task queue of each worker
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  // the injection queue that receives the next task submitted from outside
+  // the pool
+  std::atomic<size_t> next_queue;
 
-  // synchronization
-  std::mutex queue_mutex;
+  // synchronization, 'pending' counts the queued tasks and 'idle' the
+  // workers waiting on 'condition'
+  std::atomic<size_t> pending;
+  std::atomic<size_t> idle;
+  std::mutex sleep_mutex;
   std::condition_variable condition;
-  bool stop;
+  std::atomic<bool> stop;
 };
 
+template <class F, class Fn, class>
+ThreadPool::Task::Task(F&& f)
+{
+  Init<Fn>(
+      std::forward<F>(f),
+      std::integral_constant<
+          bool, (sizeof(Fn) <= kInlineSize) &&
+                    (alignof(Fn) <= alignof(std::max_align_t)) &&
+                    std::is_nothrow_move_constructible<Fn>::value>());
+}
+
+template <class Fn, class F>
+void
+ThreadPool::Task::Init(F&& f, std::true_type /* inline */)
+{
+  static const Ops inline_ops = {&InlineOps<Fn>::Invoke, &InlineOps<Fn>::Move,
+                                 &InlineOps<Fn>::Destroy};
+  new (&storage) Fn(std::forward<F>(f));
+  ops = &inline_ops;
+}
+
+template <class Fn, class F>
+void
+ThreadPool::Task::Init(F&& f, std::false_type /* inline */)
+{
+  static const Ops heap_ops = {&HeapOps<Fn>::Invoke, &HeapOps<Fn>::Move,
+                               &HeapOps<Fn>::Destroy};
+  *reinterpret_cast<Fn**>(&storage) = new Fn(std::forward<F>(f));
+  ops = &heap_ops;
+}
+
 // add new work item to the pool
 template <class F, class... Args>
 auto
@@ -136,16 +305,7 @@ ThreadPool::enqueue(F&& f, Args&&... args)
       std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
   std::future<return_type> res = task->get_future();
-  {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-
-    // don't allow enqueueing after stopping the pool
-    if (stop)
-      throw std::runtime_error("enqueue on stopped ThreadPool");
-
-    tasks.emplace([task]() { (*task)(); });
-  }
-  condition.notify_one();
+  Push(Task([task]() { (*task)(); }));
   return res;
 }
 
@@ -0,0 +1,153 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/nvrpc/ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace nvrpc {
+namespace {
+
+// Blocks the worker that runs it until Release() is called, so that
+// tasks can be queued behind it.
+class Gate {
+ public:
+  Gate() : open_(false) {}
+
+  void Wait()
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this]() { return open_; });
+  }
+
+  void Release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      open_ = true;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool open_;
+};
+
+TEST(ThreadPoolTest, InjectedFifoOrder)
+{
+  // With a single worker the tasks submitted from outside the pool
+  // run in submission order, for both Submit() and enqueue().
+  std::vector<int> order;
+  Gate gate;
+  {
+    ThreadPool pool(1);
+    pool.Submit([&gate]() { gate.Wait(); });
+    for (int i = 0; i < 100; ++i) {
+      if ((i % 2) == 0) {
+        pool.Submit([&order, i]() { order.push_back(i); });
+      } else {
+        pool.enqueue([&order, i]() { order.push_back(i); });
+      }
+    }
+    gate.Release();
+  }
+
+  ASSERT_EQ(order.size(), (size_t)100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(ThreadPoolTest, DrainOnDestruction)
+{
+  // Every task queued before the pool is destroyed runs before the
+  // destructor returns, including the tasks that those tasks submit.
+  std::atomic<size_t> done(0);
+  Gate gate;
+  {
+    ThreadPool pool(4);
+    for (int t = 0; t < pool.Size(); ++t) {
+      pool.Submit([&gate]() { gate.Wait(); });
+    }
+    for (int i = 0; i < 1000; ++i) {
+      pool.Submit([&pool, &done]() {
+        pool.Submit([&done]() { done++; });
+        done++;
+      });
+    }
+    gate.Release();
+  }
+
+  EXPECT_EQ(done.load(), (size_t)2000);
+}
+
+TEST(ThreadPoolTest, EnqueueResult)
+{
+  ThreadPool pool(2);
+  auto sum = pool.enqueue([](int a, int b) { return a + b; }, 2, 3);
+  auto text = pool.enqueue([]() { return std::string("done"); });
+  EXPECT_EQ(sum.get(), 5);
+  EXPECT_EQ(text.get(), "done");
+}
+
+TEST(ThreadPoolTest, TaskStorage)
+{
+  // Small callables are stored inline and larger ones on the heap,
+  // both must be invoked once and destroyed once, including after
+  // being moved.
+  std::shared_ptr<int> count = std::make_shared<int>(0);
+  {
+    ThreadPool::Task small([count]() { (*count)++; });
+    struct Large {
+      char pad[2 * ThreadPool::Task::kInlineSize];
+    } large;
+    ThreadPool::Task big([count, large]() { (*count) += 10; });
+    EXPECT_EQ(count.use_count(), 3);
+
+    ThreadPool::Task moved_small(std::move(small));
+    ThreadPool::Task moved_big;
+    moved_big = std::move(big);
+    EXPECT_FALSE(small);
+    EXPECT_FALSE(big);
+    EXPECT_EQ(count.use_count(), 3);
+
+    moved_small();
+    moved_big();
+    EXPECT_EQ(*count, 11);
+  }
+  EXPECT_EQ(count.use_count(), 1);
+}
+
+}  // namespace
+}  // namespace nvrpc
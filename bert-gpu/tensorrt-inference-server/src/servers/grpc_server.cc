@@ -26,6 +26,7 @@
 
 #include "src/servers/grpc_server.h"
 
+#include <algorithm>
 #include <map>
 #include "grpc++/security/server_credentials.h"
 #include "grpc++/server.h"
@@ -57,19 +58,29 @@ namespace {
 class AsyncResources : public nvrpc::Resources {
  public:
   explicit AsyncResources(
-      InferenceServer* server, int infer_threads, int mgmt_threads)
-      : m_Server(server), m_MgmtThreadPool(mgmt_threads),
-        m_InferThreadPool(infer_threads)
+      InferenceServer* server, int infer_threads, int mgmt_threads,
+      size_t stream_infer_window, bool stream_infer_in_order)
+      : m_Server(server), m_StreamInferWindow(stream_infer_window),
+        m_StreamInferInOrder(stream_infer_in_order),
+        m_MgmtThreadPool(mgmt_threads), m_InferThreadPool(infer_threads)
   {
   }
 
   InferenceServer* GetServer() { return m_Server; }
+  size_t StreamInferWindow() const { return m_StreamInferWindow; }
+  bool StreamInferInOrder() const { return m_StreamInferInOrder; }
   ThreadPool& GetMgmtThreadPool() { return m_MgmtThreadPool; }
   ThreadPool& GetInferThreadPool() { return m_InferThreadPool; }
 
  private:
   InferenceServer* m_Server;
 
+  // The maximum number of requests in flight on each inference
+  // stream (0 for no limit) and whether the responses of a stream
+  // are written in request order.
+  size_t m_StreamInferWindow;
+  bool m_StreamInferInOrder;
+
   // We can and should get specific on thread affinity.  It might not
   // be as important on the frontend, but the backend threadpool
   // should be aligned with the respective devices.
@@ -85,7 +96,7 @@ class StatusContext final
       StatusRequest& request, StatusResponse& response) final override
   {
     uintptr_t execution_context = this->GetExecutionContext();
-    GetResources()->GetMgmtThreadPool().enqueue(
+    GetResources()->GetMgmtThreadPool().Submit(
         [this, execution_context, &request, &response] {
           ServerStatTimerScoped timer(
               GetResources()->GetServer()->StatusManager(),
@@ -140,16 +151,29 @@ class InferBaseContext : public BaseContext<LifeCycle, AsyncResources> {
     server->HandleInfer(
         request_status, backend, request_provider, response_provider,
         infer_stats,
-        [this, execution_context, id, request_status, &response, infer_stats,
-         timer]() mutable {
+        [this, execution_context, id, request_status, &response,
+         response_provider, infer_stats, timer]() mutable {
           // If the response is an error then clear the meta-data
           // and raw output as they may be partially or
-          // un-initialized.
+          // un-initialized. Otherwise drop any raw outputs kept from
+          // a previous response that this response did not use.
           if (request_status->code() != RequestStatusCode::SUCCESS) {
             response.mutable_meta_data()->Clear();
             response.mutable_raw_output()->Clear();
+          } else {
+            while (response.raw_output_size() >
+                   response.meta_data().output_size()) {
+              response.mutable_raw_output()->RemoveLast();
+            }
           }
 
+          uint32_t allocation_cnt, reuse_cnt;
+          size_t allocation_byte_size;
+          response_provider->OutputBufferStats(
+              &allocation_cnt, &allocation_byte_size, &reuse_cnt);
+          infer_stats->SetOutputBufferStats(
+              allocation_cnt, allocation_byte_size, reuse_cnt);
+
           response.mutable_meta_data()->set_id(id);
           this->CompleteExecution(execution_context);
           timer.reset();
@@ -158,6 +182,32 @@ class InferBaseContext : public BaseContext<LifeCycle, AsyncResources> {
     return Status::Success;
   }
 
+  // Keep the raw outputs of the response so that the next response
+  // on this context can write its outputs to them without allocating
+  // the memory again, see
+  // GRPCInferResponseProvider::AllocateOutputBuffer(). Only up to
+  // GRPC_MAX_REUSED_OUTPUT_BYTE_SIZE bytes are kept, the memory of
+  // the raw outputs beyond that is released so that an occasional
+  // large response doesn't stay allocated for the life of the
+  // context.
+  void ResetMessages(
+      InferRequest& request, InferResponse& response) final override
+  {
+    request.Clear();
+    response.mutable_request_status()->Clear();
+    response.mutable_meta_data()->Clear();
+
+    uint64_t kept_byte_size = 0;
+    for (std::string& raw_output : *response.mutable_raw_output()) {
+      if ((kept_byte_size + raw_output.capacity()) >
+          GRPC_MAX_REUSED_OUTPUT_BYTE_SIZE) {
+        std::string().swap(raw_output);
+      } else {
+        kept_byte_size += raw_output.capacity();
+      }
+    }
+  }
+
   void ExecuteRPC(InferRequest& request, InferResponse& response) final override
   {
     auto server = this->GetResources()->GetServer();
@@ -194,6 +244,15 @@ class InferContext final
 class StreamInferContext final
     : public InferBaseContext<
           BidirectionalStreamingLifeCycle<InferRequest, InferResponse>> {
+  size_t MaxInFlightRequests() final override
+  {
+    return GetResources()->StreamInferWindow();
+  }
+
+  bool WriteResponsesInOrder() final override
+  {
+    return GetResources()->StreamInferInOrder();
+  }
 };
 
 class ProfileContext final
@@ -202,7 +261,7 @@ class ProfileContext final
       ProfileRequest& request, ProfileResponse& response) final override
   {
     uintptr_t execution_context = this->GetExecutionContext();
-    GetResources()->GetMgmtThreadPool().enqueue(
+    GetResources()->GetMgmtThreadPool().Submit(
         [this, execution_context, &request, &response] {
           auto server = GetResources()->GetServer();
           ServerStatTimerScoped timer(
@@ -221,7 +280,7 @@ class HealthContext final
       HealthRequest& request, HealthResponse& response) final override
   {
     uintptr_t execution_context = this->GetExecutionContext();
-    GetResources()->GetMgmtThreadPool().enqueue(
+    GetResources()->GetMgmtThreadPool().Submit(
         [this, execution_context, &request, &response] {
           auto server = GetResources()->GetServer();
           ServerStatTimerScoped timer(
@@ -240,9 +299,12 @@ class HealthContext final
 
 GRPCServer::GRPCServer(
     const std::string& addr, const int infer_thread_cnt,
-    const int stream_infer_thread_cnt)
+    const int stream_infer_thread_cnt, const int executor_thread_cnt,
+    const bool executor_cpu_affinity)
     : nvrpc::Server(addr), infer_thread_cnt_(infer_thread_cnt),
-      stream_infer_thread_cnt_(stream_infer_thread_cnt), running_(false)
+      stream_infer_thread_cnt_(stream_infer_thread_cnt),
+      executor_thread_cnt_(std::max(1, executor_thread_cnt)),
+      executor_cpu_affinity_(executor_cpu_affinity), running_(false)
 {
 }
 
@@ -254,15 +316,19 @@ GRPCServer::~GRPCServer()
 Status
 GRPCServer::Create(
     InferenceServer* server, int32_t port, int infer_thread_cnt,
-    int stream_infer_thread_cnt, std::unique_ptr<GRPCServer>* grpc_server)
+    int stream_infer_thread_cnt, int stream_infer_window,
+    bool stream_infer_in_order, int executor_thread_cnt,
+    bool executor_cpu_affinity, std::unique_ptr<GRPCServer>* grpc_server)
 {
   g_Resources = std::make_shared<AsyncResources>(
-      server, 1 /* infer threads */, 1 /* mgmt threads */);
+      server, 1 /* infer threads */, 1 /* mgmt threads */,
+      std::max(0, stream_infer_window), stream_infer_in_order);
 
   std::string addr = "0.0.0.0:" + std::to_string(port);
   LOG_INFO << "Starting a GRPCService at " << addr;
-  grpc_server->reset(
-      new GRPCServer(addr, infer_thread_cnt, stream_infer_thread_cnt));
+  grpc_server->reset(new GRPCServer(
+      addr, infer_thread_cnt, stream_infer_thread_cnt, executor_thread_cnt,
+      executor_cpu_affinity));
 
   (*grpc_server)->GetBuilder().SetMaxMessageSize(MAX_GRPC_MESSAGE_SIZE);
 
@@ -298,19 +364,53 @@ GRPCServer::Start()
 {
   if (!running_) {
     running_ = true;
-    LOG_INFO << "Register Executor";
-    auto executor = RegisterExecutor(new ::nvrpc::Executor(1));
+    // Each executor thread polls its own completion queue. When
+    // requested the threads are pinned to CPUs, filling one NUMA node
+    // before moving to the next.
+    std::unique_ptr<ThreadPool> executor_threads;
+    if (executor_cpu_affinity_) {
+      const std::vector<int> cpus =
+          ThreadPool::NumaOrderedCpus(executor_thread_cnt_);
+      if (!cpus.empty()) {
+        executor_threads.reset(new ThreadPool(cpus));
+      } else {
+        LOG_WARNING << "Unable to determine CPUs for GRPC executor threads, "
+                    << "threads are not pinned";
+      }
+    }
+    if (executor_threads == nullptr) {
+      executor_threads.reset(new ThreadPool(executor_thread_cnt_));
+    }
+
+    LOG_INFO << "Register Executor with " << executor_thread_cnt_
+             << " thread(s)";
+    auto executor =
+        RegisterExecutor(new ::nvrpc::Executor(std::move(executor_threads)));
 
     // You can register RPC execution contexts from any registered RPC on any
-    // executor.
-    executor->RegisterContexts(rpcInfer_, g_Resources, infer_thread_cnt_);
-    executor->RegisterContexts(
-        rpcStreamInfer_, g_Resources, stream_infer_thread_cnt_);
+    // executor. The inference contexts are divided among the executor
+    // threads so that the total does not depend on the thread count.
+    const int infer_cnt =
+        (infer_thread_cnt_ + executor_thread_cnt_ - 1) / executor_thread_cnt_;
+    const int stream_infer_cnt =
+        (stream_infer_thread_cnt_ + executor_thread_cnt_ - 1) /
+        executor_thread_cnt_;
+    executor->RegisterContexts(rpcInfer_, g_Resources, infer_cnt);
+    executor->RegisterContexts(rpcStreamInfer_, g_Resources, stream_infer_cnt);
     executor->RegisterContexts(rpcStatus_, g_Resources, 1);
     executor->RegisterContexts(rpcHealth_, g_Resources, 1);
     executor->RegisterContexts(rpcProfile_, g_Resources, 1);
 
-    AsyncRun();
+    try {
+      AsyncRun();
+    }
+    catch (const std::exception& ex) {
+      running_ = false;
+      return Status(
+          RequestStatusCode::INTERNAL,
+          std::string("Failed to start GRPC server: ") + ex.what());
+    }
+
     return Status::Success;
   }
 
@@ -39,7 +39,9 @@ class GRPCServer : private nvrpc::Server {
  public:
   static Status Create(
       InferenceServer* server, int32_t port, int infer_thread_cnt,
-      int stream_infer_thread_cnt, std::unique_ptr<GRPCServer>* grpc_servers);
+      int stream_infer_thread_cnt, int stream_infer_window,
+      bool stream_infer_in_order, int executor_thread_cnt,
+      bool executor_cpu_affinity, std::unique_ptr<GRPCServer>* grpc_servers);
   Status Start();
   Status Stop();
 
@@ -48,7 +50,8 @@ class GRPCServer : private nvrpc::Server {
  private:
   GRPCServer(
       const std::string& addr, const int infer_thread_cnt,
-      const int stream_infer_thread_cnt);
+      const int stream_infer_thread_cnt, const int executor_thread_cnt,
+      const bool executor_cpu_affinity);
 
   nvrpc::IRPC* rpcInfer_;
   nvrpc::IRPC* rpcStreamInfer_;
@@ -57,6 +60,8 @@ class GRPCServer : private nvrpc::Server {
   nvrpc::IRPC* rpcHealth_;
   int infer_thread_cnt_;
   int stream_infer_thread_cnt_;
+  int executor_thread_cnt_;
+  bool executor_cpu_affinity_;
   bool running_;
 };
 
@@ -28,6 +28,7 @@
 
 #include <google/protobuf/text_format.h>
 #include <algorithm>
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "evhtp/evhtp.h"
@@ -42,6 +43,42 @@
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Return true if the client requested that protobuf messages in the
+// infer response HTTP headers be sent in binary instead of text
+// format.
+bool
+BinaryHeadersRequested(evhtp_request_t* req)
+{
+  const char* header_format = evhtp_kv_find(req->uri->query, "header_format");
+  return (header_format != NULL) && (strcmp(header_format, "binary") == 0);
+}
+
+// Add an HTTP header holding 'msg'. In binary mode the header is
+// named 'binary_name' and holds the base64-encoded serialized
+// message, which is much cheaper to produce and parse than the text
+// format held by the 'text_name' header.
+void
+AddProtobufHeader(
+    evhtp_headers_t* headers, const char* text_name, const char* binary_name,
+    const google::protobuf::Message& msg, const bool binary)
+{
+  if (binary) {
+    std::string serialized;
+    msg.SerializeToString(&serialized);
+    const std::string encoded = absl::Base64Escape(serialized);
+    evhtp_headers_add_header(
+        headers, evhtp_header_new(binary_name, encoded.c_str(), 1, 1));
+  } else {
+    const std::string text = msg.ShortDebugString();
+    evhtp_headers_add_header(
+        headers, evhtp_header_new(text_name, text.c_str(), 1, 1));
+  }
+}
+
+}  // namespace
+
 // Handle HTTP requests
 class HTTPServerImpl : public HTTPServer {
  public:
@@ -332,24 +369,22 @@ HTTPServerImpl::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
       infer_stats, timer, model_name, model_version, request_header, req);
 
   if (!status.IsOk()) {
+    const bool binary_headers = BinaryHeadersRequested(req);
     RequestStatus request_status;
     InferResponseHeader response_header;
     response_header.set_id(request_header.id());
-    evhtp_headers_add_header(
-        req->headers_out,
-        evhtp_header_new(
-            kInferResponseHTTPHeader,
-            response_header.ShortDebugString().c_str(), 1, 1));
+    AddProtobufHeader(
+        req->headers_out, kInferResponseHTTPHeader,
+        kInferResponseBinaryHTTPHeader, response_header, binary_headers);
     LOG_VERBOSE(1) << "Infer failed: " << status.Message();
     infer_stats->SetFailed(true);
     RequestStatusFactory::Create(
         &request_status, 0 /* request_id */, server_->Id(), status);
 
     // this part still needs to be implemented in the completer
-    evhtp_headers_add_header(
-        req->headers_out, evhtp_header_new(
-                              kStatusHTTPHeader,
-                              request_status.ShortDebugString().c_str(), 1, 1));
+    AddProtobufHeader(
+        req->headers_out, kStatusHTTPHeader, kStatusBinaryHTTPHeader,
+        request_status, binary_headers);
     evhtp_headers_add_header(
         req->headers_out,
         evhtp_header_new("Content-Type", "application/octet-stream", 1, 1));
@@ -508,6 +543,7 @@ HTTPServerImpl::InferRequest::FinalizeResponse()
 {
   InferResponseHeader* response_header =
       response_provider_->MutableResponseHeader();
+  const bool binary_headers = BinaryHeadersRequested(req_);
   if (request_status_.code() == RequestStatusCode::SUCCESS) {
     std::string format;
     const char* format_c_str = evhtp_kv_find(req_->uri->query, "format");
@@ -521,14 +557,30 @@ HTTPServerImpl::InferRequest::FinalizeResponse()
     // the kInferResponseHTTPHeader since it is needed to
     // interpret the body. The entire response (including
     // classifications) is serialized at the end of the
-    // body.
+    // body, except with binary headers where the header
+    // already describes the outputs and so only the
+    // classifications are serialized at the end of the body.
     response_header->set_id(id_);
 
+    InferResponseHeader classifications;
+    if (binary_headers) {
+      for (auto& output : *response_header->mutable_output()) {
+        if (output.batch_classes_size() > 0) {
+          auto cls_output = classifications.add_output();
+          cls_output->set_name(output.name());
+          cls_output->mutable_batch_classes()->Swap(
+              output.mutable_batch_classes());
+        }
+      }
+    }
+
+    const InferResponseHeader& trailer =
+        binary_headers ? classifications : *response_header;
     std::string rstr;
     if (format == "binary") {
-      response_header->SerializeToString(&rstr);
+      trailer.SerializeToString(&rstr);
     } else {
-      rstr = response_header->DebugString();
+      rstr = trailer.DebugString();
     }
     evbuffer_add(req_->buffer_out, rstr.c_str(), rstr.size());
 
@@ -543,15 +595,13 @@ HTTPServerImpl::InferRequest::FinalizeResponse()
     response_header->Clear();
     response_header->set_id(id_);
   }
-  evhtp_headers_add_header(
-      req_->headers_out,
-      evhtp_header_new(
-          kInferResponseHTTPHeader, response_header->ShortDebugString().c_str(),
-          1, 1));
-  evhtp_headers_add_header(
-      req_->headers_out,
-      evhtp_header_new(
-          kStatusHTTPHeader, request_status_.ShortDebugString().c_str(), 1, 1));
+
+  AddProtobufHeader(
+      req_->headers_out, kInferResponseHTTPHeader,
+      kInferResponseBinaryHTTPHeader, *response_header, binary_headers);
+  AddProtobufHeader(
+      req_->headers_out, kStatusHTTPHeader, kStatusBinaryHTTPHeader,
+      request_status_, binary_headers);
   evhtp_headers_add_header(
       req_->headers_out,
       evhtp_header_new("Content-Type", "application/octet-stream", 1, 1));
@@ -101,6 +101,17 @@ int grpc_infer_thread_cnt_ = 1000;
 // The number of threads to initialize for handling GRPC stream infer requests.
 int grpc_stream_infer_thread_cnt_ = 1000;
 
+// The maximum number of requests in flight on a GRPC inference
+// stream, 0 for no limit, and whether the responses of a stream are
+// returned in the order of the requests.
+int grpc_stream_infer_window_ = 0;
+bool grpc_stream_infer_in_order_ = false;
+
+// The number of GRPC executor threads, each polling its own
+// completion queue, and whether those threads are pinned to CPUs.
+int grpc_executor_thread_cnt_ = 1;
+bool grpc_executor_cpu_affinity_ = false;
+
 // The number of threads to initialize for the HTTP front-end.
 int http_thread_cnt_ = 8;
 
@@ -127,9 +138,14 @@ enum OptionId {
   OPTION_METRICS_PORT,
   OPTION_GRPC_INFER_THREAD_COUNT,
   OPTION_GRPC_STREAM_INFER_THREAD_COUNT,
+  OPTION_GRPC_STREAM_INFER_WINDOW,
+  OPTION_GRPC_STREAM_INFER_IN_ORDER,
+  OPTION_GRPC_EXECUTOR_THREAD_COUNT,
+  OPTION_GRPC_EXECUTOR_CPU_AFFINITY,
   OPTION_HTTP_THREAD_COUNT,
   OPTION_ALLOW_POLL_REPO,
   OPTION_POLL_REPO_SECS,
+  OPTION_MODEL_LOAD_THREAD_COUNT,
   OPTION_EXIT_TIMEOUT_SECS,
   OPTION_TF_ALLOW_SOFT_PLACEMENT,
   OPTION_TF_GPU_MEMORY_FRACTION,
@@ -197,6 +213,24 @@ std::vector<Option> options_{
      "Number of threads handling GRPC inference requests."},
     {OPTION_GRPC_STREAM_INFER_THREAD_COUNT, "grpc-stream-infer-thread-count",
      "Number of threads handling GRPC stream inference requests."},
+    {OPTION_GRPC_STREAM_INFER_WINDOW, "grpc-stream-infer-window",
+     "Maximum number of requests of a GRPC inference stream that are "
+     "executing or waiting for their response to be sent. Further "
+     "requests are not read from the stream until a response is sent. "
+     "Zero indicates no limit."},
+    {OPTION_GRPC_STREAM_INFER_IN_ORDER, "grpc-stream-infer-in-order",
+     "If true the responses of a GRPC inference stream are sent in the "
+     "order of the requests. If false each response is sent as soon as "
+     "its request completes."},
+    {OPTION_GRPC_EXECUTOR_THREAD_COUNT, "grpc-executor-thread-count",
+     "Number of threads polling for GRPC events. Each thread has its own "
+     "completion queue and the GRPC inference and stream inference "
+     "handlers are divided among the threads."},
+    {OPTION_GRPC_EXECUTOR_CPU_AFFINITY, "grpc-executor-cpu-affinity",
+     "If true each GRPC executor thread is pinned to a CPU, filling "
+     "the CPUs of one NUMA node before using the next. Whether pinning "
+     "improves throughput depends on the system, so measure before "
+     "enabling it."},
     {OPTION_HTTP_THREAD_COUNT, "http-thread-count",
      "Number of threads handling HTTP requests."},
     {OPTION_ALLOW_POLL_REPO, "allow-poll-model-repository",
@@ -207,6 +241,10 @@ std::vector<Option> options_{
      "for changes. A value of zero indicates that the repository is checked "
      "only a single time at startup. Valid only when "
      "--allow-poll-model-repository=true is specified."},
+    {OPTION_MODEL_LOAD_THREAD_COUNT, "model-load-thread-count",
+     "Number of threads used to read model configurations and to load "
+     "models concurrently. The composing models of an ensemble are always "
+     "loaded before the ensemble."},
     {OPTION_EXIT_TIMEOUT_SECS, "exit-timeout-secs",
      "Timeout (in seconds) when exiting to wait for in-flight inferences to "
      "finish. After the timeout expires the server exits even if inferences "
@@ -278,7 +316,9 @@ StartGrpcService(nvidia::inferenceserver::InferenceServer* server)
   nvidia::inferenceserver::Status status =
       nvidia::inferenceserver::GRPCServer::Create(
           server, grpc_port_, grpc_infer_thread_cnt_,
-          grpc_stream_infer_thread_cnt_, &service);
+          grpc_stream_infer_thread_cnt_, grpc_stream_infer_window_,
+          grpc_stream_infer_in_order_, grpc_executor_thread_cnt_,
+          grpc_executor_cpu_affinity_, &service);
   if (status.IsOk()) {
     status = service->Start();
   }
@@ -419,6 +459,7 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   float tf_gpu_memory_fraction = server->TensorFlowGPUMemoryFraction();
   int32_t exit_timeout_secs = server->ExitTimeoutSeconds();
   int32_t repository_poll_secs = server->RepositoryPollSeconds();
+  int32_t model_load_thread_cnt = server->ModelLoadThreadCount();
 
   bool exit_on_error = exit_on_failed_init_;
 
@@ -428,6 +469,10 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   int32_t metrics_port = metrics_port_;
   int32_t grpc_infer_thread_cnt = grpc_infer_thread_cnt_;
   int32_t grpc_stream_infer_thread_cnt = grpc_stream_infer_thread_cnt_;
+  int32_t grpc_stream_infer_window = grpc_stream_infer_window_;
+  bool grpc_stream_infer_in_order = grpc_stream_infer_in_order_;
+  int32_t grpc_executor_thread_cnt = grpc_executor_thread_cnt_;
+  bool grpc_executor_cpu_affinity = grpc_executor_cpu_affinity_;
   int32_t http_thread_cnt = http_thread_cnt_;
 
   int32_t http_health_port = http_port_;
@@ -519,6 +564,18 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
       case OPTION_GRPC_STREAM_INFER_THREAD_COUNT:
         grpc_stream_infer_thread_cnt = ParseIntOption(optarg);
         break;
+      case OPTION_GRPC_STREAM_INFER_WINDOW:
+        grpc_stream_infer_window = ParseIntOption(optarg);
+        break;
+      case OPTION_GRPC_STREAM_INFER_IN_ORDER:
+        grpc_stream_infer_in_order = ParseBoolOption(optarg);
+        break;
+      case OPTION_GRPC_EXECUTOR_THREAD_COUNT:
+        grpc_executor_thread_cnt = ParseIntOption(optarg);
+        break;
+      case OPTION_GRPC_EXECUTOR_CPU_AFFINITY:
+        grpc_executor_cpu_affinity = ParseBoolOption(optarg);
+        break;
       case OPTION_HTTP_THREAD_COUNT:
         http_thread_cnt = ParseIntOption(optarg);
         break;
@@ -528,6 +585,9 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
       case OPTION_POLL_REPO_SECS:
         repository_poll_secs = ParseIntOption(optarg);
         break;
+      case OPTION_MODEL_LOAD_THREAD_COUNT:
+        model_load_thread_cnt = ParseIntOption(optarg);
+        break;
       case OPTION_EXIT_TIMEOUT_SECS:
         exit_timeout_secs = ParseIntOption(optarg);
         break;
@@ -576,6 +636,10 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   allow_gpu_metrics_ = allow_metrics_ ? allow_gpu_metrics : false;
   grpc_infer_thread_cnt_ = grpc_infer_thread_cnt;
   grpc_stream_infer_thread_cnt_ = grpc_stream_infer_thread_cnt;
+  grpc_stream_infer_window_ = std::max(0, grpc_stream_infer_window);
+  grpc_stream_infer_in_order_ = grpc_stream_infer_in_order;
+  grpc_executor_thread_cnt_ = std::max(1, grpc_executor_thread_cnt);
+  grpc_executor_cpu_affinity_ = grpc_executor_cpu_affinity;
   http_thread_cnt_ = http_thread_cnt;
 
   server->SetId(server_id);
@@ -587,6 +651,7 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
 
   server->SetRepositoryPollSeconds(
       (allow_poll_model_repository) ? std::max(0, repository_poll_secs) : 0);
+  server->SetModelLoadThreadCount(std::max(1, model_load_thread_cnt));
 
   server->SetTensorFlowSoftPlacementEnabled(tf_allow_soft_placement);
   server->SetTensorFlowGPUMemoryFraction(tf_gpu_memory_fraction);
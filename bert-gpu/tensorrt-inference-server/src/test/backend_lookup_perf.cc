@@ -0,0 +1,236 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmark measuring the throughput of resolving the backend
+// handle of a request as the number of resolving threads grows, with
+// hundreds of model versions loaded. For comparison it also measures
+// a mutex protecting a map of all model versions that is scanned to
+// find the latest ready version, which is how handles were resolved
+// previously. Half of the lookups ask for the latest version and half
+// for a specific version.
+//
+// Usage: backend_lookup_perf [model-count] [versions-per-model]
+//                            [lookups-per-run]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/core/model_repository_manager.h"
+#include "src/core/ready_backends.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::PrintSpeedup;
+using nvidia::inferenceserver::test::RunThreads;
+
+using BackendHandle = ni::ModelRepositoryManager::BackendHandle;
+
+class NullBackendHandle : public BackendHandle {
+ public:
+  ni::InferenceBackend* GetInferenceBackend() override { return nullptr; }
+};
+
+std::string
+ModelName(const size_t idx)
+{
+  return "model_" + std::to_string(idx);
+}
+
+// Previous implementation: every lookup takes the map mutex and the
+// mutex of each version examined, scanning all versions of the model
+// when the latest version is requested.
+class LockedLookup {
+ public:
+  LockedLookup(const size_t model_cnt, const size_t version_cnt)
+  {
+    for (size_t m = 0; m < model_cnt; ++m) {
+      for (size_t v = 1; v <= version_cnt; ++v) {
+        std::unique_ptr<Info> info(new Info);
+        info->ready_ = true;
+        info->handle_.reset(new NullBackendHandle());
+        map_[ModelName(m)][v] = std::move(info);
+      }
+    }
+  }
+
+  bool Get(
+      const std::string& model_name, const int64_t version,
+      std::shared_ptr<BackendHandle>* handle)
+  {
+    std::lock_guard<std::mutex> map_lock(map_mtx_);
+    auto mit = map_.find(model_name);
+    if (mit == map_.end()) {
+      return false;
+    }
+
+    auto vit = mit->second.find(version);
+    if (vit == mit->second.end()) {
+      int64_t latest = -1;
+      if (version == -1) {
+        for (auto& version_info : mit->second) {
+          if (version_info.first > latest) {
+            std::lock_guard<std::mutex> lock(version_info.second->mtx_);
+            if (version_info.second->ready_) {
+              latest = version_info.first;
+              *handle = version_info.second->handle_;
+            }
+          }
+        }
+      }
+      return (latest != -1);
+    }
+
+    std::lock_guard<std::mutex> lock(vit->second->mtx_);
+    if (!vit->second->ready_) {
+      return false;
+    }
+    *handle = vit->second->handle_;
+    return true;
+  }
+
+ private:
+  struct Info {
+    std::mutex mtx_;
+    bool ready_;
+    std::shared_ptr<BackendHandle> handle_;
+  };
+
+  std::map<std::string, std::map<int64_t, std::unique_ptr<Info>>> map_;
+  std::mutex map_mtx_;
+};
+
+// Current implementation.
+class SnapshotLookup {
+ public:
+  SnapshotLookup(const size_t model_cnt, const size_t version_cnt)
+  {
+    for (size_t m = 0; m < model_cnt; ++m) {
+      for (size_t v = 1; v <= version_cnt; ++v) {
+        handles_.emplace_back(new NullBackendHandle());
+        ready_.SetReady(ModelName(m), v, handles_.back());
+      }
+    }
+  }
+
+  bool Get(
+      const std::string& model_name, const int64_t version,
+      std::shared_ptr<BackendHandle>* handle)
+  {
+    return ready_.Get(model_name, version, handle);
+  }
+
+ private:
+  std::vector<std::shared_ptr<BackendHandle>> handles_;
+  ni::ReadyBackends ready_;
+};
+
+// Return the number of lookups per second performed by 'thread_cnt'
+// threads.
+template <typename L>
+double
+Run(
+    const size_t thread_cnt, const size_t model_cnt, const size_t version_cnt,
+    const size_t lookup_cnt)
+{
+  L lookup(model_cnt, version_cnt);
+  std::vector<std::string> model_names;
+  for (size_t m = 0; m < model_cnt; ++m) {
+    model_names.push_back(ModelName(m));
+  }
+
+  std::atomic<size_t> failed(0);
+  const size_t per_thread = lookup_cnt / thread_cnt;
+
+  const uint64_t run_ns = RunThreads(thread_cnt, [&](size_t t) {
+    std::shared_ptr<BackendHandle> handle;
+    for (size_t i = 0; i < per_thread; ++i) {
+      const size_t n = t * 7919 + i;
+      const int64_t version = ((n % 2) == 0) ? -1 : (1 + (n % version_cnt));
+      if (!lookup.Get(model_names[n % model_cnt], version, &handle)) {
+        failed++;
+      }
+    }
+  });
+
+  if (failed != 0) {
+    std::cerr << "error: " << failed << " lookups failed" << std::endl;
+    exit(1);
+  }
+
+  return (double)(per_thread * thread_cnt) * 1e9 / (double)run_ns;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t model_cnt = 100;
+  size_t version_cnt = 5;
+  size_t lookup_cnt = 1 << 21;
+  if (argc > 1) {
+    model_cnt = strtoull(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    version_cnt = strtoull(argv[2], nullptr, 10);
+  }
+  if (argc > 3) {
+    lookup_cnt = strtoull(argv[3], nullptr, 10);
+  }
+
+  std::cout << "Models: " << model_cnt << ", versions per model: "
+            << version_cnt << ", lookups per run: " << lookup_cnt
+            << ", hardware threads: " << std::thread::hardware_concurrency()
+            << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(18) << "locked/s"
+            << std::setw(18) << "snapshot/s" << std::setw(10) << "speedup"
+            << std::endl;
+
+  for (size_t thread_cnt = 1; thread_cnt <= 64; thread_cnt *= 2) {
+    const double locked_rate =
+        Run<LockedLookup>(thread_cnt, model_cnt, version_cnt, lookup_cnt);
+    const double snapshot_rate =
+        Run<SnapshotLookup>(thread_cnt, model_cnt, version_cnt, lookup_cnt);
+    std::cout << std::setw(10) << thread_cnt << std::setw(18)
+              << (uint64_t)locked_rate << std::setw(18)
+              << (uint64_t)snapshot_rate;
+    PrintSpeedup(std::cout, snapshot_rate / locked_rate);
+  }
+
+  return 0;
+}
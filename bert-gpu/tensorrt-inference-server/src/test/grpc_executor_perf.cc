@@ -0,0 +1,241 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark measuring how GRPC inference throughput and latency scale
+// with the number of concurrent clients. For each concurrency from 1
+// up to 'max-concurrency', doubling each time, that many threads each
+// send 'requests-per-thread' unary requests one at a time, and the
+// throughput and the 50th/90th/99th percentile request latencies are
+// reported. The model must have fixed-size inputs, which are sent as
+// zeros with a batch size of 1. Use a model with little compute (for
+// example an identity model) so that the GRPC front-end dominates, and
+// run the server with different values of --grpc-executor-thread-count
+// and --grpc-executor-cpu-affinity to see how the front-end scales
+// with cores. It has only been run on machines with few cores, so the
+// benefit of more executor threads and of pinning them on many-core
+// and multi-socket machines is not yet known.
+//
+// Usage: grpc_executor_perf <model-name> [url] [max-concurrency]
+//                           [requests-per-thread]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/clients/c++/request_grpc.h"
+#include "src/test/perf_util.h"
+
+namespace nic = nvidia::inferenceserver::client;
+
+namespace {
+
+using nvidia::inferenceserver::test::NowNs;
+
+// Set zero-filled inputs and request all outputs for a batch of 1.
+// The input data must remain valid while 'ctx' is in use.
+nic::Error
+Prepare(nic::InferContext* ctx, std::vector<uint8_t>* data)
+{
+  std::unique_ptr<nic::InferContext::Options> options;
+  nic::Error err = nic::InferContext::Options::Create(&options);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  options->SetBatchSize(1);
+  for (const auto& output : ctx->Outputs()) {
+    options->AddRawResult(output);
+  }
+
+  err = ctx->SetRunOptions(*options);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  for (const auto& input : ctx->Inputs()) {
+    if (input->ByteSize() < 0) {
+      return nic::Error(
+          nvidia::inferenceserver::RequestStatusCode::UNSUPPORTED,
+          "input '" + input->Name() + "' does not have a fixed size");
+    }
+    if (data->size() < (size_t)input->ByteSize()) {
+      data->resize(input->ByteSize(), 0);
+    }
+  }
+
+  for (const auto& input : ctx->Inputs()) {
+    err = input->Reset();
+    if (!err.IsOk()) {
+      return err;
+    }
+    err = input->SetRaw(&(*data)[0], input->ByteSize());
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return nic::Error::Success;
+}
+
+// Send 'request_cnt' requests from each of 'concurrency' threads, one
+// at a time on the thread's own context. Return the nanoseconds taken
+// by the whole run and the latency of every request.
+nic::Error
+Run(const std::string& url, const std::string& model_name,
+    const size_t concurrency, const size_t request_cnt, uint64_t* run_ns,
+    std::vector<uint64_t>* latencies_ns)
+{
+  std::vector<std::unique_ptr<nic::InferContext>> ctxs(concurrency);
+  std::vector<uint8_t> data;
+  for (auto& ctx : ctxs) {
+    nic::Error err = nic::InferGrpcContext::Create(&ctx, url, model_name);
+    if (!err.IsOk()) {
+      return err;
+    }
+    err = Prepare(ctx.get(), &data);
+    if (!err.IsOk()) {
+      return err;
+    }
+
+    // Warm up the connection of each context outside of the timed run.
+    nic::InferContext::ResultMap results;
+    err = ctx->Run(&results);
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  std::vector<nic::Error> errs(concurrency);
+  std::vector<std::vector<uint64_t>> thread_latencies(concurrency);
+  std::vector<std::thread> threads;
+  const uint64_t start_ns = NowNs();
+  for (size_t t = 0; t < concurrency; ++t) {
+    threads.emplace_back([&, t]() {
+      thread_latencies[t].reserve(request_cnt);
+      for (size_t i = 0; i < request_cnt; ++i) {
+        nic::InferContext::ResultMap results;
+        const uint64_t request_start_ns = NowNs();
+        errs[t] = ctxs[t]->Run(&results);
+        if (!errs[t].IsOk()) {
+          break;
+        }
+        thread_latencies[t].push_back(NowNs() - request_start_ns);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  *run_ns = NowNs() - start_ns;
+
+  for (const auto& err : errs) {
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  latencies_ns->clear();
+  for (const auto& tl : thread_latencies) {
+    latencies_ns->insert(latencies_ns->end(), tl.begin(), tl.end());
+  }
+  std::sort(latencies_ns->begin(), latencies_ns->end());
+
+  return nic::Error::Success;
+}
+
+// Return the 'percentile' latency, in microseconds, of the sorted
+// 'latencies_ns'.
+double
+PercentileUs(const std::vector<uint64_t>& latencies_ns, const size_t percentile)
+{
+  if (latencies_ns.empty()) {
+    return 0;
+  }
+  const size_t idx = std::min(
+      latencies_ns.size() - 1, (latencies_ns.size() * percentile) / 100);
+  return latencies_ns[idx] / 1e3;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <model-name> [url] [max-concurrency] [requests-per-thread]"
+              << std::endl;
+    return 1;
+  }
+
+  const std::string model_name(argv[1]);
+  std::string url("localhost:8001");
+  size_t max_concurrency = 64;
+  size_t request_cnt = 2000;
+  if (argc > 2) {
+    url = argv[2];
+  }
+  if (argc > 3) {
+    max_concurrency = std::max(1ULL, strtoull(argv[3], nullptr, 10));
+  }
+  if (argc > 4) {
+    request_cnt = std::max(1ULL, strtoull(argv[4], nullptr, 10));
+  }
+
+  std::cout << "Model: " << model_name << ", requests per thread: "
+            << request_cnt << std::endl;
+  std::cout << std::setw(12) << "concurrency" << std::setw(14) << "infer/sec"
+            << std::setw(12) << "p50 usec" << std::setw(12) << "p90 usec"
+            << std::setw(12) << "p99 usec" << std::endl;
+
+  for (size_t concurrency = 1; concurrency <= max_concurrency;
+       concurrency *= 2) {
+    uint64_t run_ns = 0;
+    std::vector<uint64_t> latencies_ns;
+    nic::Error err = Run(
+        url, model_name, concurrency, request_cnt, &run_ns, &latencies_ns);
+    if (!err.IsOk()) {
+      std::cerr << "concurrency " << concurrency << ": " << err << std::endl;
+      return 1;
+    }
+
+    std::cout << std::setw(12) << concurrency << std::setw(14) << std::fixed
+              << std::setprecision(1)
+              << (latencies_ns.size() * 1e9 / run_ns) << std::setw(12)
+              << PercentileUs(latencies_ns, 50) << std::setw(12)
+              << PercentileUs(latencies_ns, 90) << std::setw(12)
+              << PercentileUs(latencies_ns, 99) << std::endl;
+  }
+
+  return 0;
+}
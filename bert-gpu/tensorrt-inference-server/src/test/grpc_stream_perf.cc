@@ -0,0 +1,261 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark comparing the inference throughput of a single GRPC
+// stream against concurrent unary GRPC calls. The unary case uses
+// 'concurrency' threads, each sending one request at a time on its
+// own context. The stream case sends all requests on one stream from
+// one thread, keeping 'concurrency' requests in flight. The model
+// must have fixed-size inputs, which are sent as zeros with a batch
+// size of 1. Run the server with different values of
+// --grpc-stream-infer-window and --grpc-stream-infer-in-order to
+// compare their effect on the stream.
+//
+// Usage: grpc_stream_perf <model-name> [url] [request-count]
+//                         [concurrency]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/clients/c++/request_grpc.h"
+#include "src/test/perf_util.h"
+
+namespace nic = nvidia::inferenceserver::client;
+
+namespace {
+
+using nvidia::inferenceserver::test::NowNs;
+
+// Set zero-filled inputs and request all outputs for a batch of 1.
+// The input data must remain valid while 'ctx' is in use.
+nic::Error
+Prepare(nic::InferContext* ctx, std::vector<uint8_t>* data)
+{
+  std::unique_ptr<nic::InferContext::Options> options;
+  nic::Error err = nic::InferContext::Options::Create(&options);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  options->SetBatchSize(1);
+  for (const auto& output : ctx->Outputs()) {
+    options->AddRawResult(output);
+  }
+
+  err = ctx->SetRunOptions(*options);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  for (const auto& input : ctx->Inputs()) {
+    if (input->ByteSize() < 0) {
+      return nic::Error(
+          nvidia::inferenceserver::RequestStatusCode::UNSUPPORTED,
+          "input '" + input->Name() + "' does not have a fixed size");
+    }
+    if (data->size() < (size_t)input->ByteSize()) {
+      data->resize(input->ByteSize(), 0);
+    }
+  }
+
+  for (const auto& input : ctx->Inputs()) {
+    err = input->Reset();
+    if (!err.IsOk()) {
+      return err;
+    }
+    err = input->SetRaw(&(*data)[0], input->ByteSize());
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return nic::Error::Success;
+}
+
+// Send 'request_cnt' requests with 'concurrency' threads each making
+// one unary call at a time. Return the nanoseconds taken.
+nic::Error
+RunUnary(
+    const std::string& url, const std::string& model_name,
+    const size_t request_cnt, const size_t concurrency, uint64_t* run_ns)
+{
+  std::vector<std::unique_ptr<nic::InferContext>> ctxs(concurrency);
+  std::vector<uint8_t> data;
+  for (auto& ctx : ctxs) {
+    nic::Error err = nic::InferGrpcContext::Create(&ctx, url, model_name);
+    if (!err.IsOk()) {
+      return err;
+    }
+    err = Prepare(ctx.get(), &data);
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  std::vector<nic::Error> errs(concurrency);
+  std::vector<std::thread> threads;
+  const uint64_t start_ns = NowNs();
+  for (size_t t = 0; t < concurrency; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < request_cnt; i += concurrency) {
+        nic::InferContext::ResultMap results;
+        errs[t] = ctxs[t]->Run(&results);
+        if (!errs[t].IsOk()) {
+          break;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  *run_ns = NowNs() - start_ns;
+
+  for (const auto& err : errs) {
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return nic::Error::Success;
+}
+
+// Send 'request_cnt' requests on a single stream, keeping
+// 'concurrency' requests in flight. Return the nanoseconds taken.
+nic::Error
+RunStream(
+    const std::string& url, const std::string& model_name,
+    const size_t request_cnt, const size_t concurrency, uint64_t* run_ns)
+{
+  std::unique_ptr<nic::InferContext> ctx;
+  std::vector<uint8_t> data;
+  nic::Error err = nic::InferGrpcStreamContext::Create(&ctx, url, model_name);
+  if (!err.IsOk()) {
+    return err;
+  }
+  err = Prepare(ctx.get(), &data);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  size_t sent_cnt = 0;
+  size_t received_cnt = 0;
+  const uint64_t start_ns = NowNs();
+  while (received_cnt < request_cnt) {
+    if ((sent_cnt < request_cnt) && ((sent_cnt - received_cnt) < concurrency)) {
+      std::shared_ptr<nic::InferContext::Request> request;
+      err = ctx->AsyncRun(&request);
+      if (!err.IsOk()) {
+        return err;
+      }
+      sent_cnt++;
+      continue;
+    }
+
+    std::shared_ptr<nic::InferContext::Request> request;
+    bool is_ready = false;
+    err = ctx->GetReadyAsyncRequest(&request, &is_ready, true /* wait */);
+    if (!err.IsOk()) {
+      return err;
+    }
+
+    nic::InferContext::ResultMap results;
+    err = ctx->GetAsyncRunResults(&results, &is_ready, request, true);
+    if (!err.IsOk()) {
+      return err;
+    }
+    received_cnt++;
+  }
+  *run_ns = NowNs() - start_ns;
+
+  return nic::Error::Success;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <model-name> [url] [request-count] [concurrency]"
+              << std::endl;
+    return 1;
+  }
+
+  const std::string model_name(argv[1]);
+  std::string url("localhost:8001");
+  size_t request_cnt = 10000;
+  size_t concurrency = 16;
+  if (argc > 2) {
+    url = argv[2];
+  }
+  if (argc > 3) {
+    request_cnt = strtoull(argv[3], nullptr, 10);
+  }
+  if (argc > 4) {
+    concurrency = std::max(1ULL, strtoull(argv[4], nullptr, 10));
+  }
+
+  uint64_t unary_ns = 0;
+  nic::Error err =
+      RunUnary(url, model_name, request_cnt, concurrency, &unary_ns);
+  if (!err.IsOk()) {
+    std::cerr << "unary: " << err << std::endl;
+    return 1;
+  }
+
+  uint64_t stream_ns = 0;
+  err = RunStream(url, model_name, request_cnt, concurrency, &stream_ns);
+  if (!err.IsOk()) {
+    std::cerr << "stream: " << err << std::endl;
+    return 1;
+  }
+
+  std::cout << "Model: " << model_name << ", requests: " << request_cnt
+            << ", concurrency: " << concurrency << std::endl;
+  std::cout << std::setw(10) << "" << std::setw(14) << "infer/sec"
+            << std::setw(14) << "usec/infer" << std::endl;
+  std::cout << std::setw(10) << "unary" << std::setw(14) << std::fixed
+            << std::setprecision(1) << (request_cnt * 1e9 / unary_ns)
+            << std::setw(14) << (unary_ns / 1e3 / request_cnt) << std::endl;
+  std::cout << std::setw(10) << "stream" << std::setw(14) << std::fixed
+            << std::setprecision(1) << (request_cnt * 1e9 / stream_ns)
+            << std::setw(14) << (stream_ns / 1e3 / request_cnt) << std::endl;
+  std::cout << std::setw(10) << "speedup" << std::setw(13)
+            << std::setprecision(2) << ((double)unary_ns / (double)stream_ns)
+            << "x" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmark comparing the cost of producing and parsing the
+// protobuf messages carried in the HTTP infer response headers. The
+// text format (ShortDebugString / TextFormat) is compared against the
+// base64-encoded binary format requested with
+// 'header_format=binary'. The response header is a classification
+// result for a large batch, which is where the text format is most
+// expensive.
+//
+// Usage: http_header_perf [batch-size] [classes-per-batch-entry]
+
+#include <google/protobuf/text_format.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "absl/strings/escaping.h"
+#include "src/core/api.pb.h"
+#include "src/core/request_status.pb.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::AverageNs;
+
+void
+InitMessages(
+    const size_t batch_size, const size_t class_cnt,
+    ni::InferResponseHeader* response_header,
+    ni::RequestStatus* request_status)
+{
+  response_header->set_id(12345);
+  response_header->set_model_name("resnet50_classification");
+  response_header->set_model_version(1);
+  response_header->set_batch_size(batch_size);
+
+  auto output = response_header->add_output();
+  output->set_name("probabilities");
+  for (size_t b = 0; b < batch_size; ++b) {
+    auto classes = output->add_batch_classes();
+    for (size_t c = 0; c < class_cnt; ++c) {
+      auto cls = classes->add_cls();
+      cls->set_idx((b * 7 + c * 131) % 1000);
+      cls->set_value(1.0f / (c + 2));
+      cls->set_label("imagenet_label_" + std::to_string(cls->idx()));
+    }
+  }
+
+  auto raw_output = response_header->add_output();
+  raw_output->set_name("features");
+  raw_output->mutable_raw()->add_dims(2048);
+  raw_output->mutable_raw()->set_batch_byte_size(batch_size * 2048 * 4);
+
+  request_status->set_code(ni::RequestStatusCode::SUCCESS);
+  request_status->set_server_id("inference:0");
+  request_status->set_request_id(67890);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t batch_size = 64;
+  size_t class_cnt = 5;
+  if (argc > 1) {
+    batch_size = strtoull(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    class_cnt = strtoull(argv[2], nullptr, 10);
+  }
+
+  ni::InferResponseHeader response_header;
+  ni::RequestStatus request_status;
+  InitMessages(batch_size, class_cnt, &response_header, &request_status);
+
+  const size_t iterations = 2000;
+  size_t sink = 0;
+
+  // Server side: produce the header values.
+  const double text_encode_ns = AverageNs(iterations, [&]() {
+    sink += response_header.ShortDebugString().size();
+    sink += request_status.ShortDebugString().size();
+  });
+  const double binary_encode_ns = AverageNs(iterations, [&]() {
+    std::string serialized;
+    response_header.SerializeToString(&serialized);
+    sink += absl::Base64Escape(serialized).size();
+    request_status.SerializeToString(&serialized);
+    sink += absl::Base64Escape(serialized).size();
+  });
+
+  // Client side: parse the header values.
+  const std::string text_response = response_header.ShortDebugString();
+  const std::string text_status = request_status.ShortDebugString();
+  std::string serialized;
+  response_header.SerializeToString(&serialized);
+  const std::string binary_response = absl::Base64Escape(serialized);
+  request_status.SerializeToString(&serialized);
+  const std::string binary_status = absl::Base64Escape(serialized);
+
+  const double text_decode_ns = AverageNs(iterations, [&]() {
+    ni::InferResponseHeader rh;
+    ni::RequestStatus rs;
+    google::protobuf::TextFormat::ParseFromString(text_response, &rh);
+    google::protobuf::TextFormat::ParseFromString(text_status, &rs);
+    sink += rh.output_size();
+  });
+  const double binary_decode_ns = AverageNs(iterations, [&]() {
+    ni::InferResponseHeader rh;
+    ni::RequestStatus rs;
+    std::string decoded;
+    absl::Base64Unescape(binary_response, &decoded);
+    rh.ParseFromString(decoded);
+    absl::Base64Unescape(binary_status, &decoded);
+    rs.ParseFromString(decoded);
+    sink += rh.output_size();
+  });
+
+  std::cout << "Batch size: " << batch_size << ", classes: " << class_cnt
+            << std::endl;
+  std::cout << std::setw(10) << "" << std::setw(14) << "text" << std::setw(14)
+            << "binary" << std::setw(10) << "speedup" << std::endl;
+  std::cout << std::setw(10) << "bytes" << std::setw(14)
+            << (text_response.size() + text_status.size()) << std::setw(14)
+            << (binary_response.size() + binary_status.size()) << std::endl;
+  std::cout << std::setw(10) << "encode ns" << std::setw(14)
+            << (uint64_t)text_encode_ns << std::setw(14)
+            << (uint64_t)binary_encode_ns << std::setw(9) << std::fixed
+            << std::setprecision(2) << (text_encode_ns / binary_encode_ns)
+            << "x" << std::endl;
+  std::cout << std::setw(10) << "decode ns" << std::setw(14)
+            << (uint64_t)text_decode_ns << std::setw(14)
+            << (uint64_t)binary_decode_ns << std::setw(9) << std::fixed
+            << std::setprecision(2) << (text_decode_ns / binary_decode_ns)
+            << "x" << std::endl;
+
+  return (sink == 0) ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmark comparing the throughput of the lock-free request
+// queue used by DynamicBatchScheduler against a std::deque protected
+// by a mutex and condition variable, which is how the scheduler
+// queued requests previously. Multiple producer threads enqueue
+// while a single consumer drains, mimicking frontend threads feeding
+// one model's scheduler.
+//
+// Usage: lockfree_queue_perf [items-per-run]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "src/core/lockfree_queue.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::NowNs;
+using nvidia::inferenceserver::test::PrintSpeedup;
+
+// Stand-in for Scheduler::Payload, which is a handful of smart
+// pointers and a std::function.
+struct Item {
+  Item() = default;
+  Item(const Item&) = delete;
+  Item(Item&&) = default;
+  Item& operator=(Item&&) = default;
+
+  std::shared_ptr<uint64_t> stats_;
+  std::function<void(int)> complete_function_;
+};
+
+// Previous scheduler queue: every enqueue and dequeue takes 'mu_'.
+class MutexQueue {
+ public:
+  void Enqueue(Item&& item)
+  {
+    bool wake = false;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      queue_.emplace_back(std::move(item));
+      wake = idle_;
+    }
+    if (wake) {
+      cv_.notify_one();
+    }
+  }
+
+  size_t DequeueAll(std::deque<Item>* items)
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    if (queue_.empty()) {
+      idle_ = true;
+      cv_.wait_for(lock, std::chrono::milliseconds(1));
+      idle_ = false;
+    }
+
+    size_t cnt = queue_.size();
+    while (!queue_.empty()) {
+      items->emplace_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    return cnt;
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Item> queue_;
+  bool idle_ = false;
+};
+
+// Current scheduler queue: enqueue is lock-free unless it is the
+// first to find the consumer idle or the lock-free queue overflows.
+class LockFreeSchedulerQueue {
+ public:
+  LockFreeSchedulerQueue() : incoming_(1024), idle_(0), wake_pending_(false) {}
+
+  void Enqueue(Item&& item)
+  {
+    if (!incoming_.TryEnqueue(std::move(item))) {
+      std::lock_guard<std::mutex> lock(mu_);
+      Drain();
+      queue_.emplace_back(std::move(item));
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((idle_.load() > 0) && !wake_pending_.exchange(true)) {
+      { std::lock_guard<std::mutex> lock(mu_); }
+      cv_.notify_one();
+    }
+  }
+
+  size_t DequeueAll(std::deque<Item>* items)
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    Drain();
+    if (queue_.empty()) {
+      wake_pending_.store(false);
+      idle_++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (incoming_.Empty()) {
+        cv_.wait_for(lock, std::chrono::milliseconds(1));
+      }
+      idle_--;
+      wake_pending_.store(false);
+      Drain();
+    }
+
+    size_t cnt = queue_.size();
+    while (!queue_.empty()) {
+      items->emplace_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    return cnt;
+  }
+
+ private:
+  void Drain()
+  {
+    Item item;
+    while (incoming_.TryDequeue(&item)) {
+      queue_.emplace_back(std::move(item));
+    }
+  }
+
+  ni::LockFreeQueue<Item> incoming_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Item> queue_;
+  std::atomic<uint32_t> idle_;
+  std::atomic<bool> wake_pending_;
+};
+
+// Return the number of items per second moved through 'queue' by
+// 'producer_cnt' producers and a single consumer.
+template <typename Q>
+double
+Run(const size_t producer_cnt, const size_t item_cnt)
+{
+  Q queue;
+  std::atomic<bool> start(false);
+  const size_t per_producer = item_cnt / producer_cnt;
+  const size_t total = per_producer * producer_cnt;
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_cnt; ++p) {
+    producers.emplace_back([&queue, &start, per_producer]() {
+      auto stats = std::make_shared<uint64_t>(0);
+      while (!start.load()) {
+      }
+      for (size_t i = 0; i < per_producer; ++i) {
+        Item item;
+        item.stats_ = stats;
+        item.complete_function_ = [](int) {};
+        queue.Enqueue(std::move(item));
+      }
+    });
+  }
+
+  const uint64_t start_ns = NowNs();
+  start.store(true);
+
+  size_t consumed = 0;
+  std::deque<Item> items;
+  while (consumed < total) {
+    consumed += queue.DequeueAll(&items);
+    items.clear();
+  }
+
+  const uint64_t end_ns = NowNs();
+  for (auto& thd : producers) {
+    thd.join();
+  }
+
+  return (double)total * 1e9 / (double)(end_ns - start_ns);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t item_cnt = 1 << 20;
+  if (argc > 1) {
+    item_cnt = strtoull(argv[1], nullptr, 10);
+  }
+
+  std::cout << "Items per run: " << item_cnt << std::endl;
+  std::cout << std::setw(10) << "producers" << std::setw(18)
+            << "deque+condvar/s" << std::setw(18) << "lock-free/s"
+            << std::setw(10) << "speedup" << std::endl;
+
+  for (size_t producer_cnt = 1; producer_cnt <= 64; producer_cnt *= 2) {
+    const double mutex_rate = Run<MutexQueue>(producer_cnt, item_cnt);
+    const double lockfree_rate = Run<LockFreeSchedulerQueue>(
+        producer_cnt, item_cnt);
+    std::cout << std::setw(10) << producer_cnt << std::setw(18)
+              << (uint64_t)mutex_rate << std::setw(18)
+              << (uint64_t)lockfree_rate;
+    PrintSpeedup(std::cout, lockfree_rate / mutex_rate);
+  }
+
+  return 0;
+}
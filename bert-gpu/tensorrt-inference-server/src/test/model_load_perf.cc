@@ -0,0 +1,263 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark measuring server startup time for a repository of many
+// models as the number of model load threads grows. A synthetic
+// repository is created in a temporary directory holding
+// 'model-count' copies of the template model. Each copy has its own
+// configuration, named after the copy, and symlinks to the version
+// directories of the template so that the model files are not
+// duplicated. For each thread count the repository is loaded from
+// scratch and the time until every model version has finished
+// loading is reported.
+//
+// Usage: model_load_perf <template-model-dir> [model-count]
+//                        [max-load-threads]
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/core/constants.h"
+#include "src/core/filesystem.h"
+#include "src/core/logging.h"
+#include "src/core/model_config.pb.h"
+#include "src/core/model_repository_manager.h"
+#include "src/core/server_status.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::NowNs;
+using nvidia::inferenceserver::test::PrintSpeedup;
+
+// RETURN_IF_ERROR refers to these unqualified.
+using ni::RequestStatusCode;
+using ni::Status;
+
+// Create 'model_cnt' copies of the model in 'template_path' within
+// 'repository_path' and return the names of the copies in 'names'.
+Status
+CreateRepository(
+    const std::string& template_path, const std::string& repository_path,
+    const size_t model_cnt, std::vector<std::string>* names)
+{
+  bool has_config;
+  RETURN_IF_ERROR(ni::FileExists(
+      ni::JoinPath({template_path, ni::kModelConfigPbTxt}), &has_config));
+  ni::ModelConfig config;
+  if (has_config) {
+    RETURN_IF_ERROR(ni::ReadTextProto(
+        ni::JoinPath({template_path, ni::kModelConfigPbTxt}), &config));
+  }
+
+  std::set<std::string> contents;
+  RETURN_IF_ERROR(ni::GetDirectoryContents(template_path, &contents));
+
+  const std::string base_name = ni::BaseName(template_path);
+  for (size_t i = 0; i < model_cnt; ++i) {
+    const std::string name = base_name + "_" + std::to_string(i);
+    const std::string model_path = ni::JoinPath({repository_path, name});
+    if (mkdir(model_path.c_str(), S_IRWXU) != 0) {
+      return Status(
+          RequestStatusCode::INTERNAL,
+          "failed to create model directory " + model_path);
+    }
+
+    // Without a configuration the name is taken from the directory
+    // when the configuration is autofilled.
+    if (has_config) {
+      config.set_name(name);
+      RETURN_IF_ERROR(ni::WriteTextProto(
+          ni::JoinPath({model_path, ni::kModelConfigPbTxt}), config));
+    }
+
+    for (const auto& entry : contents) {
+      if (entry == ni::kModelConfigPbTxt) {
+        continue;
+      }
+
+      const std::string target = ni::JoinPath({template_path, entry});
+      const std::string link = ni::JoinPath({model_path, entry});
+      if (symlink(target.c_str(), link.c_str()) != 0) {
+        return Status(
+            RequestStatusCode::INTERNAL,
+            "failed to create symlink " + link + " to " + target);
+      }
+    }
+
+    names->push_back(name);
+  }
+
+  return Status::Success;
+}
+
+// Load the repository using 'thread_cnt' model load threads and
+// return the nanoseconds taken until every model version is no longer
+// loading in 'load_ns' and the number of ready versions in
+// 'ready_cnt'. All models are unloaded before returning.
+Status
+LoadRepository(
+    const std::string& repository_path, const std::vector<std::string>& names,
+    const uint32_t thread_cnt, uint64_t* load_ns, size_t* ready_cnt)
+{
+  auto status_manager =
+      std::make_shared<ni::ServerStatusManager>("model_load_perf");
+  std::unique_ptr<ni::ModelRepositoryManager> manager;
+
+  const uint64_t start_ns = NowNs();
+  RETURN_IF_ERROR(ni::ModelRepositoryManager::Create(
+      "model_load_perf", status_manager, repository_path,
+      false /* strict_model_config */, 0.0 /* tf_gpu_memory_fraction */,
+      true /* tf_allow_soft_placement */, 0 /* repository_poll_secs */,
+      true /* polling_enabled */, thread_cnt, &manager));
+
+  while (true) {
+    bool loading = false;
+    *ready_cnt = 0;
+    for (const auto& name : names) {
+      for (const auto& version : manager->GetVersionStates(name)) {
+        if (version.second == ni::ModelReadyState::MODEL_LOADING) {
+          loading = true;
+        } else if (version.second == ni::ModelReadyState::MODEL_READY) {
+          (*ready_cnt)++;
+        }
+      }
+    }
+
+    if (!loading) {
+      break;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  *load_ns = NowNs() - start_ns;
+
+  RETURN_IF_ERROR(manager->UnloadAllModels());
+  while (!manager->GetLiveBackendStates().empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  return Status::Success;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <template-model-dir> [model-count] [max-load-threads]"
+              << std::endl;
+    return 1;
+  }
+
+  char resolved[PATH_MAX];
+  if (realpath(argv[1], resolved) == nullptr) {
+    std::cerr << "failed to resolve " << argv[1] << std::endl;
+    return 1;
+  }
+  const std::string template_path(resolved);
+
+  size_t model_cnt = 64;
+  uint32_t max_thread_cnt = 16;
+  if (argc > 2) {
+    model_cnt = strtoull(argv[2], nullptr, 10);
+  }
+  if (argc > 3) {
+    max_thread_cnt = strtoul(argv[3], nullptr, 10);
+  }
+
+  // Keep the per-model load messages out of the results.
+  LOG_ENABLE_INFO(false);
+  LOG_ENABLE_WARNING(false);
+
+  char repository_template[] = "/tmp/model_load_perf.XXXXXX";
+  if (mkdtemp(repository_template) == nullptr) {
+    std::cerr << "failed to create temporary repository" << std::endl;
+    return 1;
+  }
+  const std::string repository_path(repository_template);
+
+  std::vector<std::string> names;
+  Status status =
+      CreateRepository(template_path, repository_path, model_cnt, &names);
+
+  std::cout << "Models: " << model_cnt << ", repository: " << repository_path
+            << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(14) << "load ms"
+            << std::setw(10) << "ready" << std::setw(10) << "speedup"
+            << std::endl;
+
+  uint64_t single_thread_ns = 0;
+  for (uint32_t thread_cnt = 1; status.IsOk() && (thread_cnt <= max_thread_cnt);
+       thread_cnt *= 2) {
+    uint64_t load_ns = 0;
+    size_t ready_cnt = 0;
+    status = LoadRepository(
+        repository_path, names, thread_cnt, &load_ns, &ready_cnt);
+    if (!status.IsOk()) {
+      break;
+    }
+
+    if (thread_cnt == 1) {
+      single_thread_ns = load_ns;
+    }
+
+    std::cout << std::setw(10) << thread_cnt << std::setw(14) << std::fixed
+              << std::setprecision(1) << (load_ns / 1000000.0)
+              << std::setw(10) << ready_cnt;
+    PrintSpeedup(std::cout, (double)single_thread_ns / (double)load_ns);
+  }
+
+  // The copies only hold configurations and symlinks so removing the
+  // repository leaves the template model untouched.
+  const std::string remove_cmd = "rm -rf " + repository_path;
+  if (system(remove_cmd.c_str()) != 0) {
+    std::cerr << "failed to remove " << repository_path << std::endl;
+  }
+
+  if (!status.IsOk()) {
+    std::cerr << status.AsString() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
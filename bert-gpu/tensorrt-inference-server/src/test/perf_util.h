@@ -0,0 +1,98 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Helpers shared by the *_perf microbenchmarks.
+
+namespace nvidia { namespace inferenceserver { namespace test {
+
+// Return the current CLOCK_MONOTONIC time in nanoseconds.
+inline uint64_t
+NowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Return the average nanoseconds taken by 'fn' over 'iterations'
+// calls.
+template <typename F>
+double
+AverageNs(const size_t iterations, F fn)
+{
+  const uint64_t start_ns = NowNs();
+  for (size_t i = 0; i < iterations; ++i) {
+    fn();
+  }
+  const uint64_t end_ns = NowNs();
+  return (double)(end_ns - start_ns) / (double)iterations;
+}
+
+// Call 'fn(t)' on 'thread_cnt' threads, t = 0 .. thread_cnt - 1. The
+// threads are all created before any of them calls 'fn' so that
+// thread creation is not measured. Return the nanoseconds from the
+// start of the calls until all of them return.
+template <typename F>
+uint64_t
+RunThreads(const size_t thread_cnt, F fn)
+{
+  std::atomic<bool> start(false);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_cnt; ++t) {
+    threads.emplace_back([&start, &fn, t]() {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      fn(t);
+    });
+  }
+
+  const uint64_t start_ns = NowNs();
+  start.store(true);
+  for (auto& thd : threads) {
+    thd.join();
+  }
+  return NowNs() - start_ns;
+}
+
+// Write 'speedup' as the last column of a result table row.
+inline void
+PrintSpeedup(std::ostream& out, const double speedup)
+{
+  out << std::setw(9) << std::fixed << std::setprecision(2) << speedup << "x"
+      << std::endl;
+}
+
+}}}  // namespace nvidia::inferenceserver::test
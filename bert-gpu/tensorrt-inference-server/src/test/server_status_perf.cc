@@ -0,0 +1,173 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmark measuring the throughput of inference statistics
+// updates in ServerStatusManager as the number of updating threads
+// grows. For comparison it also measures a single mutex protecting a
+// ServerStatus protobuf, which is how statistics were recorded
+// previously. Each thread updates the statistics of the same model,
+// which is the worst case for contention.
+//
+// Usage: server_status_perf [updates-per-run]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "src/core/server_status.h"
+#include "src/core/server_status.pb.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::PrintSpeedup;
+using nvidia::inferenceserver::test::RunThreads;
+
+const std::string kModelName("bert");
+
+// Previous implementation: every update takes one mutex and modifies
+// the ServerStatus protobuf.
+class GlobalLockStats {
+ public:
+  GlobalLockStats()
+  {
+    (*status_.mutable_model_status())[kModelName].mutable_config()->set_name(
+        kModelName);
+  }
+
+  void UpdateSuccessInferStats(
+      const std::string& model_name, const int64_t model_version,
+      size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
+      uint64_t queue_duration_ns, uint64_t compute_duration_ns)
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto itr = status_.mutable_model_status()->find(model_name);
+    if (itr == status_.model_status().end()) {
+      return;
+    }
+
+    ni::ModelVersionStatus& version_status =
+        (*itr->second.mutable_version_status())[model_version];
+    version_status.set_model_inference_count(
+        version_status.model_inference_count() + batch_size);
+    version_status.set_model_execution_count(
+        version_status.model_execution_count() + execution_cnt);
+
+    ni::InferRequestStats& stats =
+        (*version_status.mutable_infer_stats())[batch_size];
+    stats.mutable_success()->set_count(stats.success().count() + 1);
+    stats.mutable_success()->set_total_time_ns(
+        stats.success().total_time_ns() + request_duration_ns);
+    stats.mutable_compute()->set_count(stats.compute().count() + 1);
+    stats.mutable_compute()->set_total_time_ns(
+        stats.compute().total_time_ns() + compute_duration_ns);
+    stats.mutable_queue()->set_count(stats.queue().count() + 1);
+    stats.mutable_queue()->set_total_time_ns(
+        stats.queue().total_time_ns() + queue_duration_ns);
+  }
+
+ private:
+  std::mutex mu_;
+  ni::ServerStatus status_;
+};
+
+// Current implementation.
+class ShardedStats {
+ public:
+  ShardedStats() : manager_("bench")
+  {
+    ni::ModelConfig config;
+    config.set_name(kModelName);
+    manager_.InitForModel(kModelName, config);
+  }
+
+  void UpdateSuccessInferStats(
+      const std::string& model_name, const int64_t model_version,
+      size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
+      uint64_t queue_duration_ns, uint64_t compute_duration_ns)
+  {
+    manager_.UpdateSuccessInferStats(
+        model_name, model_version, batch_size, execution_cnt,
+        request_duration_ns, queue_duration_ns, compute_duration_ns);
+  }
+
+ private:
+  ni::ServerStatusManager manager_;
+};
+
+// Return the number of updates per second performed by 'thread_cnt'
+// threads.
+template <typename S>
+double
+Run(const size_t thread_cnt, const size_t update_cnt)
+{
+  S stats;
+  const size_t per_thread = update_cnt / thread_cnt;
+  const uint64_t run_ns =
+      RunThreads(thread_cnt, [&stats, per_thread](size_t t) {
+        for (size_t i = 0; i < per_thread; ++i) {
+          stats.UpdateSuccessInferStats(
+              kModelName, 1, 1 + ((t + i) % 8), 1, 1000, 100, 800);
+        }
+      });
+
+  return (double)(per_thread * thread_cnt) * 1e9 / (double)run_ns;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t update_cnt = 1 << 22;
+  if (argc > 1) {
+    update_cnt = strtoull(argv[1], nullptr, 10);
+  }
+
+  std::cout << "Updates per run: " << update_cnt << ", hardware threads: "
+            << std::thread::hardware_concurrency() << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(18) << "global-lock/s"
+            << std::setw(18) << "sharded/s" << std::setw(10) << "speedup"
+            << std::endl;
+
+  for (size_t thread_cnt = 1; thread_cnt <= 64; thread_cnt *= 2) {
+    const double global_rate = Run<GlobalLockStats>(thread_cnt, update_cnt);
+    const double sharded_rate = Run<ShardedStats>(thread_cnt, update_cnt);
+    std::cout << std::setw(10) << thread_cnt << std::setw(18)
+              << (uint64_t)global_rate << std::setw(18)
+              << (uint64_t)sharded_rate;
+    PrintSpeedup(std::cout, sharded_rate / global_rate);
+  }
+
+  return 0;
+}
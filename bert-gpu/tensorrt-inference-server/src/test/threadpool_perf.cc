@@ -0,0 +1,264 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark comparing the work-stealing nvrpc::ThreadPool against the
+// single-queue pool it replaced, which took one mutex for every
+// enqueue and dequeue and wrapped every task in a packaged_task and
+// future. Several producer threads submit tasks that each spin for
+// 'work' iterations, the way the GRPC executor threads hand
+// management requests to the pool, and the time until all tasks have
+// run is measured, in nanoseconds per task, for a range of task
+// sizes. The current pool is measured both through enqueue(), which
+// still returns a future, and through the fire-and-forget Submit().
+//
+// Usage: threadpool_perf [pool-threads] [producer-threads] [tasks]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "src/nvrpc/ThreadPool.h"
+#include "src/test/perf_util.h"
+
+namespace {
+
+using nvidia::inferenceserver::test::NowNs;
+using nvidia::inferenceserver::test::PrintSpeedup;
+
+// Previous pool: one task queue shared by all workers.
+class SharedQueuePool {
+ public:
+  explicit SharedQueuePool(size_t thread_cnt) : stop_(false)
+  {
+    for (size_t i = 0; i < thread_cnt; ++i) {
+      workers_.emplace_back([this]() {
+        for (;;) {
+          std::function<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+            if (stop_ && tasks_.empty()) {
+              return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+          }
+          task();
+        }
+      });
+    }
+  }
+
+  ~SharedQueuePool()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  template <class F>
+  std::future<void> enqueue(F&& f)
+  {
+    auto task = std::make_shared<std::packaged_task<void()>>(
+        std::bind(std::forward<F>(f)));
+    std::future<void> res = task->get_future();
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return res;
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_;
+};
+
+// Spin for 'work' iterations. The result is accumulated so the loop
+// is not optimized away.
+uint64_t
+Spin(const size_t work)
+{
+  uint64_t x = 0;
+  for (size_t i = 0; i < work; ++i) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+  }
+  return x;
+}
+
+struct RunState {
+  size_t task_cnt_;
+  std::atomic<size_t> done_;
+  std::atomic<uint64_t> sink_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+};
+
+// The task captures four words, like the lambdas that the GRPC
+// management RPCs hand to the pool.
+struct SpinTask {
+  void operator()() const
+  {
+    state_->sink_.fetch_add(Spin(work_) + id_, std::memory_order_relaxed);
+    if (state_->done_.fetch_add(1) + 1 == state_->task_cnt_) {
+      std::lock_guard<std::mutex> lock(state_->mu_);
+      state_->cv_.notify_one();
+    }
+  }
+
+  RunState* state_;
+  size_t work_;
+  uint64_t id_;
+  void* context_;
+};
+
+struct SharedQueueEnqueue {
+  void operator()(const SpinTask& task) { pool_->enqueue(task); }
+  SharedQueuePool* pool_;
+};
+
+struct ThreadPoolEnqueue {
+  void operator()(const SpinTask& task) { pool_->enqueue(task); }
+  nvrpc::ThreadPool* pool_;
+};
+
+struct ThreadPoolSubmit {
+  void operator()(const SpinTask& task) { pool_->Submit(task); }
+  nvrpc::ThreadPool* pool_;
+};
+
+// Submit 'task_cnt' tasks of 'work' iterations from 'producer_cnt'
+// threads using 'submit' and wait for all of them to complete.
+// Return the nanoseconds taken.
+template <typename Submitter>
+uint64_t
+Run(const size_t producer_cnt, const size_t task_cnt, const size_t work,
+    Submitter submit)
+{
+  RunState state;
+  state.task_cnt_ = task_cnt;
+  state.done_ = 0;
+  state.sink_ = 0;
+
+  const uint64_t start_ns = NowNs();
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_cnt; ++p) {
+    producers.emplace_back([&, p]() {
+      Submitter producer_submit = submit;
+      for (size_t i = p; i < task_cnt; i += producer_cnt) {
+        producer_submit(SpinTask{&state, work, i, nullptr});
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  {
+    std::unique_lock<std::mutex> lock(state.mu_);
+    state.cv_.wait(
+        lock, [&state]() { return state.done_ == state.task_cnt_; });
+  }
+
+  return NowNs() - start_ns;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t thread_cnt = std::max(1U, std::thread::hardware_concurrency() / 2);
+  size_t producer_cnt = 4;
+  size_t task_cnt = 200000;
+  if (argc > 1) {
+    thread_cnt = std::max(1ULL, strtoull(argv[1], nullptr, 10));
+  }
+  if (argc > 2) {
+    producer_cnt = std::max(1ULL, strtoull(argv[2], nullptr, 10));
+  }
+  if (argc > 3) {
+    task_cnt = std::max(1ULL, strtoull(argv[3], nullptr, 10));
+  }
+
+  std::cout << "Pool threads: " << thread_cnt
+            << ", producer threads: " << producer_cnt
+            << ", tasks: " << task_cnt << std::endl;
+  std::cout << std::setw(10) << "work" << std::setw(14) << "shared ns"
+            << std::setw(14) << "enqueue ns" << std::setw(14) << "submit ns"
+            << std::setw(10) << "speedup" << std::endl;
+
+  for (const size_t work : {0, 100, 1000, 10000}) {
+    // Fewer tasks for the larger task sizes keep the runs short.
+    const size_t cnt =
+        std::max<size_t>(1, task_cnt / std::max<size_t>(1, work / 100));
+
+    uint64_t shared_ns = 0;
+    {
+      SharedQueuePool pool(thread_cnt);
+      shared_ns = Run(producer_cnt, cnt, work, SharedQueueEnqueue{&pool});
+    }
+
+    uint64_t enqueue_ns = 0;
+    {
+      nvrpc::ThreadPool pool(thread_cnt);
+      enqueue_ns = Run(producer_cnt, cnt, work, ThreadPoolEnqueue{&pool});
+    }
+
+    uint64_t submit_ns = 0;
+    {
+      nvrpc::ThreadPool pool(thread_cnt);
+      submit_ns = Run(producer_cnt, cnt, work, ThreadPoolSubmit{&pool});
+    }
+
+    std::cout << std::setw(10) << work << std::setw(14) << (shared_ns / cnt)
+              << std::setw(14) << (enqueue_ns / cnt) << std::setw(14)
+              << (submit_ns / cnt);
+    PrintSpeedup(std::cout, (double)shared_ns / (double)submit_ns);
+  }
+
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmark measuring the time to find the top classes of each
+// batch entry of a classification output, for every data type that
+// supports class results. For comparison it also measures a full sort
+// of the indices of each batch entry, which is how the top classes
+// were found previously. The results of both are checked to be the
+// same.
+//
+// Usage: top_k_perf [elements-per-batch-entry] [batch-size]
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "src/core/top_k.h"
+#include "src/test/perf_util.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+using nvidia::inferenceserver::test::AverageNs;
+using nvidia::inferenceserver::test::PrintSpeedup;
+
+// Consumes the results so that the measured work is not optimized
+// away.
+volatile size_t result_sink = 0;
+
+// Previous implementation.
+template <typename T>
+void
+SortTopK(const T* values, const size_t cnt, std::vector<size_t>* idx)
+{
+  idx->resize(cnt);
+  std::iota(idx->begin(), idx->end(), 0);
+  std::sort(idx->begin(), idx->end(), [values](size_t i1, size_t i2) {
+    return values[i1] > values[i2];
+  });
+}
+
+// Fill 'values' with random values, most of which are small as in a
+// probability distribution.
+template <typename T>
+void
+InitValues(std::vector<T>* values)
+{
+  std::mt19937 gen(1);
+  std::exponential_distribution<double> dist(1.0);
+  const double scale = std::is_integral<T>::value
+                           ? (double)std::numeric_limits<T>::max() / 16
+                           : 1.0;
+  for (auto& v : *values) {
+    v = static_cast<T>(std::min(dist(gen), 15.0) * scale);
+  }
+}
+
+// Measure both implementations for 'k' classes. Return false if their
+// results differ.
+template <typename T>
+bool
+Measure(
+    const std::string& type_name, const std::vector<T>& values,
+    const size_t entry_cnt, const size_t batch_size, const size_t k)
+{
+  std::vector<size_t> sort_idx, topk_idx;
+  const size_t class_cnt = std::min(k, entry_cnt);
+
+  for (size_t b = 0; b < batch_size; ++b) {
+    const T* probs = values.data() + b * entry_cnt;
+    SortTopK(probs, entry_cnt, &sort_idx);
+    ni::TopK(probs, entry_cnt, k, &topk_idx);
+    // Equal values may be ordered differently by the full sort so only
+    // the values are compared.
+    for (size_t c = 0; c < class_cnt; ++c) {
+      if (probs[sort_idx[c]] != probs[topk_idx[c]]) {
+        std::cerr << "error: " << type_name << " k=" << k << " entry " << b
+                  << " class " << c << " differs" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  const size_t iterations = 5;
+  size_t sink = 0;
+
+  const double sort_ns = AverageNs(iterations, [&]() {
+    for (size_t b = 0; b < batch_size; ++b) {
+      SortTopK(values.data() + b * entry_cnt, entry_cnt, &sort_idx);
+      sink += sort_idx[0];
+    }
+  });
+
+  const double topk_ns = AverageNs(iterations, [&]() {
+    for (size_t b = 0; b < batch_size; ++b) {
+      ni::TopK(values.data() + b * entry_cnt, entry_cnt, k, &topk_idx);
+      sink += topk_idx[0];
+    }
+  });
+
+  std::cout << std::setw(10) << type_name << std::setw(6) << k
+            << std::setw(14) << (uint64_t)(sort_ns / 1000.0) << std::setw(14)
+            << (uint64_t)(topk_ns / 1000.0);
+  PrintSpeedup(std::cout, sort_ns / topk_ns);
+
+  result_sink += sink;
+  return true;
+}
+
+template <typename T>
+bool
+MeasureType(
+    const std::string& type_name, const size_t entry_cnt,
+    const size_t batch_size)
+{
+  std::vector<T> values(entry_cnt * batch_size);
+  InitValues(&values);
+
+  for (const size_t k : {1, 5, 32, 100}) {
+    if (!Measure(type_name, values, entry_cnt, batch_size, k)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  // Default to the vocabulary size of BERT.
+  size_t entry_cnt = 30522;
+  size_t batch_size = 16;
+  if (argc > 1) {
+    entry_cnt = strtoull(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    batch_size = strtoull(argv[2], nullptr, 10);
+  }
+
+  std::cout << "Elements per batch entry: " << entry_cnt
+            << ", batch size: " << batch_size << std::endl;
+  std::cout << std::setw(10) << "type" << std::setw(6) << "k" << std::setw(14)
+            << "sort us" << std::setw(14) << "top-k us" << std::setw(10)
+            << "speedup" << std::endl;
+
+  const bool ok = MeasureType<uint8_t>("UINT8", entry_cnt, batch_size) &&
+                  MeasureType<uint16_t>("UINT16", entry_cnt, batch_size) &&
+                  MeasureType<uint32_t>("UINT32", entry_cnt, batch_size) &&
+                  MeasureType<uint64_t>("UINT64", entry_cnt, batch_size) &&
+                  MeasureType<int8_t>("INT8", entry_cnt, batch_size) &&
+                  MeasureType<int16_t>("INT16", entry_cnt, batch_size) &&
+                  MeasureType<int32_t>("INT32", entry_cnt, batch_size) &&
+                  MeasureType<int64_t>("INT64", entry_cnt, batch_size) &&
+                  MeasureType<float>("FP32", entry_cnt, batch_size) &&
+                  MeasureType<double>("FP64", entry_cnt, batch_size);
+
+  return ok ? 0 : 1;
+}